@@ -0,0 +1,3 @@
+#include "AbstractDiagnosticSink.h"
+
+AbstractDiagnosticSink::~AbstractDiagnosticSink() {}
@@ -0,0 +1,20 @@
+#ifndef PCSC_PROJECT_ABSTRACTDIAGNOSTICSINK_H
+#define PCSC_PROJECT_ABSTRACTDIAGNOSTICSINK_H
+
+#include <string>
+
+/** Abstract class receiving the problems detected by a solver, e.g. a negative step size, together with the action
+ * taken by the solver, e.g. "The step size is set to |h| = 0.1". <br>
+ * Each solver reports to its own sink (see AbstractOdeSolver::SetDiagnosticSink), so that solvers running at the same
+ * time on several threads do not share any state. A sink given to several solvers must be thread safe.
+ */
+class AbstractDiagnosticSink {
+public:
+    virtual ~AbstractDiagnosticSink();
+    /** Virtual function, overriden in the daughter classes, receiving the tag and the problem of an exception and the
+     * action taken by the solver, which may be empty.*/
+    virtual void Report(const std::string &tag, const std::string &problem, const std::string &action) = 0;
+};
+
+
+#endif //PCSC_PROJECT_ABSTRACTDIAGNOSTICSINK_H
@@ -4,7 +4,6 @@
 
 #include "AbstractExplicitSolver.h"
 #include "OutOfRangeException.h"
-#include <iostream>
 
 AbstractExplicitSolver::AbstractExplicitSolver(const double h, const double t0, const double t1, const double y0,
                                                double (*f)(double, double), const unsigned int s) :
@@ -31,8 +30,7 @@ double AbstractExplicitSolver::GetB(unsigned int i, unsigned int j) const {
             throw OutOfRangeException("j must be smaller or equal to i.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set equal to i. " << std::endl;
+        Report(error, "j is set equal to i. ");
         j = i;
     }
     return AbstractOdeSolver::GetB(i, j);
@@ -3,14 +3,50 @@
 //
 
 #include "AbstractImplicitSolver.h"
+
+#include <cmath>
+#include <limits>
+
 AbstractImplicitSolver::AbstractImplicitSolver(const double h, const double t0, const double t1, const double y0,
-                                               double (*f)(double, double), double (*df)(double, double),const unsigned int s) :AbstractOdeSolver(h, t0, t1, y0, f, s){
+                                               double (*f)(double, double), double (*df)(double, double),const unsigned int s)
+    :AbstractOdeSolver(h, t0, t1, y0, f, s), df_rhs_context(0), dfContext(0), f_differential(nullptr),
+     g_algebraic(nullptr), algebraicGuess(0.), algebraicValue(0.){
     /**
     Constructor for an Implicit class instance. This constructor is used in the constructor of the daughter class AdamsMpultonSOlver.
     */
     SetdRightHandSide(df);
  }
-AbstractImplicitSolver::AbstractImplicitSolver() : AbstractOdeSolver(){}
+AbstractImplicitSolver::AbstractImplicitSolver() : AbstractOdeSolver(), df_rhs(0), df_rhs_context(0), dfContext(0),
+    f_differential(nullptr), g_algebraic(nullptr), algebraicGuess(0.), algebraicValue(0.){}
+AbstractImplicitSolver::AbstractImplicitSolver(const AbstractImplicitSolver &other)
+    : AbstractOdeSolver(other), df_rhs(other.df_rhs), df_rhs_context(other.df_rhs_context),
+      dfContext(other.dfContext), f_differential(other.f_differential), g_algebraic(other.g_algebraic),
+      algebraicGuess(other.algebraicGuess), algebraicValue(other.algebraicValue) {
+    /**
+    Copy constructor: the reduced right hand side of a differential-algebraic equation and its derivative are bound
+     to the copy, which solves g from its own last value of z.
+    */
+    if (other.IsDifferentialAlgebraic()) {
+        BindAlgebraicEquation(other.f_differential, other.g_algebraic, other.dfContext == &other);
+    }
+}
+AbstractImplicitSolver &AbstractImplicitSolver::operator=(const AbstractImplicitSolver &other) {
+    /**
+    Copy assignment, which keeps the reduced right hand side bound to this instance.
+    */
+    AbstractOdeSolver::operator=(other);
+    df_rhs = other.df_rhs;
+    df_rhs_context = other.df_rhs_context;
+    dfContext = other.dfContext;
+    f_differential = other.f_differential;
+    g_algebraic = other.g_algebraic;
+    algebraicGuess = other.algebraicGuess;
+    algebraicValue = other.algebraicValue;
+    if (other.IsDifferentialAlgebraic()) {
+        BindAlgebraicEquation(other.f_differential, other.g_algebraic, other.dfContext == &other);
+    }
+    return *this;
+}
 AbstractImplicitSolver::~AbstractImplicitSolver() = default;
 
 void AbstractImplicitSolver::SetdRightHandSide(double (*f)(double y, double t)) {
@@ -22,6 +58,18 @@ void AbstractImplicitSolver::SetdRightHandSide(double (*f)(double y, double t))
      *
      */
     df_rhs = f;
+    df_rhs_context = 0;
+    dfContext = 0;
+}
+
+void AbstractImplicitSolver::SetdRightHandSide(double (*f)(double y, double t, void *context), void *context) {
+    /*!
+     * Set the derivative of f(y,t) with respect to y with an external function f called with a context
+     * \param f: function handle for df(y,t,context)
+     * \param context: pointer given to each call of f, which must live as long as the solver uses it
+     */
+    df_rhs_context = f;
+    dfContext = context;
 }
 
 double AbstractImplicitSolver::dRightHandSide(double y, double t) const {
@@ -32,5 +80,151 @@ double AbstractImplicitSolver::dRightHandSide(double y, double t) const {
      * \return evaluation of the derivative of f(y,t) with respect to y
      */
 
+    if (df_rhs_context != 0) {
+        return df_rhs_context(y, t, dfContext);
+    }
     return df_rhs(y, t);
-}
\ No newline at end of file
+}
+
+double AbstractImplicitSolver::Jacobian(const double y, const double t, const double f_y) const {
+    /*!
+     * Derivative of f with respect to y, with one evaluation of df or f
+     * \param y: numerical solution at a certain time t
+     * \param t: time in seconds
+     * \param f_y: evaluation of f(y,t)
+     * \return dRightHandSide(y,t) if df is set, a forward difference of f otherwise
+     */
+    if (HasdRightHandSide()) {
+        return dRightHandSide(y, t);
+    }
+    const double delta = std::sqrt(std::numeric_limits<double>::epsilon())*(1 + std::abs(y));
+    return (RightHandSide(y + delta, t) - f_y)/delta;
+}
+
+void AbstractImplicitSolver::SetAlgebraicEquation(double (*f)(double y, double z, double t),
+                                                  double (*g)(double y, double z, double t), const double z0) {
+    /*!
+     * Set the semi-explicit index-1 differential-algebraic equation y' = f(y,z,t), 0 = g(y,z,t). The right hand side
+     * and its derivative are replaced by those of y' = f(y, z(y,t), t), the derivative being computed from finite
+     * differences of f and g. Setting another right hand side with SetRightHandSide solves an ODE again.
+     * \param f: right hand side of the differential equation
+     * \param g: algebraic equation, whose derivative with respect to z must not vanish
+     * \param z0: guess of the algebraic variable at t0, made consistent with y0 at the beginning of each integration
+     */
+    BindAlgebraicEquation(f, g, true);
+    algebraicGuess = z0;
+    algebraicValue = z0;
+}
+
+void AbstractImplicitSolver::BindAlgebraicEquation(double (*f)(double y, double z, double t),
+                                                   double (*g)(double y, double z, double t),
+                                                   const bool reducedJacobian) {
+    /*!
+     * Bind the reduced right hand side, and its derivative unless it was replaced with SetdRightHandSide, to this
+     * instance.
+     * \param f: right hand side of the differential equation
+     * \param g: algebraic equation
+     * \param reducedJacobian: whether the derivative is the one of the reduced right hand side
+     */
+    // setting the right hand side leaves the previous differential-algebraic equation
+    SetRightHandSide(ReducedRightHandSide, this);
+    f_differential = f;
+    g_algebraic = g;
+    if (reducedJacobian) {
+        SetdRightHandSide(ReducedJacobian, this);
+    }
+}
+
+void AbstractImplicitSolver::RightHandSideChanged() {
+    /*!
+     * Leave the differential-algebraic equation: the new right hand side is the one of an ODE. The derivative of the
+     * reduced right hand side is removed as well, so that the Jacobian is a finite difference of the new right hand
+     * side unless dRightHandSide is set again.
+     */
+    f_differential = nullptr;
+    g_algebraic = nullptr;
+    if (df_rhs_context == ReducedJacobian) {
+        SetdRightHandSide(nullptr);
+    }
+}
+
+double AbstractImplicitSolver::AlgebraicValue(const double y, const double t) const {
+    /*!
+     * Solution z of g(y,z,t) = 0 computed with the Newton method from the last value of z, dg/dz being a forward
+     * difference of g. If the Newton method does not converge, the failure is counted in the result as an evaluation
+     * at which the algebraic equation could not be solved.
+     * \param y: value of the differential variable
+     * \param t: time in seconds
+     * \return the algebraic variable z(y,t)
+     */
+    double z = algebraicValue;
+    bool converged = false;
+    for (int iteration = 0; iteration < 50 && !converged; iteration++) {
+        const double g_z = g_algebraic(y, z, t);
+        const double delta = std::sqrt(std::numeric_limits<double>::epsilon())*(1 + std::abs(z));
+        const double correction = g_z*delta/(g_algebraic(y, z + delta, t) - g_z);
+        z -= correction;
+        converged = std::abs(correction) <= 1e-12*(1 + std::abs(z));
+    }
+    if (converged) {
+        algebraicValue = z;
+    } else {
+        // reported once at the end of the integration
+        ++result.algebraicFailures;
+    }
+    return z;
+}
+
+double AbstractImplicitSolver::ConsistentInitialization() {
+    /*!
+     * Solve g(y0,z,t0) = 0 from the guess of z given with SetAlgebraicEquation, so that the integration starts from
+     * consistent values. Called at the beginning of each integration.
+     * \return the consistent initial value of the algebraic variable
+     */
+    algebraicValue = algebraicGuess;
+    return AlgebraicValue(GetInitialValue(), GetInitialTime());
+}
+
+void AbstractImplicitSolver::StartIntegration() {
+    /*!
+     * Make the algebraic variable of a differential-algebraic equation consistent with y0, so that successive
+     * integrations do not depend on each other.
+     */
+    if (IsDifferentialAlgebraic()) {
+        ConsistentInitialization();
+    }
+}
+
+double AbstractImplicitSolver::ReducedRightHandSide(const double y, const double t, void *context) {
+    /*! Right hand side of the base class for a differential-algebraic equation, so that the evaluations are counted as
+    * for an ODE
+    * \param y: value of the differential variable
+    * \param t: time
+    * \param context: the solver
+    * \return f(y, z(y,t), t)
+    */
+    const AbstractImplicitSolver &solver = *static_cast<const AbstractImplicitSolver *>(context);
+    return solver.f_differential(y, solver.AlgebraicValue(y, t), t);
+}
+
+double AbstractImplicitSolver::ReducedJacobian(const double y, const double t, void *context) {
+    /*! Derivative of the reduced right hand side, from the implicit function theorem, dz/dy = -g_y/g_z, with forward
+    * differences of f and g
+    * \param y: value of the differential variable
+    * \param t: time
+    * \param context: the solver
+    * \return f_y - f_z g_y/g_z at (y, z(y,t), t)
+    */
+    const AbstractImplicitSolver &solver = *static_cast<const AbstractImplicitSolver *>(context);
+    const double z = solver.AlgebraicValue(y, t);
+    const double root = std::sqrt(std::numeric_limits<double>::epsilon());
+    const double delta_y = root*(1 + std::abs(y));
+    const double delta_z = root*(1 + std::abs(z));
+    const double f = solver.f_differential(y, z, t);
+    const double g = solver.g_algebraic(y, z, t);
+    const double f_y = (solver.f_differential(y + delta_y, z, t) - f)/delta_y;
+    const double f_z = (solver.f_differential(y, z + delta_z, t) - f)/delta_z;
+    const double g_y = (solver.g_algebraic(y + delta_y, z, t) - g)/delta_y;
+    const double g_z = (solver.g_algebraic(y, z + delta_z, t) - g)/delta_z;
+    return f_y - f_z*g_y/g_z;
+}
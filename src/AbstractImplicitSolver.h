@@ -8,20 +8,60 @@
 #include "AbstractOdeSolver.hpp"
 
 /** Abstract class, daughter of AbstractOdeSolver, and mother class of the classes
- * which implement implicit methods to solve ODE.
+ * which implement implicit methods to solve ODE. <br>
+ * The implicit solvers also solve the semi-explicit index-1 differential-algebraic equation
+ * \f$ y' = f(y,z,t), \quad 0 = g(y,z,t), \quad y(t_0) = y_0 \f$,
+ * i.e. \f$ M Y' = F(Y,t) \f$ for Y = (y, z) with the singular mass matrix M = diag(1, 0), given with
+ * SetAlgebraicEquation. The algebraic variable z is eliminated: the right hand side of the solver becomes
+ * \f$ f(y, z(y,t), t) \f$, where \f$ z(y,t) \f$ solves \f$ g(y,z,t) = 0 \f$ with the Newton method, started
+ * from the last value of z. As \f$ \partial g/\partial z \neq 0 \f$ (index 1), z is a smooth function of y and t,
+ * and the order of the methods is kept without an artificial time constant. Its initial value is made consistent
+ * with y0 at the beginning of each integration, from a guess which need not satisfy g = 0.
  */
 class AbstractImplicitSolver : public AbstractOdeSolver{
 public:
     AbstractImplicitSolver();
     AbstractImplicitSolver(const double h, const double t0, const double t1, const double y0,
                            double (*f)(double y, double t),double (*df)(double y, double t),const unsigned int s);
+    AbstractImplicitSolver(const AbstractImplicitSolver &other);
+    AbstractImplicitSolver &operator=(const AbstractImplicitSolver &other);
     virtual ~AbstractImplicitSolver();
 
     void SetdRightHandSide(double (*f)(double y, double t));
+    void SetdRightHandSide(double (*f)(double y, double t, void *context), void *context);
     double dRightHandSide(double y, double t) const;
+    /** Whether the derivative of f with respect to y was set.*/
+    bool HasdRightHandSide() const { return df_rhs != 0 || df_rhs_context != 0; }
+    double Jacobian(double y, double t, double f_y) const;
+
+    void SetAlgebraicEquation(double (*f)(double y, double z, double t), double (*g)(double y, double z, double t),
+                              double z0);
+    /** Whether the problem is a differential-algebraic equation set with SetAlgebraicEquation.*/
+    bool IsDifferentialAlgebraic() const { return g_algebraic != nullptr; }
+    double AlgebraicValue(double y, double t) const;
+    double ConsistentInitialization();
+
+protected:
+    /** The implicit solvers use df, which is also the Jacobian of their Newton method.*/
+    double SensitivityJacobian(double y, double t) const override { return dRightHandSide(y, t); }
+    bool SupportsSensitivity(const ForwardSensitivity &) const override { return true; }
+    void StartIntegration() override;
+    void RightHandSideChanged() override;
 
 private:
     double (*df_rhs)(double y, double t);
+    double (*df_rhs_context)(double y, double t, void *context);
+    void *dfContext;
+    // differential-algebraic equation: f(y,z,t), g(y,z,t), the guess of z at t0 and the last value of z, from which
+    // the Newton method of the next evaluation starts
+    double (*f_differential)(double y, double z, double t);
+    double (*g_algebraic)(double y, double z, double t);
+    double algebraicGuess;
+    mutable double algebraicValue;
+    void BindAlgebraicEquation(double (*f)(double y, double z, double t), double (*g)(double y, double z, double t),
+                               bool reducedJacobian);
+    static double ReducedRightHandSide(double y, double t, void *context);
+    static double ReducedJacobian(double y, double t, void *context);
 };
 
 
@@ -2,13 +2,18 @@
 #include "OutOfRangeException.h"
 #include "UncoherentValueException.h"
 #include "SetOrderException.h"
-#include <iostream>
+#include "StreamOutputSink.h"
+#include "ConsoleDiagnosticSink.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 AbstractOdeSolver::AbstractOdeSolver()
     /**
     * Constructor of the class, assigning the variables of the class to default values.
     */
-    : stepSize(1e-3), initialTime(0.), finalTime(100.), initialValue(0.), f_rhs(0), s(0) {}
+    : stepSize(1e-3), initialTime(0.), finalTime(100.), initialValue(0.), f_rhs(0), f_rhs_context(0), rhsContext(0),
+      diagnostics(&ConsoleDiagnosticSink::Instance()), s(0), sensitivity(nullptr) {}
 
 AbstractOdeSolver::~AbstractOdeSolver() {}
 
@@ -22,8 +27,7 @@ void AbstractOdeSolver::SetStepSize(double h) {
             throw UncoherentValueException("The step size must be positive.");
         }
     } catch (UncoherentValueException &error) {
-        error.PrintDebug();
-        std::cout << "The step size is set to |h| = " << -h << std::endl;
+        Report(error, "The step size is set to |h| = ", -h);
         h = -h;
     }
     try {
@@ -31,8 +35,7 @@ void AbstractOdeSolver::SetStepSize(double h) {
             throw UncoherentValueException("The step size is too small.");
         }
     } catch (UncoherentValueException &error) {
-        error.PrintDebug();
-        std::cout << "The step size is set to 1e-5" << std::endl;
+        Report(error, "The step size is set to 1e-5");
         h = 1e-5;
     }
     stepSize = h;
@@ -49,8 +52,7 @@ void AbstractOdeSolver::SetTimeInterval(double t0, double t1) {
             throw UncoherentValueException("Final time cannot be negative");
         }
     } catch (UncoherentValueException &error) {
-        error.PrintDebug();
-        std::cout << "Final time is set positive |t1| = " << -t1 << std::endl;
+        Report(error, "Final time is set positive |t1| = ", -t1);
         t1 = -t1;
     }
     try {
@@ -58,8 +60,7 @@ void AbstractOdeSolver::SetTimeInterval(double t0, double t1) {
             throw UncoherentValueException("Initial time cannot be negative");
         }
     } catch (UncoherentValueException &error) {
-        error.PrintDebug();
-        std::cout << "Initial time is set positive |t0| = " << -t0 << std::endl;
+        Report(error, "Initial time is set positive |t0| = ", -t0);
         t0 = -t0;
     }
     try {
@@ -67,8 +68,7 @@ void AbstractOdeSolver::SetTimeInterval(double t0, double t1) {
             throw UncoherentValueException("Final time cannot be smaller than initial time.");
         }
     } catch (UncoherentValueException &error) {
-        error.PrintDebug();
-        std::cout << "t1 and t0 are switched." << std::endl;
+        Report(error, "t1 and t0 are switched.");
         double temp(t0);
         t0 = t1;
         t1 = temp;
@@ -93,6 +93,47 @@ void AbstractOdeSolver::SetRightHandSide(double (*f)(double y, double t)) {
    *
    */
    f_rhs = f;
+   f_rhs_context = 0;
+   rhsContext = 0;
+   RightHandSideChanged();
+}
+
+void AbstractOdeSolver::SetRightHandSide(double (*f)(double y, double t, void *context), void *context) {
+   /*!
+   * Set f(y,t) with an external function f called with a context, e.g. a pointer to the parameters of the problem.
+   * The context is not copied: it must live as long as the solver uses it.
+   * \param f: function handle for f(y,t,context)
+   * \param context: pointer given to each call of f
+   */
+   f_rhs_context = f;
+   rhsContext = context;
+   RightHandSideChanged();
+}
+
+void AbstractOdeSolver::SetDiagnosticSink(AbstractDiagnosticSink *sink) {
+   /*!
+   * Set the sink receiving the problems detected by the solver
+   * \param sink: diagnostic sink, which must live as long as the solver. nullptr restores the console.
+   */
+   diagnostics = sink != nullptr ? sink : &ConsoleDiagnosticSink::Instance();
+}
+
+void AbstractOdeSolver::SetSensitivity(ForwardSensitivity *sensitivity) {
+   /*!
+   * Set the sensitivities computed with the solution by SolveEquation. They are only computed by the Runge-Kutta
+   * and Adams solvers, and the explicit solvers need the Jacobian df/dy.
+   * \param sensitivity: sensitivities, which must live as long as the solver. nullptr to stop computing them.
+   */
+    try {
+        if (sensitivity != nullptr && !SupportsSensitivity(*sensitivity)) {
+            throw UncoherentValueException("The sensitivities cannot be computed by this solver, or the Jacobian "
+                                           "df/dy is missing.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The sensitivities are not computed.");
+        sensitivity = nullptr;
+    }
+    this->sensitivity = sensitivity;
 }
 
 void AbstractOdeSolver::SetOrder(unsigned int order) {
@@ -104,24 +145,83 @@ void AbstractOdeSolver::SetOrder(unsigned int order) {
             throw SetOrderException("Order must be smaller or equal to the maximum order " + std::to_string(max_order));
         }
     } catch (SetOrderException &error) {
-        error.PrintDebug();
-        std::cout << "The order is set to the maximum order " + std::to_string(max_order) << std::endl;
+        Report(error, "The order is set to the maximum order " + std::to_string(max_order));
         order = max_order;
     }
     s = order;
 }
 
+SolverResult AbstractOdeSolver::SolveEquation(AbstractOutputSink &sink) {
+    /*! Compute the numerical solution of the ODE and pass the record (t, y) of each time step to the sink.
+    * The problems detected during the integration are reported once to the diagnostic sink.
+    * \param sink: sink receiving the numerical solution at each time t
+    * \return The status of the integration and its counters
+    */
+    result = SolverResult();
+    StartIntegration();
+    Solve(sink);
+    if (result.nonFiniteValues > 0) {
+        result.status = SolverStatus::NonFinite;
+        Report(UncoherentValueException("The solution is not finite."), result.nonFiniteValues,
+               " value(s) are infinite or NaN, the first one at t = ", result.firstNonFiniteTime);
+    } else if (result.newtonFailures > 0 && result.status == SolverStatus::Success) {
+        result.status = SolverStatus::NewtonNotConverged;
+        Report(Exception("MAX_IT", "Max number of iterations reached without convergence"),
+               "The Newton method did not converge at ", result.newtonFailures, " step(s).");
+    } else if (result.algebraicFailures > 0 && result.status == SolverStatus::Success) {
+        result.status = SolverStatus::NewtonNotConverged;
+        Report(Exception("MAX_IT", "Max number of iterations reached without convergence"),
+               "The algebraic equation could not be solved at ", result.algebraicFailures, " evaluation(s).");
+    } else if (result.status == SolverStatus::StepSizeTooSmall) {
+        Report(UncoherentValueException("The step size became too small, the integration is stopped."));
+    }
+    return result;
+}
+
+SolverResult AbstractOdeSolver::SolveEquation(std::ostream &stream) {
+    /*! Compute the numerical solution of the ODE and write it as lines "t y" on the stream
+    * \param stream: stream on which write the numerical solution at each time t
+    * \return The status of the integration and its counters
+    */
+    StreamOutputSink sink(stream);
+    return SolveEquation(sink);
+}
+
+Trajectory AbstractOdeSolver::SolveEquation() {
+    /*! Compute the numerical solution of the ODE and keep it in memory. The status is given by GetResult.
+    * \return The times and the values of the numerical solution
+    */
+    Trajectory trajectory;
+    SolveEquation(trajectory);
+    return trajectory;
+}
+
 double AbstractOdeSolver::RightHandSide(double y, double t) const {
   /*!
   * \param t: time in seconds
   * \param y: numerical solution at a certain time t
+  * \return The evaluation of f_rhs(y,t), counted in the result of the solver
+  */
+  ++result.rhsEvaluations;
+  return EvaluateRightHandSide(y, t);
+}
+
+double AbstractOdeSolver::EvaluateRightHandSide(double y, double t) const {
+  /*! Evaluation of the right hand side which is not counted, and can therefore be called by several threads at the
+  * same time. The caller adds the number of evaluations to the result.
+  * \param t: time in seconds
+  * \param y: numerical solution at a certain time t
   * \return The evaluation of f_rhs(y,t)
   */
+  if (f_rhs_context != 0) {
+      return f_rhs_context(y, t, rhsContext);
+  }
   return f_rhs(y, t);
 }
 
 AbstractOdeSolver::AbstractOdeSolver(const double h, const double t0, const double t1, const double y0,
-                                     double (*f)(double, double), const unsigned int s) {
+                                     double (*f)(double, double), const unsigned int s)
+    : f_rhs_context(0), rhsContext(0), diagnostics(&ConsoleDiagnosticSink::Instance()), sensitivity(nullptr) {
         /**
      * Constructor assigning the variables of the class to specific values.
      */
@@ -132,6 +232,134 @@ AbstractOdeSolver::AbstractOdeSolver(const double h, const double t0, const doub
     SetOrder(s);
 }
 
+double AbstractOdeSolver::StartingValue(double y, double t, double h, unsigned int substeps, double *S) const {
+    /*! Compute the solution at time t+h with the classic fourth-order Runge-Kutta method. The multistep solvers use
+    * it for their first values: its local error is O(h^5), so that a fixed number of starting steps does not reduce
+    * their order up to 5. Higher orders need sub-steps, see StartingSubsteps.
+    * \param y: solution at time t
+    * \param t: time
+    * \param h: step size
+    * \param substeps: number of Runge-Kutta steps of size h/substeps, to keep stiff problems stable
+    * \param S: if not nullptr, sensitivities at time t, replaced by those at time t+h
+    * \return The solution at time t+h
+    */
+    const double dt = h/substeps;
+    const unsigned int m = S != nullptr ? sensitivity->Size() : 0;
+    double ks[4];
+    for (unsigned int i = 0; i < substeps; i++) {
+        const double k1 = RightHandSide(y, t);
+        const double k2 = RightHandSide(y + dt/2*k1, t + dt/2);
+        const double k3 = RightHandSide(y + dt/2*k2, t + dt/2);
+        const double k4 = RightHandSide(y + dt*k3, t + dt);
+        if (m > 0) {
+            // same stages for the sensitivity equations s' = df/dy(y,t) s + df/dp(y,t)
+            const double Y[4] = {y, y + dt/2*k1, y + dt/2*k2, y + dt*k3};
+            const double T[4] = {t, t + dt/2, t + dt/2, t + dt};
+            double J[4];
+            for (int l = 0; l < 4; l++) {
+                J[l] = SensitivityJacobian(Y[l], T[l]);
+            }
+            for (unsigned int k = 0; k < m; k++) {
+                ks[0] = J[0]*S[k] + sensitivity->Forcing(k, Y[0], T[0]);
+                ks[1] = J[1]*(S[k] + dt/2*ks[0]) + sensitivity->Forcing(k, Y[1], T[1]);
+                ks[2] = J[2]*(S[k] + dt/2*ks[1]) + sensitivity->Forcing(k, Y[2], T[2]);
+                ks[3] = J[3]*(S[k] + dt*ks[2]) + sensitivity->Forcing(k, Y[3], T[3]);
+                S[k] += dt/6*(ks[0] + 2*ks[1] + 2*ks[2] + ks[3]);
+            }
+        }
+        y += dt/6*(k1 + 2*k2 + 2*k3 + k4);
+        t = t + dt;
+    }
+    return y;
+}
+
+unsigned long AbstractOdeSolver::GetNumberOfSteps() const {
+    /*!
+    * \return The number of steps n of a fixed step size solver, which writes the n+1 records t0, t0+h, ..., t0+nh
+    */
+    return static_cast<unsigned long>(std::floor((finalTime - initialTime) / stepSize));
+}
+
+double AbstractOdeSolver::InitialStepSize(const double tolerance, const unsigned int order) const {
+    /*! Estimate the initial step size of an adaptive solver from f(y0,t0), as in Hairer, Norsett and Wanner
+    * (Solving ODE I, II.4): the step h0 = 0.01 |y0|/|f(y0,t0)| gives a first Euler step, from which the second
+    * derivative is estimated, and the step size is chosen so that the local error of the method is about the
+    * tolerance. Two evaluations of f are made.
+    * \param tolerance: tolerance on the local error, relative to 1 + |y|
+    * \param order: order p of the method, whose local error is proportional to h^(p+1)
+    * \return The initial step size, at most the length of the time interval
+    */
+    const double t0 = initialTime;
+    const double y0 = initialValue;
+    if (finalTime <= t0) {
+        return 0.;
+    }
+    const double scale = tolerance*(1 + std::abs(y0));
+    const double f0 = RightHandSide(y0, t0);
+    const double d0 = std::abs(y0)/scale;
+    const double d1 = std::abs(f0)/scale;
+    double h0 = 1e-6;
+    if (d0 >= 1e-5 && d1 >= 1e-5) {
+        h0 = 0.01*d0/d1;
+    }
+    h0 = std::min(h0, finalTime - t0);
+    // estimation of the second derivative with an explicit Euler step
+    const double f1 = RightHandSide(y0 + h0*f0, t0 + h0);
+    const double d2 = std::abs(f1 - f0)/scale/h0;
+    double h1;
+    if (std::max(d1, d2) <= 1e-15) {
+        h1 = std::max(1e-6, h0*1e-3);
+    } else {
+        h1 = std::pow(0.01/std::max(d1, d2), 1./(order + 1));
+    }
+    return std::min(std::min(100*h0, h1), finalTime - t0);
+}
+
+unsigned int AbstractOdeSolver::StartingSubsteps(const double y, const double t, const double h,
+                                                const unsigned int order, const unsigned int minimum,
+                                                const double *S) const {
+    /*! Number of sub-steps of StartingValue which keeps the error of the starting values of a multistep method of
+    * the given order below its own error. Up to order 5, the local error O(h^5) of one Runge-Kutta step is enough.
+    * Above, the number of sub-steps is doubled until the step doubling estimate of the local error,
+    * \f$ |y_{2m} - y_m|/15 \f$, reaches the round-off, so that it depends on the scale of the problem and not only
+    * on h. The evaluations of f of the estimate are counted in the result.
+    * \param y: solution at time t
+    * \param t: time
+    * \param h: step size of the multistep method
+    * \param order: order of the multistep method
+    * \param minimum: smallest number of sub-steps, e.g. to keep a stiff problem stable
+    * \param S: if not nullptr, sensitivities at time t, whose error is estimated as the one of y
+    * \return The number of sub-steps m, at most 1024 unless minimum is larger
+    */
+    if (order <= 5) {
+        return minimum;
+    }
+    const unsigned int m = S != nullptr ? sensitivity->Size() : 0;
+    // solution and sensitivities with m and 2m sub-steps
+    std::vector<double> values(m + 1);
+    std::vector<double> values_double(m + 1);
+    auto compute = [&](unsigned int substeps, std::vector<double> &v) {
+        std::copy(S, S + m, v.begin() + 1);
+        v[0] = StartingValue(y, t, h, substeps, m > 0 ? &v[1] : nullptr);
+    };
+    unsigned int substeps = minimum;
+    compute(substeps, values);
+    while (substeps < 1024) {
+        compute(2*substeps, values_double);
+        substeps *= 2;
+        bool converged = true;
+        for (unsigned int k = 0; k <= m; k++) {
+            const double estimate = std::abs(values_double[k] - values[k])/15;
+            converged = converged && estimate <= 1e-15*(1 + std::abs(values_double[k]));
+        }
+        if (converged) {
+            break;
+        }
+        values.swap(values_double);
+    }
+    return substeps;
+}
+
 double AbstractOdeSolver::GetB(unsigned int i, unsigned int j) const {
     /*!
     * \param i: row index
@@ -143,8 +371,7 @@ double AbstractOdeSolver::GetB(unsigned int i, unsigned int j) const {
             throw OutOfRangeException("Out of range index. i cannot be bigger than max_order");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "i is set to " << std::to_string(max_order) << "-1" << std::endl;
+        Report(error, "i is set to ", std::to_string(max_order), "-1");
         i = max_order-1;
     }
     try {
@@ -152,55 +379,8 @@ double AbstractOdeSolver::GetB(unsigned int i, unsigned int j) const {
             throw OutOfRangeException("Out of range index. i cannot be strictly bigger than max_order");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set to " << std::to_string(max_order) << std::endl;
+        Report(error, "j is set to ", std::to_string(max_order));
         j = max_order;
     }
     return b[i][j];
 }
-
-double AbstractOdeSolver::ScalarProduct(const int size, const double *a, const double *b) const {
-   /*! Implementation of the scalar product between vectors a and b
-   * \param size: length of a and b
-   * \param a: first vector
-   * \param b: second vector
-   * \return result of the scalar product between two vectors
-   */
-    double product(0.);
-    for(int i=0; i<size; i++){
-        product += a[i]*b[i];
-    }
-    return product;
-}
-
-double AbstractOdeSolver::ProductWithB(const double *F, int j) const {
-    /*! Implementation of the scalar product between vectors F and the jth row of B, i.e.
-    *  \f$ \sum_{i = 0}^{j-1} F[i]*b[j-1][i] \f$
-    * \param F: vector of size order+1 containing the evaluation of f(y,t) at different consecutive times
-    * \param j: parameter defining the length of F and b to consider
-    *\return result of the scalar product between F and the jth row of b
-    */
-    try {
-        if (j>max_order) {
-            throw OutOfRangeException("j must be smaller than max_order.");
-        }
-    } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set to " << std::to_string(max_order) << std::endl;
-        j = max_order;
-    }
-    try {
-        if (j<1) {
-            throw OutOfRangeException("j must be strictly positive.");
-        }
-    } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set 1. " << std::endl;
-        j = 1;
-    }
-    double product;
-    product = ScalarProduct(j, F, &b[j-1][0]);
-    return product;
-}
-
-
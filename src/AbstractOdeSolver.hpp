@@ -2,16 +2,34 @@
 #ifndef ABSTRACTODESOLVER_HPP_
 #define ABSTRACTODESOLVER_HPP_
 
+#include "AbstractOutputSink.h"
+#include "AbstractDiagnosticSink.h"
+#include "Exception.hpp"
+#include "ForwardSensitivity.h"
+#include "SolverResult.h"
+#include "Trajectory.h"
+#include <cassert>
+#include <cmath>
 #include <ostream>
+#include <sstream>
 
-//the maximum order of the solver is set to 5 in our case.
-const unsigned int max_order = 5;
+//the maximum order of the solvers, reached by the Adams methods whose coefficients are generated (AdamsCoefficients)
+const unsigned int max_order = 12;
 
 /** Abstract class, mother class of AbstractImplicitSolver and AbstractExplicitSolver. Contains all the variables and
 * functions common to the implicit and explicit approaches.
  * A solver find a solution \f$y\f$ at a final time \f$t_1\f$ of the initial value problem
      * \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0, \f$
      * given a step size \f$ h>0 \f$ and an order \f$ s \geq 0 \f$.
+ * The right hand side is either a function f(y,t), or a function f(y,t,context) called with a pointer given with it,
+ * e.g. to an object holding the parameters of the problem. A solver does not use any global state: several solvers
+ * can run at the same time on different threads, provided that their right hand sides and their contexts can. <br>
+ * The problems detected by a solver (e.g. a negative step size, which is corrected) are reported to its
+ * diagnostic sink, by default the console (see ConsoleDiagnosticSink). The parameters are checked when they are set,
+ * so that the time loops contain no check, no exception and no output: the problems detected while stepping are
+ * counted in the SolverResult returned by SolveEquation, and reported once at the end. <br>
+ * The Runge-Kutta and Adams solvers can also compute the sensitivities of the solution with respect to parameters,
+ * see SetSensitivity and ForwardSensitivity.
  * */
 
 class AbstractOdeSolver {
@@ -27,13 +45,30 @@ public:
   void SetTimeInterval(double t0, double t1);
   void SetInitialValue(double y0);
   void SetRightHandSide(double (*f)(double y, double t));
+  void SetRightHandSide(double (*f)(double y, double t, void *context), void *context);
+  void SetDiagnosticSink(AbstractDiagnosticSink *sink);
+  void SetSensitivity(ForwardSensitivity *sensitivity);
   virtual void SetOrder(unsigned int order);
 
   double RightHandSide(double y, double t) const;
-  double ScalarProduct(int size, const double* a, const double* b) const;
-  double ProductWithB(const double F[max_order+1], int j) const;
-  /** Virtual function, overriden in the daughter classes, computing the numerical solution of the ODE.*/
-  virtual void SolveEquation(std::ostream &stream) = 0;
+  /** Scalar product of the vectors a and b of length size.*/
+  double ScalarProduct(int size, const double* a, const double* b) const {
+      double product(0.);
+      for (int i = 0; i < size; i++) {
+          product += a[i]*b[i];
+      }
+      return product;
+  }
+  /** Scalar product of F with the jth row of b, \f$ \sum_{i = 0}^{j-1} F[i]*b[j-1][i] \f$, with
+   * \f$ 1 \leq j \leq \f$ max_order. Called at each step: j is not checked, the order being checked by SetOrder.*/
+  double ProductWithB(const double F[max_order+1], int j) const {
+      assert(j >= 1 && j <= static_cast<int>(max_order));
+      return ScalarProduct(j, F, &b[j-1][0]);
+  }
+  SolverResult SolveEquation(AbstractOutputSink &sink);
+  SolverResult SolveEquation(std::ostream &stream);
+  Trajectory SolveEquation();
+  const SolverResult &GetResult() const { return result; }
 
   // Get methods
   double GetFinalTime() const { return finalTime; }
@@ -46,6 +81,13 @@ public:
 
   unsigned int GetOrder() const { return s; }
 
+  unsigned long GetNumberOfSteps() const;
+  double InitialStepSize(double tolerance, unsigned int order) const;
+
+  AbstractDiagnosticSink *GetDiagnosticSink() const { return diagnostics; }
+
+  ForwardSensitivity *GetSensitivity() const { return sensitivity; }
+
   virtual double GetB(const unsigned int i, const unsigned int j) const;
 
 private:
@@ -54,10 +96,48 @@ private:
   double finalTime;
   double initialValue;
   double (*f_rhs)(double y, double t);
-
+  double (*f_rhs_context)(double y, double t, void *context);
+  void *rhsContext;
+  AbstractDiagnosticSink *diagnostics;
 
 protected:
+    /** Virtual function, overriden in the daughter classes, computing the numerical solution of the ODE and passing
+     * the record (t, y) of each time step to the sink with Output.*/
+    virtual void Solve(AbstractOutputSink &sink) = 0;
+    /** Called by SolveEquation before Solve, once the result is reset, e.g. to compute initial values which depend on
+     * the problem. Does nothing by default.*/
+    virtual void StartIntegration() {}
+    /** Called when the right hand side is set with SetRightHandSide, e.g. to forget what depended on the previous
+     * one. Does nothing by default.*/
+    virtual void RightHandSideChanged() {}
+    double EvaluateRightHandSide(double y, double t) const;
+    /** Pass a record to the sink, counting the values which are not finite.*/
+    void Output(AbstractOutputSink &sink, double t, double y) {
+        if (!std::isfinite(y) && result.nonFiniteValues++ == 0) {
+            result.firstNonFiniteTime = t;
+        }
+        sink.Write(t, y);
+    }
+    /** status and counters of the current integration. The evaluations of the right hand side are counted by
+     * RightHandSide, which is the reason why the result can be modified by const functions.*/
+    mutable SolverResult result;
     unsigned int s;
+    double StartingValue(double y, double t, double h, unsigned int substeps = 1, double *S = nullptr) const;
+    unsigned int StartingSubsteps(double y, double t, double h, unsigned int order, unsigned int minimum = 1,
+                                  const double *S = nullptr) const;
+    /** Whether the solver can compute the given sensitivities. False by default.*/
+    virtual bool SupportsSensitivity(const ForwardSensitivity &) const { return false; }
+    /** Derivative of f with respect to y used by the sensitivity equations.*/
+    virtual double SensitivityJacobian(double y, double t) const { return sensitivity->Jacobian(y, t); }
+    /** sensitivities computed with the solution, nullptr if none*/
+    ForwardSensitivity *sensitivity;
+    /** Report a problem to the diagnostic sink of the solver, with the action taken written as for a stream.*/
+    template <class... Action>
+    void Report(const Exception &error, const Action &... action) const {
+        std::ostringstream stream;
+        ((stream << action), ...);
+        diagnostics->Report(error.GetTag(), error.GetProblem(), stream.str());
+    }
     /** Virtual function, overriden in the daughter classes, setting the coefficients values b[i][j]  of the equations to solve .*/
     virtual void SetB() = 0;
     double b[max_order][max_order+1];
@@ -0,0 +1,14 @@
+#include "AbstractOutputSink.h"
+
+AbstractOutputSink::~AbstractOutputSink() {}
+
+void AbstractOutputSink::Reserve(unsigned long) {
+    /*! Called by the solver before writing a known number of records, given as the parameter. Nothing to do by
+    * default.
+    */
+}
+
+void AbstractOutputSink::Flush() {
+    /*! Make sure that all the records written so far have reached their destination. Nothing to do by default.
+    */
+}
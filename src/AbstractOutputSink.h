@@ -0,0 +1,20 @@
+#ifndef PCSC_PROJECT_ABSTRACTOUTPUTSINK_H
+#define PCSC_PROJECT_ABSTRACTOUTPUTSINK_H
+
+/** Abstract class receiving the records (t, y) computed by a solver, one per time step.
+ * The solvers never write to a file directly: AbstractOdeSolver::SolveEquation passes every record to a sink,
+ * which decides what to do with it (write it to a stream, queue it for another thread, ...). <br>
+ * The fixed step size solvers know the number of records before the first step, and announce it with Reserve so
+ * that the sink can allocate its storage once.
+ */
+class AbstractOutputSink {
+public:
+    virtual ~AbstractOutputSink();
+    /** Virtual function, overriden in the daughter classes, receiving the numerical solution y at time t.*/
+    virtual void Write(double t, double y) = 0;
+    virtual void Reserve(unsigned long records);
+    virtual void Flush();
+};
+
+
+#endif //PCSC_PROJECT_ABSTRACTOUTPUTSINK_H
@@ -0,0 +1,48 @@
+#include "AbstractStepSizeController.h"
+#include <algorithm>
+
+AbstractStepSizeController::AbstractStepSizeController(const double safety, const double minFactor,
+                                                       const double maxFactor)
+    : safety(safety), minFactor(minFactor), maxFactor(maxFactor), rejected(false) {}
+
+AbstractStepSizeController::~AbstractStepSizeController() = default;
+
+double AbstractStepSizeController::Factor(double error, const unsigned int k) const {
+    /*!
+    * \param error: error of the step divided by the tolerance
+    * \param k: order of the error estimate, the error being proportional to h^k
+    * \return The factor by which the step size is multiplied
+    */
+    // a zero error would give an infinite factor, which is limited anyway
+    error = std::max(error, 1e-10);
+    const double factor = std::min(maxFactor, std::max(minFactor, safety*RawFactor(error, k)));
+    return rejected ? std::min(factor, 1.) : factor;
+}
+
+void AbstractStepSizeController::Accept(const double) {
+    /*! Called by the solver when a step is accepted, with the error of the step divided by the tolerance, which
+    * controllers with a memory of the previous errors keep
+    */
+    rejected = false;
+}
+
+void AbstractStepSizeController::Reject() {
+    /*! Called by the solver when a step is rejected: the step size is not increased until a step is accepted
+    */
+    rejected = true;
+}
+
+void AbstractStepSizeController::Reset() {
+    /*! Forget the previous steps, called by the solver at the beginning of the integration
+    */
+    rejected = false;
+}
+
+void AbstractStepSizeController::SetLimits(const double minFactor, const double maxFactor) {
+    /*!
+    * \param minFactor: smallest factor, e.g. 0.2
+    * \param maxFactor: largest factor, e.g. 5
+    */
+    this->minFactor = minFactor;
+    this->maxFactor = maxFactor;
+}
@@ -0,0 +1,40 @@
+#ifndef PCSC_PROJECT_ABSTRACTSTEPSIZECONTROLLER_H
+#define PCSC_PROJECT_ABSTRACTSTEPSIZECONTROLLER_H
+
+/** Abstract class, mother class of the step size controllers of the adaptive solvers. <br>
+ * After each step, the solver gives the controller the error of the step divided by the tolerance (the step is
+ * accepted if it is at most 1) and the order k of the error estimate (the error is proportional to h^k). The
+ * controller returns the factor by which the step size is multiplied, from the current error and, for the PI and PID
+ * controllers, the errors of the previous accepted steps. <br>
+ * The factor is multiplied by a safety factor and kept between a minimal and a maximal factor. After a rejected
+ * step, the step size is not increased until a step is accepted.
+ */
+class AbstractStepSizeController {
+public:
+    AbstractStepSizeController(double safety, double minFactor, double maxFactor);
+    virtual ~AbstractStepSizeController();
+
+    double Factor(double error, unsigned int k) const;
+    virtual void Accept(double error);
+    void Reject();
+    virtual void Reset();
+
+    void SetLimits(double minFactor, double maxFactor);
+    double GetSafety() const { return safety; }
+    double GetMinFactor() const { return minFactor; }
+    double GetMaxFactor() const { return maxFactor; }
+
+protected:
+    /** Virtual function, overriden in the daughter classes, giving the factor before the safety factor and the
+     * limits are applied.*/
+    virtual double RawFactor(double error, unsigned int k) const = 0;
+
+private:
+    double safety;
+    double minFactor;
+    double maxFactor;
+    bool rejected;
+};
+
+
+#endif //PCSC_PROJECT_ABSTRACTSTEPSIZECONTROLLER_H
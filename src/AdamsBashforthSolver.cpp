@@ -3,11 +3,12 @@
 //
 
 #include "AdamsBashforthSolver.h"
+#include "AdamsCoefficients.h"
 #include "FileNotOpenException.hpp"
 #include "SetOrderException.h"
 #include <cassert>
-#include <iostream>
 #include <cmath>
+#include <vector>
 
 AdamsBashforthSolver::AdamsBashforthSolver() : AbstractExplicitSolver() {
     /**
@@ -31,8 +32,7 @@ void AdamsBashforthSolver::SetOrder(unsigned int order){
             throw SetOrderException("Order of the Adamsbashforth solver should be bigger or equal to 1.");
         }
     } catch (SetOrderException &error) {
-        error.PrintDebug();
-        std::cout << "The order is set to 1. " << std::endl;
+        Report(error, "The order is set to 1. ");
         order = 1;
     }
     AbstractOdeSolver::SetOrder(order);
@@ -44,36 +44,22 @@ AdamsBashforthSolver::~AdamsBashforthSolver() = default;
 void AdamsBashforthSolver::SetB(){
     /**
     * Set the matrix B of coefficients which define the equations to solve for each order.
-    *B is composed of 5 rows and 6 columns, the first row corresponding to the coefficients included in the equation
-    *for order 1 and the last row for order 5.
+    *B is composed of max_order rows, the row s-1 containing the coefficients of the method of order s, from the oldest
+    *value of f to the newest. The coefficients are computed exactly once (see AdamsCoefficients) and rounded to double.
      * Note that each row sums to 1.
    */
-    // s = 1:
-    b[0][0] = 1.;
-    // s = 2:
-    b[1][0] = -1./2;
-    b[1][1] = 3./2;
-    // s = 3:
-    b[2][0] = 5./12;
-    b[2][1] = -16./12;
-    b[2][2] = 23./12;
-    // s = 4:
-    b[3][0] = -9./24;
-    b[3][1] = 37./24;
-    b[3][2] = -59./24;
-    b[3][3] = 55./24;
-    // s = 5:
-    b[4][0] = 251./720;
-    b[4][1] = -1274./720;
-    b[4][2] = 2616./720;
-    b[4][3] = -2774./720;
-    b[4][4] = 1901./720;
+    const AdamsCoefficients &coefficients = AdamsCoefficients::Get();
+    for (unsigned int s = 1; s <= max_order; s++) {
+        for (unsigned int j = 0; j < s; j++) {
+            b[s-1][j] = coefficients.Bashforth(s, j).ToDouble();
+        }
+    }
 }
 
-void AdamsBashforthSolver::SolveEquation(std::ostream &stream) {
+void AdamsBashforthSolver::Solve(AbstractOutputSink &sink) {
 /*!
    \brief Implementation of the Adams Bashforth methods to solve scalar ODE in the form y'(t)=f(y,t).
-   * \param stream: name of the file on which to write the numerical solution at each time t
+   * \param sink: sink receiving the numerical solution at each time t
 */
     double y = GetInitialValue();
     double t = GetInitialTime();
@@ -82,23 +68,44 @@ void AdamsBashforthSolver::SolveEquation(std::ostream &stream) {
     assert(h > 1e-6);
 
     int n = static_cast<int>(std::floor((GetFinalTime() - GetInitialTime()) / h));
-    stream << t << " " << y << "\n";
+    sink.Reserve(n + 1);
+    Output(sink, t, y);
     double temp[order+1];
     double F[order+1];
     temp[0] = y;
     F[0] = RightHandSide(y, t);
-    // if the order is bigger than one, we need to compute the first y_i with AdamsBashforth with smaller degrees.
+    // sensitivities S_p and the history of their derivatives Fs[p*(order+1) + j], as F for y
+    const unsigned int m = sensitivity != nullptr ? sensitivity->Size() : 0;
+    std::vector<double> S(m);
+    std::vector<double> Fs(m*(order+1));
+    if (sensitivity != nullptr) {
+        for (unsigned int p = 0; p < m; p++) {
+            S[p] = sensitivity->GetInitialSensitivity(p);
+            Fs[p*(order+1)] = sensitivity->Jacobian(y, t)*S[p] + sensitivity->Forcing(p, y, t);
+        }
+        sensitivity->Start(n + 1);
+        sensitivity->Record(S.data());
+    }
+    // if the order is bigger than one, we need to compute y_1, ..., y_{order-1} with a one-step method of
+    // high enough order.
     if (order > 1) {
-        for (int j = 1; j < order+1; j++) {
-            double product = ProductWithB(F, j);
-            temp[j] = temp[j-1] + h*product;
+        for (int j = 1; j < order; j++) {
+            const unsigned int substeps = StartingSubsteps(temp[j-1], t, h, order, 1, m > 0 ? S.data() : nullptr);
+            temp[j] = StartingValue(temp[j-1], t, h, substeps, m > 0 ? S.data() : nullptr);
             t += h;
             F[j] = RightHandSide(temp[j], t);
-            stream << t << " " << temp[j] << "\n";
+            Output(sink, t, temp[j]);
+            if (m > 0) {
+                const double J = sensitivity->Jacobian(temp[j], t);
+                for (unsigned int p = 0; p < m; p++) {
+                    Fs[p*(order+1) + j] = J*S[p] + sensitivity->Forcing(p, temp[j], t);
+                }
+                sensitivity->Record(S.data());
+            }
         }
     }
 
-    for (int i = order; i < n; ++i) {
+    for (int i = order; i <= n; ++i) {
         double product = ProductWithB(F, order);
         y = temp[order-1] + h*product;
         t += h;
@@ -111,9 +118,21 @@ void AdamsBashforthSolver::SolveEquation(std::ostream &stream) {
             temp[j] = temp[j+1];
             F[j] = F[j+1];
         }
+        if (m > 0) {
+            const double J = sensitivity->Jacobian(y, t);
+            for (unsigned int p = 0; p < m; p++) {
+                double *Fs_p = &Fs[p*(order+1)];
+                S[p] += h*ProductWithB(Fs_p, order);
+                Fs_p[order] = J*S[p] + sensitivity->Forcing(p, y, t);
+                for (int j = 0; j < order; j++) {
+                    Fs_p[j] = Fs_p[j+1];
+                }
+            }
+            sensitivity->Record(S.data());
+        }
 
-        //store the values in the outstream
-        stream << t << " " << y << "\n";
+        //pass the values to the sink
+        Output(sink, t, y);
     }
 }
 
@@ -17,7 +17,6 @@
      */
 class AdamsBashforthSolver : public AbstractExplicitSolver {
 public:
-    virtual void SolveEquation(std::ostream &stream);
     AdamsBashforthSolver();
     AdamsBashforthSolver(const double h, const double t0, const double t1, const double y0,
                          double (*f)(double y, double t), const unsigned int s);
@@ -25,6 +24,10 @@ public:
     void SetOrder(const unsigned int order) override;
 
 protected:
+    void Solve(AbstractOutputSink &sink) override;
+    bool SupportsSensitivity(const ForwardSensitivity &sensitivity) const override {
+        return sensitivity.HasJacobian();
+    }
     void SetB() override;
 };
 
@@ -0,0 +1,63 @@
+#include "AdamsCoefficients.h"
+
+#include <vector>
+
+const AdamsCoefficients &AdamsCoefficients::Get() {
+    /*!
+    * \return The table of coefficients, computed on the first call (thread-safe)
+    */
+    static const AdamsCoefficients coefficients;
+    return coefficients;
+}
+
+AdamsCoefficients::AdamsCoefficients() {
+    /**
+    Compute the coefficients of every order, in rational arithmetic.
+    */
+    long long factorial[max_order];
+    factorial[0] = 1;
+    for (unsigned int i = 1; i < max_order; i++) {
+        factorial[i] = factorial[i-1]*i;
+    }
+    for (unsigned int s = 1; s <= max_order; s++) {
+        // Adams-Bashforth: nodes t_n, ..., t_{n+1-s}, i.e. u = 0, -1, ..., 1-s
+        for (unsigned int j = 0; j < s; j++) {
+            const Rational weight(j % 2 == 0 ? 1 : -1, factorial[j]*factorial[s-1-j]);
+            bashforth[s-1][s-1-j] = Integral(0, s, j)*weight;
+        }
+    }
+    for (unsigned int s = 0; s < max_order; s++) {
+        // Adams-Moulton: nodes t_{n+1}, ..., t_{n+1-s}, i.e. u = 1, 0, ..., 1-s
+        for (unsigned int j = 0; j <= s; j++) {
+            const Rational weight(j % 2 == 0 ? 1 : -1, factorial[j]*factorial[s-j]);
+            moulton[s][s-j] = Integral(-1, s + 1, j)*weight;
+        }
+    }
+}
+
+Rational AdamsCoefficients::Integral(const int shift, const unsigned int points, const unsigned int skipped) {
+    /*!
+    * \param shift: offset added to each factor
+    * \param points: number of interpolation points
+    * \param skipped: index of the point whose factor is left out
+    * \return \f$ \int_0^1 \prod_{i \neq skipped} (u + i + shift) du \f$, \f$ i = 0, \dots, points-1 \f$
+    */
+    // integer coefficients of the polynomial, by increasing degree
+    std::vector<long long> polynomial(1, 1);
+    for (unsigned int i = 0; i < points; i++) {
+        if (i == skipped) {
+            continue;
+        }
+        const long long root = static_cast<long long>(i) + shift;
+        polynomial.push_back(0);
+        for (size_t k = polynomial.size() - 1; k > 0; k--) {
+            polynomial[k] = polynomial[k-1] + root*polynomial[k];
+        }
+        polynomial[0] *= root;
+    }
+    Rational integral(0);
+    for (size_t k = 0; k < polynomial.size(); k++) {
+        integral += Rational(polynomial[k], static_cast<long long>(k + 1));
+    }
+    return integral;
+}
@@ -0,0 +1,36 @@
+#ifndef PCSC_PROJECT_ADAMSCOEFFICIENTS_H
+#define PCSC_PROJECT_ADAMSCOEFFICIENTS_H
+
+#include "AbstractOdeSolver.hpp"
+#include "Rational.h"
+
+/** Exact coefficients of the Adams-Bashforth and Adams-Moulton methods of every order up to max_order. <br>
+ * The coefficient of \f$ f_{n-j} \f$ is the integral over the last step of the Lagrange polynomial which interpolates
+ * f at the previous points: with \f$ t = t_n + u h \f$, the Adams-Bashforth method with s steps uses
+ * \f$ \beta_j = \frac{(-1)^j}{j!(s-1-j)!} \int_0^1 \prod_{i \neq j} (u+i) du \f$, \f$ i, j = 0, \dots, s-1 \f$,
+ * and the Adams-Moulton method of order parameter s the same integral over the s+1 points
+ * \f$ t_{n+1}, \dots, t_{n+1-s} \f$. The integrals are computed in rational arithmetic, so that the coefficients are
+ * exact before being rounded once to double. <br>
+ * The table is computed on the first call to Get and shared by all the solvers.
+ */
+class AdamsCoefficients {
+public:
+    static const AdamsCoefficients &Get();
+
+    /** Coefficient of the sth order Adams-Bashforth method (1 <= s <= max_order) in the order of the history of the
+     * solver: j = 0 multiplies the oldest value of f and j = s-1 the newest.*/
+    const Rational &Bashforth(unsigned int s, unsigned int j) const { return bashforth[s-1][j]; }
+    /** Coefficient of the Adams-Moulton method with order parameter s (0 <= s < max_order, order s+1), in the order
+     * of the history of the solver: j = 0 multiplies the oldest value of f and j = s the implicit one.*/
+    const Rational &Moulton(unsigned int s, unsigned int j) const { return moulton[s][j]; }
+
+private:
+    AdamsCoefficients();
+    static Rational Integral(int shift, unsigned int points, unsigned int skipped);
+
+    Rational bashforth[max_order][max_order];
+    Rational moulton[max_order][max_order];
+};
+
+
+#endif //PCSC_PROJECT_ADAMSCOEFFICIENTS_H
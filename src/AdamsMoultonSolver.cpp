@@ -1,11 +1,11 @@
 
 #include "AdamsMoultonSolver.h"
+#include "AdamsCoefficients.h"
 #include "SetOrderException.h"
-#include "Exception.hpp"
 
 #include <cassert>
-#include <iostream>
 #include <cmath>
+#include <vector>
 
 AdamsMoultonSolver::AdamsMoultonSolver() : AbstractImplicitSolver() {
     /**
@@ -26,16 +26,15 @@ AdamsMoultonSolver::~AdamsMoultonSolver() =default;
 
 void AdamsMoultonSolver::SetOrder(unsigned int order){
     /**
-    Checks if the order specified by the user is well between 0 and 4. If it is higher than 4, then the order is directly
-     set to 4.
+    Checks if the order specified by the user is well between 0 and max_order-1. If it is higher, then the order is
+     directly set to max_order-1.
     */
     try {
         if (order > max_order-1) {
             throw SetOrderException("Order must be strictly smaller than " + std::to_string(max_order));
         }
     } catch (SetOrderException &error) {
-        error.PrintDebug();
-        std::cout << "The order is set to the maximum order: " << max_order-1 << std::endl;
+        Report(error, "The order is set to the maximum order: ", max_order-1);
         order = max_order-1;
     }
     AbstractOdeSolver::SetOrder(order);
@@ -43,44 +42,33 @@ void AdamsMoultonSolver::SetOrder(unsigned int order){
 }
 
 void AdamsMoultonSolver::SetB(){
-    // test if sum of b is equal to 1
-    //b=  std::fill(b[0] + 0, b[max_order] + max_order, 0);
     /**
     * Set the matrix B of coefficients which define the equations to solve for each order.
-     B is composed of 5 rows and 6 columns, the first row corresponding the coefficients included in the equation
-     for order 0 and the last row for order 4.
+     B is composed of max_order rows, the row s containing the coefficients of the method of order s+1, from the
+     oldest value of f to the implicit one. The coefficients are computed exactly once (see AdamsCoefficients) and
+     rounded to double.
     *
     */
-    b[0][1] = 0;
-    b[0][1]=1;
-
-    b[1][1]=1./2;
-    b[1][2]=1./2;
-
-    b[2][1] = -1./12;
-    b[2][2]=8./12;
-    b[2][3]=5./12;
-
-    b[3][1] = 1./24;
-    b[3][2]=-5./24;
-    b[3][3]= 19./24;
-    b[3][4]= 9./24;
-
-    b[4][1] = -19./720;
-    b[4][2]= 106./720;
-    b[4][3]= -264./720;
-    b[4][4]= 646./720;
-    b[4][5] = 251./720;
+    const AdamsCoefficients &coefficients = AdamsCoefficients::Get();
+    // the first column is not used by the implicit methods, it is set to zero.
+    for (unsigned int s = 0; s < max_order; s++) {
+        b[s][0] = 0;
+        for (unsigned int j = 0; j <= s; j++) {
+            b[s][j+1] = coefficients.Moulton(s, j).ToDouble();
+        }
+    }
 }
 
 template <class Function, class FunctionDerivative>
-double Newton (double y_prev,Function F, FunctionDerivative dF, double const epsilon=1e-6, int const max_iter=1000){
+double Newton (double y_prev,Function F, FunctionDerivative dF, bool &converged, double const epsilon=1e-6,
+               int const max_iter=1000){
     /*!
      * Finds a zero of the differentiable function F using the Newton method and returns a double corresponding
        to the final approximations of the zero
      * \param y_prev: initial guess
      * \param F: function whose zero is sought
      * \param dF: derivative of F with respect to y
+     * \param converged: set to false if the maximum number of iterations is reached without convergence
      * \param epsilon: tolerance on error allowed
      * \param max_iter: maximum number of operations
      *
@@ -94,23 +82,16 @@ double Newton (double y_prev,Function F, FunctionDerivative dF, double const eps
         ++num_iter;
     } while ((std::abs(x_next - x_prev) > epsilon) && (num_iter < max_iter));
 
-    try {
-        if ((num_iter == max_iter) && (std::abs(x_next - x_prev) > epsilon)) {
-            throw Exception("MAX_IT", "Max number of iterations reached without convergence");
-        }
-    } catch (Exception &error) {
-        error.PrintDebug();
-    }
-
+    converged = (num_iter < max_iter) || (std::abs(x_next - x_prev) <= epsilon);
     return x_next;
 }
-void AdamsMoultonSolver::SolveEquation(std::ostream &stream) {
+void AdamsMoultonSolver::Solve(AbstractOutputSink &sink) {
     /*!
     * Adams Moulton methods for the scalar ODE in the form:
      *  \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0 \f$
     * The Newton method is used to solve the nonlinear equation at each time t.
 
-    * \param stream: name of the file in which to write the numerical solution at each time t
+    * \param sink: sink receiving the numerical solution at each time t
     */
     double y = GetInitialValue();
     double t = GetInitialTime();
@@ -119,33 +100,48 @@ void AdamsMoultonSolver::SolveEquation(std::ostream &stream) {
     assert(h > 1e-6);
 
     int n = static_cast<int>(std::floor((GetFinalTime() - GetInitialTime()) / h));
+    sink.Reserve(n + 1);
     double temp[order+1];
     double F[order+1];
 
     temp[0] = y;
     F[0] = RightHandSide(y, t);
 
-    stream << t << " " << y << "\n";
-    // if the order is bigger than zero, we need to compute the first y_i with AdamsMoulton with smaller degrees.
+    Output(sink, t, y);
+    // sensitivities S_p and the history of their derivatives Fs[p*(order+1) + j], as F for y
+    const unsigned int m = sensitivity != nullptr ? sensitivity->Size() : 0;
+    std::vector<double> S(m);
+    std::vector<double> Fs(m*(order+1));
+    if (sensitivity != nullptr) {
+        for (unsigned int p = 0; p < m; p++) {
+            S[p] = sensitivity->GetInitialSensitivity(p);
+            Fs[p*(order+1)] = dRightHandSide(y, t)*S[p] + sensitivity->Forcing(p, y, t);
+        }
+        sensitivity->Start(n + 1);
+        sensitivity->Record(S.data());
+    }
+    // if the order is bigger than zero, we need to compute the first y_i with a one-step method of high enough
+    // order. The sub-steps keep h*df/dy in the stability region of the Runge-Kutta method.
     if (order>0){
         for (int j = 1; j < order+1; j++) {
+            const double stiffness = std::abs(h*dRightHandSide(temp[j-1], t));
+            const unsigned int stable = static_cast<unsigned int>(std::min(std::ceil(stiffness/2), 1000.));
+            const unsigned int substeps = StartingSubsteps(temp[j-1], t, h, order+1, std::max(stable, 1u),
+                                                           m > 0 ? S.data() : nullptr);
+            temp[j] = StartingValue(temp[j-1], t, h, substeps, m > 0 ? S.data() : nullptr);
             t+=h;
-            double product = h*ProductWithB(F,j);
-            double c = product + temp[j-1];
-
-            auto Fu = [&](double x) {
-                return x - c - b[j-1][j] * h * RightHandSide(x, t);
-            };
-
-            auto dFu = [&](double x) {
-                return 1 - b[j-1][j] * h * dRightHandSide(x, t);
-            };
-            temp[j] = Newton(temp[j-1],Fu,dFu);
 
             F[j] = RightHandSide(temp[j], t);
 
-            //store the values in the outstream
-            stream << t << " " << temp[j] << "\n";
+            //pass the values to the sink
+            Output(sink, t, temp[j]);
+            if (m > 0) {
+                const double J = dRightHandSide(temp[j], t);
+                for (unsigned int p = 0; p < m; p++) {
+                    Fs[p*(order+1) + j] = J*S[p] + sensitivity->Forcing(p, temp[j], t);
+                }
+                sensitivity->Record(S.data());
+            }
         }
     }
 
@@ -162,7 +158,12 @@ void AdamsMoultonSolver::SolveEquation(std::ostream &stream) {
             return 1 - b[order][order+1] * h * dRightHandSide(x, t);
         };
 
-        y = Newton(temp[order],Fu, dFu, 1e-6, 1000);
+        bool converged;
+        y = Newton(temp[order],Fu, dFu, converged, 1e-6, 1000);
+        if (!converged) {
+            // reported once at the end of the integration
+            ++result.newtonFailures;
+        }
 
         //store the new temporary values in temp and F:
         for(int k=0; k<order; k++){
@@ -172,8 +173,25 @@ void AdamsMoultonSolver::SolveEquation(std::ostream &stream) {
         temp[order] = y;
         F[order] = RightHandSide(temp[order], t);
 
-        //store the values in the outstream
-        stream << t << " " << temp[order] << "\n";
+        //pass the values to the sink
+        Output(sink, t, temp[order]);
+        if (m > 0) {
+            // staggered corrector: the sensitivity equations are linear, their implicit step is solved exactly with
+            // the Newton matrix 1 - b h df/dy at the converged value
+            const double bh = b[order][order+1]*h;
+            const double J = dRightHandSide(y, t);
+            const double newton_matrix = 1 - bh*J;
+            for (unsigned int p = 0; p < m; p++) {
+                double *Fs_p = &Fs[p*(order+1)];
+                const double forcing = sensitivity->Forcing(p, y, t);
+                S[p] = (S[p] + h*ProductWithB(Fs_p, order+1) + bh*forcing)/newton_matrix;
+                for (int k = 0; k < order; k++) {
+                    Fs_p[k] = Fs_p[k+1];
+                }
+                Fs_p[order] = J*S[p] + forcing;
+            }
+            sensitivity->Record(S.data());
+        }
     }
 
-}
\ No newline at end of file
+}
@@ -8,7 +8,8 @@
  * /** Daughter of Abstract Implicit Solver class.
  * The Adams Moulton solver solves the initial value problem
      \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0 \f$
-   It is an ensemble of implicit methods of different orders between 0 and 4 included.
+   It is an ensemble of implicit methods of different orders between 0 and max_order-1 included, the method of order s
+   being of order s+1.
  */
 
 class AdamsMoultonSolver : public AbstractImplicitSolver {
@@ -18,10 +19,10 @@ public:
                          double (*f)(double y, double t),double (*df)(double y, double t), const unsigned int s);
     ~AdamsMoultonSolver() override;
     void SetOrder(const unsigned int order) override;
-    void SolveEquation(std::ostream &stream) override;
 
 
 protected:
+    void Solve(AbstractOutputSink &sink) override;
     void SetB() override;
 };
 
@@ -0,0 +1,181 @@
+#include "AsyncOutputSink.h"
+#include <chrono>
+
+AsyncOutputSink::AsyncOutputSink(AbstractOutputSink &downstream, size_t capacity, Backpressure policy,
+                                 AbstractOutputSink *tap)
+    /**
+    * Constructor starting the writer thread.
+    * \param downstream: sink receiving the records, from the writer thread
+    * \param capacity: number of records the ring buffer can hold (rounded up to a power of two)
+    * \param policy: what to do when the ring buffer is full
+    * \param tap: optional second sink receiving the same records
+    */
+    : downstream(downstream), tap(tap), policy(policy), producerSegment(new Segment(capacity < 2 ? 2 : capacity)),
+      stride(1), index(0), hasPending(false), pending{0., 0.}, dropped(0) {
+    consumerSegment = producerSegment;
+    writer = std::thread(&AsyncOutputSink::Run, this);
+}
+
+AsyncOutputSink::~AsyncOutputSink() {
+    Close();
+    delete consumerSegment;
+}
+
+void AsyncOutputSink::Write(double t, double y) {
+    /*! Queue a record for the writer thread. Only blocks with the Block policy when the buffer is full.
+    * \param t: time
+    * \param y: numerical solution at time t
+    */
+    const Record record{t, y};
+    if (policy != Backpressure::Decimate) {
+        Push(record);
+        return;
+    }
+    SpscRingBuffer<Record> &ring = producerSegment->ring;
+    if (index++ % stride == 0) {
+        if (ring.TryPush(record)) {
+            hasPending = false;
+            if (stride > 1 && ring.Size() < ring.GetCapacity() / 4) {
+                stride /= 2;
+            }
+            WakeWriter();
+            return;
+        }
+        // the buffer is full: keep half as many records
+        stride *= 2;
+    }
+    pending = record;
+    hasPending = true;
+    ++dropped;
+}
+
+void AsyncOutputSink::Reserve(unsigned long records) {
+    /*! Pass the number of records to the downstream sink and the tap, once the writer thread is idle.
+    * \param records: number of records that are about to be written
+    */
+    Flush();
+    downstream.Reserve(records);
+    if (tap != nullptr) {
+        tap->Reserve(records);
+    }
+}
+
+void AsyncOutputSink::Flush() {
+    /*! Wait until all the records written so far have been passed to the downstream sink, and flush it.
+    */
+    if (closed.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (hasPending) {
+        // the last record is never lost, even when decimating
+        hasPending = false;
+        --dropped;
+        Push(pending);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    flushRequested.store(true, std::memory_order_release);
+    wake.notify_one();
+    flushed.wait(lock, [this] { return !flushRequested.load(std::memory_order_acquire); });
+}
+
+void AsyncOutputSink::Close() {
+    /*! Write the remaining records and stop the writer thread. Nothing can be written afterwards.
+    */
+    if (!writer.joinable()) {
+        return;
+    }
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void AsyncOutputSink::Push(const AsyncOutputSink::Record &record) {
+    /*! Push a record without dropping it, waiting for the writer (Block) or chaining a larger buffer (Grow).
+    */
+    while (!producerSegment->ring.TryPush(record)) {
+        if (policy == Backpressure::Grow) {
+            auto *segment = new Segment(2 * producerSegment->ring.GetCapacity());
+            producerSegment->next.store(segment, std::memory_order_release);
+            producerSegment = segment;
+        } else {
+            WakeWriter();
+            std::this_thread::yield();
+        }
+    }
+    WakeWriter();
+}
+
+void AsyncOutputSink::WakeWriter() {
+    /*! Notify the writer thread if it is waiting for records. The mutex is only taken in that case.
+    */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wake.notify_one();
+    }
+}
+
+bool AsyncOutputSink::Pop(AsyncOutputSink::Record &record) {
+    /*! Called by the writer thread only.
+    * \param record: oldest record not written yet
+    * \return false if there is no record to write
+    */
+    while (true) {
+        if (consumerSegment->ring.TryPop(record)) {
+            return true;
+        }
+        Segment *next = consumerSegment->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        // the records pushed before the producer moved to the next segment are visible now
+        if (consumerSegment->ring.TryPop(record)) {
+            return true;
+        }
+        delete consumerSegment;
+        consumerSegment = next;
+    }
+}
+
+void AsyncOutputSink::Run() {
+    /*! Loop of the writer thread: drain the buffer, then sleep until the producer writes, flushes or closes.
+    */
+    Record record;
+    while (true) {
+        // read the requests before draining, so that every record written before them is drained
+        const bool flush = flushRequested.load(std::memory_order_acquire);
+        const bool close = closed.load(std::memory_order_acquire);
+        while (Pop(record)) {
+            downstream.Write(record.t, record.y);
+            if (tap != nullptr) {
+                tap->Write(record.t, record.y);
+            }
+        }
+        if (flush) {
+            downstream.Flush();
+            if (tap != nullptr) {
+                tap->Flush();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            flushRequested.store(false, std::memory_order_release);
+            flushed.notify_all();
+            continue;
+        }
+        if (close) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        writerSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerSegment->ring.Size() == 0 && consumerSegment->next.load(std::memory_order_acquire) == nullptr
+            && !flushRequested.load(std::memory_order_acquire) && !closed.load(std::memory_order_acquire)) {
+            // the timeout only bounds the latency of a monitor tapping the stream
+            wake.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        writerSleeping.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef PCSC_PROJECT_ASYNCOUTPUTSINK_H
+#define PCSC_PROJECT_ASYNCOUTPUTSINK_H
+
+#include "AbstractOutputSink.h"
+#include "SpscRingBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/** What AsyncOutputSink does when the solver produces records faster than they can be written: <br>
+ * Block: the solver waits until the writer thread has made room, no record is lost. <br>
+ * Decimate: only one record out of 2, 4, 8, ... is kept while the buffer is full, the stride is halved again when
+ * the writer catches up. The last record is always written. <br>
+ * Grow: a new buffer twice as large is chained after the full one, no record is lost and the solver never waits.
+ */
+enum class Backpressure { Block, Decimate, Grow };
+
+/** Daughter of AbstractOutputSink. Moves the writing of the records off the integrating thread. <br>
+ * Write only pushes the record into a lock-free single-producer single-consumer ring buffer (see SpscRingBuffer);
+ * a dedicated writer thread drains the buffer into the downstream sink, and optionally into a tap, e.g. a monitor
+ * or a plotter following the solution while it is computed. The downstream sink and the tap are only used by the
+ * writer thread. <br>
+ * Write must always be called from the same thread. Flush waits until everything written so far has reached the
+ * downstream sink, Close (or the destructor) also stops the writer thread.
+ */
+class AsyncOutputSink : public AbstractOutputSink {
+public:
+    explicit AsyncOutputSink(AbstractOutputSink &downstream, size_t capacity = 1 << 14,
+                             Backpressure policy = Backpressure::Block, AbstractOutputSink *tap = nullptr);
+    ~AsyncOutputSink() override;
+
+    void Write(double t, double y) override;
+    void Reserve(unsigned long records) override;
+    void Flush() override;
+    void Close();
+
+    Backpressure GetBackpressure() const { return policy; }
+    unsigned long GetNumberOfDroppedRecords() const { return dropped; }
+
+private:
+    struct Record {
+        double t;
+        double y;
+    };
+    /** ring buffer, followed by a larger one once it is full with the Grow policy */
+    struct Segment {
+        explicit Segment(size_t capacity) : ring(capacity) {}
+        SpscRingBuffer<Record> ring;
+        std::atomic<Segment *> next{nullptr};
+    };
+
+    void Push(const Record &record);
+    void WakeWriter();
+    bool Pop(Record &record);
+    void Run();
+
+    AbstractOutputSink &downstream;
+    AbstractOutputSink *tap;
+    const Backpressure policy;
+
+    // producer side
+    Segment *producerSegment;
+    unsigned long stride;
+    unsigned long index;
+    bool hasPending;
+    Record pending; // last record dropped by Decimate, written on Flush if nothing came after it
+    unsigned long dropped;
+
+    // consumer side
+    Segment *consumerSegment;
+
+    std::atomic<bool> writerSleeping{false};
+    std::atomic<bool> flushRequested{false};
+    std::atomic<bool> closed{false};
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    std::thread writer;
+};
+
+
+#endif //PCSC_PROJECT_ASYNCOUTPUTSINK_H
@@ -0,0 +1,287 @@
+#include "AutoSolver.h"
+#include "AdamsCoefficients.h"
+#include "SetOrderException.h"
+#include "UncoherentValueException.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// length R of the real stability interval [-R, 0] of the explicit Runge-Kutta methods of order 1 to 4
+const double STABILITY_INTERVAL[max_rk_order] = {2., 2., 2.5127, 2.7853};
+// safety factor of the step sizes
+const double SAFETY = 0.9;
+// largest ratio between the step sizes of two windows
+const double GROWTH = 10.;
+
+}
+
+AutoSolver::AutoSolver() : AbstractImplicitSolver(), tolerance(1e-6), checkInterval(20) {
+    /**
+    Constructor of an automatic solver instance, with a tolerance of 1e-6 and all the explicit methods.
+    */
+    SetB();
+    AutoSolver::SetOrder(max_rk_order);
+}
+
+AutoSolver::AutoSolver(const double h, const double t0, const double t1, const double y0,
+                       double (*f)(double, double), const unsigned int s)
+    : AbstractImplicitSolver(h, t0, t1, y0, f, nullptr, s), tolerance(1e-6), checkInterval(20) {
+    /**
+    Constructor of an automatic solver instance, where each parameter are defined from outside the class. The
+     stiffness is estimated with finite differences unless df is set with SetdRightHandSide.
+    */
+    SetB();
+    AutoSolver::SetOrder(s);
+}
+
+AutoSolver::~AutoSolver() = default;
+
+void AutoSolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: largest order of the explicit methods, between 1 and 4
+*/
+    try {
+        if (order < 1 || order > max_rk_order) {
+            throw SetOrderException("The order of the automatic solver should be between 1 and 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 4.");
+        order = max_rk_order;
+    }
+    AbstractOdeSolver::SetOrder(order);
+}
+
+void AutoSolver::SetTolerance(double tol) {
+    /*! Set the tolerance on the local error per unit step, relative to 1 + |y|
+    * \param tol: tolerance, strictly positive
+    */
+    try {
+        if (!(tol > 0)) {
+            throw UncoherentValueException("The tolerance of the automatic solver must be strictly positive.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The tolerance is set to 1e-6.");
+        tol = 1e-6;
+    }
+    tolerance = tol;
+}
+
+void AutoSolver::SetCheckInterval(unsigned int steps) {
+    /*! Set the number of steps after which the stiffness is estimated again and the method chosen again
+    * \param steps: number of steps of a window, at least 1
+    */
+    try {
+        if (steps < 1) {
+            throw UncoherentValueException("The stiffness must be checked at least every step.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The stiffness is checked at every step.");
+        steps = 1;
+    }
+    checkInterval = steps;
+}
+
+void AutoSolver::SetB() {
+    /**
+   * Copy the coefficients of the explicit methods from the Runge-Kutta solver, the weights of order p in the row
+     p-1 of b, and the weights of the trapezoidal rule from the Adams Moulton coefficients.
+   *
+   */
+    RKSolver methods;
+    for (unsigned int p = 1; p <= max_rk_order; p++) {
+        methods.SetOrder(p);
+        for (unsigned int j = 0; j < p; j++) {
+            b[p-1][j] = methods.GetB(p-1, j);
+            c[p-1][j] = methods.GetC(p-1, j);
+            for (unsigned int l = 0; l < j; l++) {
+                a[p-1][j][l] = methods.GetA(j, l);
+            }
+        }
+    }
+    const AdamsCoefficients &coefficients = AdamsCoefficients::Get();
+    trapezoidal[0] = coefficients.Moulton(1, 0).ToDouble();
+    trapezoidal[1] = coefficients.Moulton(1, 1).ToDouble();
+}
+
+double AutoSolver::EstimateEigenvalue(const double y, const double t, const double f_y) const {
+    /*! Estimate the dominant eigenvalue of the Jacobian, df/dy for a scalar equation, with one evaluation of df or f
+    * \param y: value
+    * \param t: time
+    * \param f_y: evaluation of f(y,t)
+    * \return dRightHandSide(y,t) if df is set, a forward difference of f otherwise (see Jacobian)
+    */
+    return Jacobian(y, t, f_y);
+}
+
+double AutoSolver::ExplicitStep(const unsigned int order, const double y, const double t, const double h,
+                                const double f_y) const {
+    /*! Step of the explicit Runge-Kutta method of the given order, with order-1 evaluations of f
+    * \param order: order of the method, between 1 and 4
+    * \param y: value at time t
+    * \param t: time
+    * \param h: step size
+    * \param f_y: evaluation of f(y,t), the first stage
+    * \return The value at time t+h
+    */
+    double k[max_rk_order];
+    k[0] = f_y;
+    for (unsigned int j = 1; j < order; j++) {
+        k[j] = RightHandSide(y + h*ScalarProduct(j, k, a[order-1][j]), t + c[order-1][j]*h);
+    }
+    return y + h*ProductWithB(k, order);
+}
+
+double AutoSolver::ImplicitStep(const unsigned int order, const double y, const double t, const double h,
+                                const double f_y, unsigned int &evaluations) const {
+    /*! Step of backward Euler (order 1) or of the trapezoidal rule (order 2), the equation
+    * \f$ x = y + h (\beta_0 f(y,t) + \beta_1 f(x,t+h)) \f$ being solved with the Newton method
+    * \param order: order of the method, 1 or 2
+    * \param y: value at time t
+    * \param t: time
+    * \param h: step size
+    * \param f_y: evaluation of f(y,t)
+    * \param evaluations: receives the number of evaluations of f and df. It is 0 if the Newton method did not
+    * converge.
+    * \return The value at time t+h
+    */
+    const double beta_explicit = order == 1 ? 0. : trapezoidal[0];
+    const double beta_implicit = order == 1 ? 1. : trapezoidal[1];
+    const double constant = y + h*beta_explicit*f_y;
+    const int max_iter = 20;
+    // y is a better first guess than an explicit step, which is unstable on stiff problems
+    double x = y;
+    evaluations = 0;
+    for (int iteration = 0; iteration < max_iter; iteration++) {
+        const double f_x = RightHandSide(x, t + h);
+        const double jacobian = Jacobian(x, t + h, f_x);
+        evaluations += 2;
+        const double correction = (x - constant - h*beta_implicit*f_x)/(1 - h*beta_implicit*jacobian);
+        x -= correction;
+        if (std::abs(correction) <= 1e-2*tolerance*(1 + std::abs(x))) {
+            return x;
+        }
+    }
+    evaluations = 0;
+    return x;
+}
+
+AutoSolverChoice AutoSolver::Choose(const double y, const double t, const double f_y, const double h_previous) const {
+    /*! Estimate the stiffness and choose the method and the step size of the next window. The local error of each
+    * candidate is measured on a probe step, at most GROWTH times the previous step size: it is only extrapolated to
+    * a step size at most GROWTH times bigger, the local error of a method of order p being C h^(p+1) only for small
+    * steps.
+    * \param y: value at time t
+    * \param t: beginning of the window
+    * \param f_y: evaluation of f(y,t)
+    * \param h_previous: step size of the previous window, or the largest step size for the first one
+    * \return The cheapest method per unit time for the tolerance
+    */
+    const double lambda = EstimateEigenvalue(y, t, f_y);
+    const double h_max = std::min(GetStepSize(), GetFinalTime() - t);
+    const double h_probe = std::min(GROWTH*h_previous, h_max);
+    const double scale = tolerance*(1 + std::abs(y));
+    const double round_off = 4*std::numeric_limits<double>::epsilon()*(1 + std::abs(y));
+    // step size for which the local error C h^(p+1) of a method of order p, measured on a probe of size h, is scale*h
+    auto accurate_step = [&](double one_step, double two_steps, double h, unsigned int p) {
+        const double error = std::max(std::abs(two_steps - one_step)/(1 - std::ldexp(1., -static_cast<int>(p))),
+                                      round_off);
+        if (!std::isfinite(error)) {
+            return 0.;
+        }
+        return std::min(SAFETY*h*std::pow(scale*h/error, 1./p), std::min(GROWTH*h, h_max));
+    };
+
+    AutoSolverChoice best = {t, lambda, false, 1, 0.};
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (unsigned int p = 1; p <= GetOrder(); p++) {
+        // the probe of an explicit method must be stable
+        double h = h_probe;
+        if (lambda < 0) {
+            h = std::min(h, SAFETY*STABILITY_INTERVAL[p-1]/std::abs(lambda));
+        }
+        const double one_step = ExplicitStep(p, y, t, h, f_y);
+        const double half = ExplicitStep(p, y, t, h/2, f_y);
+        const double two_steps = ExplicitStep(p, half, t + h/2, h/2, RightHandSide(half, t + h/2));
+        h = std::min(accurate_step(one_step, two_steps, h, p), h);
+        // p evaluations of f per step, the first stage of the next step included
+        const double cost = p/h;
+        if (cost < best_cost) {
+            best = {t, lambda, false, p, h};
+            best_cost = cost;
+        }
+    }
+    for (unsigned int p = 1; p <= std::min(2u, GetOrder()); p++) {
+        unsigned int evaluations;
+        unsigned int half_evaluations;
+        unsigned int second_half_evaluations;
+        const double one_step = ImplicitStep(p, y, t, h_probe, f_y, evaluations);
+        const double half = ImplicitStep(p, y, t, h_probe/2, f_y, half_evaluations);
+        const double two_steps = ImplicitStep(p, half, t + h_probe/2, h_probe/2, RightHandSide(half, t + h_probe/2),
+                                              second_half_evaluations);
+        // the error estimate is meaningless if the Newton method of one of the probes did not converge
+        if (evaluations == 0 || half_evaluations == 0 || second_half_evaluations == 0) {
+            continue;
+        }
+        const double h = accurate_step(one_step, two_steps, h_probe, p);
+        const double cost = (evaluations + 1)/h;
+        if (cost < best_cost) {
+            best = {t, lambda, true, p, h};
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+void AutoSolver::Solve(AbstractOutputSink &sink) {
+    /*!
+    * Automatic choice of the method for the scalar ODE in the form y'(t)=f(y,t). The method and the step size are
+    * chosen again every checkInterval steps.
+    * \param sink: sink receiving the numerical solution at each time t
+    */
+    double y = GetInitialValue();
+    double t = GetInitialTime();
+    const double t1 = GetFinalTime();
+    choices.clear();
+    Output(sink, t, y);
+    // the first probes are made with the largest step size
+    double h = GetStepSize();
+    double f_y = RightHandSide(y, t);
+    while (t1 - t > 1e-12*std::max(1., std::abs(t1))) {
+        AutoSolverChoice choice = Choose(y, t, f_y, h);
+        if (!(choice.stepSize > 1e-12*std::max(1., std::abs(t)))) {
+            // reported at the end of the integration
+            result.status = SolverStatus::StepSizeTooSmall;
+            break;
+        }
+        // the window is made of n equal steps
+        const double t_start = t;
+        const double t_end = std::min(t + checkInterval*choice.stepSize, t1);
+        const unsigned long n = static_cast<unsigned long>(std::ceil((t_end - t_start)/choice.stepSize - 1e-9));
+        h = (t_end - t_start)/n;
+        choice.stepSize = h;
+        choices.push_back(choice);
+        for (unsigned long i = 1; i <= n; i++) {
+            if (choice.implicit) {
+                unsigned int evaluations;
+                y = ImplicitStep(choice.order, y, t, h, f_y, evaluations);
+                if (evaluations == 0) {
+                    // reported once at the end of the integration
+                    ++result.newtonFailures;
+                }
+            } else {
+                y = ExplicitStep(choice.order, y, t, h, f_y);
+            }
+            t = i == n ? t_end : t_start + i*h;
+            f_y = RightHandSide(y, t);
+            ++result.acceptedSteps;
+            //pass the values to the sink
+            Output(sink, t, y);
+        }
+        if (!std::isfinite(y)) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef PCSC_PROJECT_AUTOSOLVER_H
+#define PCSC_PROJECT_AUTOSOLVER_H
+
+#include "AbstractImplicitSolver.h"
+#include "RKSolver.h"
+#include <vector>
+
+/** Method chosen by the AutoSolver for a window of steps.*/
+struct AutoSolverChoice {
+    /** beginning of the window*/
+    double time;
+    /** estimate of df/dy at the beginning of the window*/
+    double eigenvalue;
+    /** true for an implicit Adams Moulton method, false for an explicit Runge-Kutta method*/
+    bool implicit;
+    /** order of convergence of the method*/
+    unsigned int order;
+    double stepSize;
+};
+
+/** Daughter of Abstract Implicit Solver class.
+ * The automatic solver solves the initial value problem
+     * \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0 \f$
+     * without asking the user to choose the method: the integration is cut into windows of a few steps, and at the
+     * beginning of each window the solver estimates the stiffness \f$ \lambda = \partial f/\partial y \f$ (the
+     * dominant eigenvalue of the Jacobian, which is df/dy itself for a scalar equation), from dRightHandSide if it is
+     * set, or from a finite difference of f otherwise. <br>
+     * The candidates are the explicit Runge-Kutta methods of order 1 to the order of the solver (see RKSolver), and
+     * the A-stable Adams Moulton methods, backward Euler and the trapezoidal rule (see AdamsMoultonSolver). The local
+     * error constant of each candidate is measured by step doubling on a probe step, from which the step size keeping
+     * the local error per unit step below tolerance*(1 + |y|) is deduced. The step size of an explicit method is
+     * also limited by its stability interval \f$ h |\lambda| \leq R \f$ when \f$ \lambda < 0 \f$. The candidate
+     * with the smallest number of evaluations of f (and df) per unit time is used for the window. <br>
+     * The step size set with SetStepSize is the largest step size, and the order set with SetOrder is the largest
+     * order of the explicit methods, between 1 and 4. The choices are given by GetChoices.
+     */
+class AutoSolver : public AbstractImplicitSolver {
+public:
+    AutoSolver();
+    AutoSolver(double h, double t0, double t1, double y0, double (*f)(double y, double t), unsigned int s);
+    ~AutoSolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetTolerance(double tol);
+    void SetCheckInterval(unsigned int steps);
+    double GetTolerance() const { return tolerance; }
+    unsigned int GetCheckInterval() const { return checkInterval; }
+    const std::vector<AutoSolverChoice> &GetChoices() const { return choices; }
+
+    double EstimateEigenvalue(double y, double t, double f_y) const;
+    double ExplicitStep(unsigned int order, double y, double t, double h, double f_y) const;
+    double ImplicitStep(unsigned int order, double y, double t, double h, double f_y,
+                        unsigned int &evaluations) const;
+
+private:
+    AutoSolverChoice Choose(double y, double t, double f_y, double h_previous) const;
+    double tolerance;
+    unsigned int checkInterval;
+    // coefficients of the explicit methods of order p: a[p-1][j][l] and c[p-1][j], as in RKSolver, the weights being
+    // the rows of b
+    double a[max_rk_order][max_rk_order][max_rk_order];
+    double c[max_rk_order][max_rk_order];
+    // weights of the trapezoidal rule, of the explicit and implicit values
+    double trapezoidal[2];
+    std::vector<AutoSolverChoice> choices;
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    bool SupportsSensitivity(const ForwardSensitivity &) const override { return false; }
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_AUTOSOLVER_H
@@ -0,0 +1,431 @@
+#include "CompressedOutputSink.h"
+#include "FileNotOpenException.hpp"
+#include <cmath>
+#include <cstring>
+
+const char CompressedOutputSink::magic[8] = {'O', 'D', 'E', 'Z', 'T', 'R', 'J', '1'};
+
+namespace {
+    // flags of a block
+    const uint8_t uniformTimes = 1;
+    const uint8_t quantizedValues = 2;
+
+    uint64_t Bits(double x) {
+        uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return bits;
+    }
+
+    double FromBits(uint64_t bits) {
+        double x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+
+    // linear extrapolation of the next value. 2*x is exact, so the prediction is rounded once and the encoder and
+    // the decoder always find the same one, even if the compiler contracts it into a fused multiply-add.
+    double Predict(const double *previous, size_t i) {
+        if (i == 0) {
+            return 0.;
+        } else if (i == 1) {
+            return previous[0];
+        }
+        return 2*previous[i-1] - previous[i-2];
+    }
+
+    template <class T>
+    void Append(std::vector<uint8_t> &bytes, T value) {
+        const size_t size = bytes.size();
+        bytes.resize(size + sizeof(T));
+        std::memcpy(bytes.data() + size, &value, sizeof(T));
+    }
+
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t> &bytes) : bytes(bytes), current(0), used(0) {}
+        void Put(uint64_t value, unsigned int n) {
+            // the n lowest bits of value, highest first
+            for (int i = static_cast<int>(n) - 1; i >= 0; i--) {
+                current = static_cast<uint8_t>((current << 1) | ((value >> i) & 1));
+                if (++used == 8) {
+                    bytes.push_back(current);
+                    current = 0;
+                    used = 0;
+                }
+            }
+        }
+        void Align() {
+            if (used > 0) {
+                bytes.push_back(static_cast<uint8_t>(current << (8 - used)));
+                current = 0;
+                used = 0;
+            }
+        }
+    private:
+        std::vector<uint8_t> &bytes;
+        uint8_t current;
+        unsigned int used;
+    };
+
+    class BitReader {
+    public:
+        BitReader(const std::vector<uint8_t> &bytes, size_t position) : bytes(bytes), position(position), used(0) {}
+        uint64_t Get(unsigned int n) {
+            uint64_t value = 0;
+            for (unsigned int i = 0; i < n; i++) {
+                if (position >= bytes.size()) {
+                    throw FileNotOpenException("The compressed trajectory is truncated.");
+                }
+                value = (value << 1) | ((bytes[position] >> (7 - used)) & 1);
+                if (++used == 8) {
+                    position++;
+                    used = 0;
+                }
+            }
+            return value;
+        }
+        size_t Align() {
+            if (used > 0) {
+                position++;
+                used = 0;
+            }
+            return position;
+        }
+    private:
+        const std::vector<uint8_t> &bytes;
+        size_t position;
+        unsigned int used;
+    };
+
+    void EncodeXor(const std::vector<double> &x, std::vector<uint8_t> &bytes) {
+        // Gorilla-like: a 0 bit if the value is its prediction, otherwise the meaningful bits of the XOR, reusing
+        // the leading and trailing zeros of the previous XOR when they fit.
+        BitWriter writer(bytes);
+        unsigned int leading = 64;
+        unsigned int trailing = 0;
+        for (size_t i = 0; i < x.size(); i++) {
+            const uint64_t delta = Bits(x[i]) ^ Bits(Predict(x.data(), i));
+            if (delta == 0) {
+                writer.Put(0, 1);
+                continue;
+            }
+            writer.Put(1, 1);
+            const unsigned int lz = __builtin_clzll(delta);
+            const unsigned int tz = __builtin_ctzll(delta);
+            if (leading < 64 && lz >= leading && tz >= trailing) {
+                writer.Put(0, 1);
+                writer.Put(delta >> trailing, 64 - leading - trailing);
+            } else {
+                leading = lz;
+                trailing = tz;
+                writer.Put(1, 1);
+                writer.Put(leading, 6);
+                writer.Put(63 - leading - trailing, 6); // number of meaningful bits - 1
+                writer.Put(delta >> trailing, 64 - leading - trailing);
+            }
+        }
+        writer.Align();
+    }
+
+    size_t DecodeXor(const std::vector<uint8_t> &bytes, size_t position, uint32_t count, std::vector<double> &x) {
+        BitReader reader(bytes, position);
+        const size_t first = x.size();
+        unsigned int leading = 64;
+        unsigned int trailing = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t delta = 0;
+            if (reader.Get(1) == 1) {
+                if (reader.Get(1) == 1) {
+                    leading = static_cast<unsigned int>(reader.Get(6));
+                    trailing = 63 - leading - static_cast<unsigned int>(reader.Get(6));
+                } else if (leading == 64) {
+                    throw FileNotOpenException("The compressed trajectory is corrupted.");
+                }
+                delta = reader.Get(64 - leading - trailing) << trailing;
+            }
+            x.push_back(FromBits(Bits(Predict(x.data() + first, i)) ^ delta));
+        }
+        return reader.Align();
+    }
+
+    int64_t SecondDifference(const std::vector<int64_t> &q, uint32_t i) {
+        if (i == 0) {
+            return q[0];
+        } else if (i == 1) {
+            return q[1] - q[0];
+        }
+        return q[i] - (2*q[i-1] - q[i-2]);
+    }
+
+    uint64_t Zigzag(int64_t r) {
+        // small negative and positive integers are mapped to small unsigned integers
+        return (static_cast<uint64_t>(r) << 1) ^ static_cast<uint64_t>(r >> 63);
+    }
+
+    void AppendVarint(std::vector<uint8_t> &bytes, uint64_t z) {
+        while (z >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(z | 0x80));
+            z >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(z));
+    }
+
+    uint64_t ReadVarint(const std::vector<uint8_t> &bytes, size_t &position, const std::string &filename) {
+        uint64_t z = 0;
+        for (unsigned int shift = 0; ; shift += 7) {
+            if (position >= bytes.size() || shift > 63) {
+                throw FileNotOpenException("File " + filename + " is corrupted.");
+            }
+            const uint8_t byte = bytes[position++];
+            z |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return z;
+            }
+        }
+    }
+
+    bool Quantize(const std::vector<double> &x, double quantum, std::vector<int64_t> &q) {
+        // false if a value cannot be represented by an integer multiple of the quantum
+        q.resize(x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            const double scaled = x[i]/quantum;
+            if (!(std::abs(scaled) < 4503599627370496.)) { // 2^52, also rejects nan
+                return false;
+            }
+            q[i] = std::llround(scaled);
+        }
+        return true;
+    }
+}
+
+CompressedOutputSink::CompressedOutputSink(const std::string &filename, double quantum, unsigned int blockSize)
+    /**
+    * Constructor creating the file and starting the worker thread.
+    * \param filename: name of the compressed file
+    * \param quantum: maximal error is quantum/2 if quantum > 0, the compression is without loss if quantum = 0
+    * \param blockSize: number of records per block
+    */
+    : filename(filename), file(filename, std::ios::out | std::ios::binary), quantum(quantum > 0 ? quantum : 0.),
+      blockSize(blockSize > 0 ? blockSize : 1), hasPending(false), closed(false) {
+    if (!file.is_open()) {
+        throw FileNotOpenException("File " + filename + " can't be opened.");
+    }
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char *>(&this->quantum), sizeof(double));
+    times.reserve(this->blockSize);
+    values.reserve(this->blockSize);
+    worker = std::thread(&CompressedOutputSink::Run, this);
+}
+
+CompressedOutputSink::~CompressedOutputSink() {
+    Close();
+}
+
+void CompressedOutputSink::Flush() {
+    /*! Write the records of the incomplete block, and wait until all the blocks are written to the file
+    */
+    if (!worker.joinable()) {
+        return;
+    }
+    if (!times.empty()) {
+        SubmitBlock();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    producerCv.wait(lock, [this] { return !hasPending; });
+    file.flush();
+}
+
+void CompressedOutputSink::Close() {
+    /*! Write the remaining records, stop the worker thread and close the file
+    */
+    if (!worker.joinable()) {
+        return;
+    }
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    workerCv.notify_one();
+    worker.join();
+    file.close();
+}
+
+void CompressedOutputSink::SubmitBlock() {
+    /*! Hand the current block to the worker thread, once it has finished the previous one
+    */
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        producerCv.wait(lock, [this] { return !hasPending; });
+        std::swap(times, pendingTimes);
+        std::swap(values, pendingValues);
+        hasPending = true;
+    }
+    workerCv.notify_one();
+    times.clear();
+    values.clear();
+    times.reserve(blockSize);
+    values.reserve(blockSize);
+}
+
+void CompressedOutputSink::Run() {
+    /*! Loop of the worker thread: encode and write the blocks submitted by the solver
+    */
+    std::vector<uint8_t> block;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workerCv.wait(lock, [this] { return hasPending || closed; });
+            if (!hasPending) {
+                return;
+            }
+        }
+        // the pending block is not touched by the solver until hasPending is reset
+        block.clear();
+        EncodeBlock(pendingTimes, pendingValues, quantum, block);
+        file.write(reinterpret_cast<const char *>(block.data()), block.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            hasPending = false;
+        }
+        producerCv.notify_all();
+    }
+}
+
+void CompressedOutputSink::EncodeBlock(const std::vector<double> &times, const std::vector<double> &values,
+                                       double quantum, std::vector<uint8_t> &block) {
+    /*! Encode a block: its size in bytes, the number of records, the flags, the times and the values
+    * \param times: times of the records
+    * \param values: values of the records
+    * \param quantum: quantum of the values, 0 for a compression without loss
+    * \param block: bytes of the encoded block
+    */
+    const uint32_t count = times.size();
+    Append<uint32_t>(block, 0); // size, set at the end
+    Append<uint32_t>(block, count);
+    const size_t flags_position = block.size();
+    Append<uint8_t>(block, 0);
+    uint8_t flags = 0;
+
+    // a uniform time grid is stored as t0 and h if t += h rebuilds every time exactly
+    const double t0 = times[0];
+    const double h = count > 1 ? times[1] - times[0] : 0.;
+    bool uniform = true;
+    double t = t0;
+    for (uint32_t i = 0; i < count && uniform; i++) {
+        uniform = Bits(t) == Bits(times[i]);
+        t += h;
+    }
+    if (uniform) {
+        flags |= uniformTimes;
+        Append(block, t0);
+        Append(block, h);
+    } else {
+        EncodeXor(times, block);
+    }
+
+    std::vector<int64_t> q;
+    if (quantum > 0 && Quantize(values, quantum, q)) {
+        flags |= quantizedValues;
+        // second differences of the integers, zigzag encoded and written with 7 bits per byte. A zero is followed
+        // by the number of zeros after it.
+        uint32_t i = 0;
+        while (i < count) {
+            const uint64_t z = Zigzag(SecondDifference(q, i));
+            AppendVarint(block, z);
+            i++;
+            if (z == 0) {
+                uint32_t run = 0;
+                while (i < count && SecondDifference(q, i) == 0) {
+                    run++;
+                    i++;
+                }
+                AppendVarint(block, run);
+            }
+        }
+    } else {
+        EncodeXor(values, block);
+    }
+
+    block[flags_position] = flags;
+    const uint32_t size = block.size() - sizeof(uint32_t);
+    std::memcpy(block.data(), &size, sizeof(size));
+}
+
+Trajectory CompressedOutputSink::Read(const std::string &filename) {
+    /*! Read a file written by CompressedOutputSink
+    * \param filename: name of the compressed file
+    * \return The records of the file
+    */
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    char header[sizeof(magic)];
+    double quantum;
+    if (!file.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0
+        || !file.read(reinterpret_cast<char *>(&quantum), sizeof(quantum))) {
+        throw FileNotOpenException("File " + filename + " is not a compressed trajectory.");
+    }
+    Trajectory trajectory;
+    std::vector<uint8_t> block;
+    std::vector<double> times;
+    std::vector<double> values;
+    uint32_t size;
+    while (file.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+        block.resize(size);
+        if (size < sizeof(uint32_t) + 1 || !file.read(reinterpret_cast<char *>(block.data()), size)) {
+            throw FileNotOpenException("File " + filename + " is truncated.");
+        }
+        uint32_t count;
+        std::memcpy(&count, block.data(), sizeof(count));
+        const uint8_t flags = block[sizeof(count)];
+        size_t position = sizeof(count) + 1;
+        times.clear();
+        values.clear();
+        if (flags & uniformTimes) {
+            if (position + 2*sizeof(double) > block.size()) {
+                throw FileNotOpenException("File " + filename + " is corrupted.");
+            }
+            double t, h;
+            std::memcpy(&t, block.data() + position, sizeof(double));
+            std::memcpy(&h, block.data() + position + sizeof(double), sizeof(double));
+            position += 2*sizeof(double);
+            for (uint32_t i = 0; i < count; i++) {
+                times.push_back(t);
+                t += h;
+            }
+        } else {
+            position = DecodeXor(block, position, count, times);
+        }
+        if (flags & quantizedValues) {
+            int64_t previous = 0;
+            int64_t before_previous = 0;
+            uint64_t zeros = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                int64_t r = 0;
+                if (zeros > 0) {
+                    zeros--;
+                } else {
+                    const uint64_t z = ReadVarint(block, position, filename);
+                    if (z == 0) {
+                        zeros = ReadVarint(block, position, filename);
+                    }
+                    r = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+                }
+                int64_t q = r;
+                if (i == 1) {
+                    q += previous;
+                } else if (i > 1) {
+                    q += 2*previous - before_previous;
+                }
+                before_previous = previous;
+                previous = q;
+                values.push_back(q*quantum);
+            }
+        } else {
+            DecodeXor(block, position, count, values);
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            trajectory.Write(times[i], values[i]);
+        }
+    }
+    return trajectory;
+}
@@ -0,0 +1,74 @@
+#ifndef PCSC_PROJECT_COMPRESSEDOUTPUTSINK_H
+#define PCSC_PROJECT_COMPRESSEDOUTPUTSINK_H
+
+#include "AbstractOutputSink.h"
+#include "Trajectory.h"
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Daughter of AbstractOutputSink. Writes the records in a compressed binary file, for long runs where the text
+ * output is mostly redundant. <br>
+ * The records are grouped in blocks, which are encoded and written by a worker thread while the solver fills the
+ * next block. In each block: <br>
+ * - the times of a fixed step size solver are not stored: only t0 and h are, the times being rebuilt exactly with
+ * t += h. Other times (adaptive solvers) are compressed like the values; <br>
+ * - the values are compressed without loss by storing the XOR of each value with its linear prediction from the two
+ * previous ones (Gorilla-like encoding): the bits shared with the prediction are not stored; <br>
+ * - or, if a quantum q > 0 is given, the values are rounded to multiples of q (the error is at most q/2) and the
+ * second differences of the integers are stored with a variable number of bytes. <br>
+ * The file starts with the magic string "ODEZTRJ1" and the quantum, followed by the blocks. Read gives back the
+ * records as a Trajectory.
+ */
+class CompressedOutputSink : public AbstractOutputSink {
+public:
+    explicit CompressedOutputSink(const std::string &filename, double quantum = 0., unsigned int blockSize = 4096);
+    ~CompressedOutputSink() override;
+
+    void Write(double t, double y) override {
+        times.push_back(t);
+        values.push_back(y);
+        if (times.size() == blockSize) {
+            SubmitBlock();
+        }
+    }
+    void Flush() override;
+    void Close();
+
+    double GetQuantum() const { return quantum; }
+
+    static Trajectory Read(const std::string &filename);
+    static const char magic[8];
+
+private:
+    void SubmitBlock();
+    void Run();
+    static void EncodeBlock(const std::vector<double> &times, const std::vector<double> &values, double quantum,
+                            std::vector<uint8_t> &block);
+
+    std::string filename;
+    std::ofstream file;
+    const double quantum;
+    const unsigned int blockSize;
+
+    // block filled by the solver
+    std::vector<double> times;
+    std::vector<double> values;
+    // block handed to the worker thread
+    std::vector<double> pendingTimes;
+    std::vector<double> pendingValues;
+    bool hasPending;
+    bool busy;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable workerCv;
+    std::condition_variable producerCv;
+    std::thread worker;
+};
+
+
+#endif //PCSC_PROJECT_COMPRESSEDOUTPUTSINK_H
@@ -0,0 +1,24 @@
+#include "ConsoleDiagnosticSink.h"
+#include <iostream>
+
+ConsoleDiagnosticSink &ConsoleDiagnosticSink::Instance() {
+    /*!
+    * \return The sink shared by all the solvers printing on the console
+    */
+    static ConsoleDiagnosticSink instance;
+    return instance;
+}
+
+void ConsoleDiagnosticSink::Report(const std::string &tag, const std::string &problem, const std::string &action) {
+    /*! Print the problem and the action taken
+    * \param tag: tag of the exception
+    * \param problem: problem of the exception
+    * \param action: action taken by the solver, not printed if empty
+    */
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cerr << "** Error (" << tag << ") **\n";
+    std::cerr << "Problem: " << problem << "\n\n";
+    if (!action.empty()) {
+        std::cout << action << std::endl;
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef PCSC_PROJECT_CONSOLEDIAGNOSTICSINK_H
+#define PCSC_PROJECT_CONSOLEDIAGNOSTICSINK_H
+
+#include "AbstractDiagnosticSink.h"
+#include <mutex>
+
+/** Daughter of AbstractDiagnosticSink. Prints the problems on the console, the exception on std::cerr as
+ * Exception::PrintDebug does, and the action on std::cout. <br>
+ * It is the default sink of the solvers. A single instance is shared by the whole process: a mutex keeps the
+ * messages of solvers running on different threads from being interleaved.
+ */
+class ConsoleDiagnosticSink : public AbstractDiagnosticSink {
+public:
+    static ConsoleDiagnosticSink &Instance();
+    void Report(const std::string &tag, const std::string &problem, const std::string &action) override;
+
+private:
+    ConsoleDiagnosticSink() = default;
+    std::mutex mutex;
+};
+
+
+#endif //PCSC_PROJECT_CONSOLEDIAGNOSTICSINK_H
@@ -0,0 +1,188 @@
+#include "DDESolver.h"
+#include "SetOrderException.h"
+#include "UncoherentValueException.h"
+
+#include <algorithm>
+#include <cmath>
+
+DDESolver::DDESolver() : AbstractExplicitSolver(), f_delayed(nullptr), history(nullptr), delay(1.) {
+    /**
+    Constructor of a DDE solver instance, of order 4 with a delay of 1 and a constant history.
+    */
+    SetRightHandSide(DelayedRightHandSide, this);
+    DDESolver::SetOrder(max_rk_order);
+}
+
+DDESolver::DDESolver(const double h, const double t0, const double t1, const double y0,
+                     double (*f)(double, double, double), const double tau, const unsigned int s)
+    : AbstractExplicitSolver(h, t0, t1, y0, nullptr, s), f_delayed(f), history(nullptr), delay(1.) {
+    /**
+    Constructor of a DDE solver instance, where each parameter are defined from outside the class. The history is
+     constant, equal to y0, unless it is set with SetHistory.
+    */
+    SetRightHandSide(DelayedRightHandSide, this);
+    SetDelay(tau);
+    DDESolver::SetOrder(s);
+}
+
+DDESolver::DDESolver(const DDESolver &other)
+    : AbstractExplicitSolver(other), f_delayed(other.f_delayed), history(other.history), delay(other.delay),
+      past(other.past) {
+    /**
+    Copy constructor: the right hand side of the copy interpolates in the history of the copy, not of other.
+    */
+    std::copy(&other.a[0][0], &other.a[0][0] + max_rk_order*max_rk_order, &a[0][0]);
+    std::copy(other.c, other.c + max_rk_order, c);
+    SetRightHandSide(DelayedRightHandSide, this);
+}
+
+DDESolver &DDESolver::operator=(const DDESolver &other) {
+    /**
+    Copy assignment, which keeps the right hand side bound to this instance.
+    */
+    AbstractExplicitSolver::operator=(other);
+    f_delayed = other.f_delayed;
+    history = other.history;
+    delay = other.delay;
+    past = other.past;
+    std::copy(&other.a[0][0], &other.a[0][0] + max_rk_order*max_rk_order, &a[0][0]);
+    std::copy(other.c, other.c + max_rk_order, c);
+    SetRightHandSide(DelayedRightHandSide, this);
+    return *this;
+}
+
+DDESolver::~DDESolver() = default;
+
+void DDESolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: order of the Runge-Kutta method, between 1 and 4
+*/
+    try {
+        if (order < 1 || order > max_rk_order) {
+            throw SetOrderException("The order of the DDE solver should be between 1 and 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 4.");
+        order = max_rk_order;
+    }
+    AbstractOdeSolver::SetOrder(order);
+    SetB();
+}
+
+void DDESolver::SetDelayedRightHandSide(double (*f)(double y, double y_delayed, double t)) {
+    /*! Set f(y(t), y(t - tau), t)
+    * \param f: function handle, called with the solution, the delayed solution and the time
+    */
+    f_delayed = f;
+}
+
+void DDESolver::SetDelay(double tau) {
+    /*! Set the constant delay
+    * \param tau: delay, strictly positive
+    */
+    try {
+        if (!(tau > 0)) {
+            throw UncoherentValueException("The delay must be strictly positive.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The delay is set to 1.");
+        tau = 1.;
+    }
+    delay = tau;
+}
+
+void DDESolver::SetB() {
+    /**
+   * Copy the coefficients of the Runge-Kutta method of the current order from the Runge-Kutta solver, the weights
+     of order p being in the row p-1 of b as in RKSolver.
+   *
+   */
+    RKSolver methods;
+    methods.SetOrder(GetOrder());
+    for (unsigned int j = 0; j < GetOrder(); j++) {
+        b[GetOrder()-1][j] = methods.GetB(GetOrder()-1, j);
+        c[j] = methods.GetC(GetOrder()-1, j);
+        for (unsigned int l = 0; l < j; l++) {
+            a[j][l] = methods.GetA(j, l);
+        }
+    }
+}
+
+std::vector<double> DDESolver::GetBreakpoints() const {
+    /*!
+    * \return The times t0 + k tau, k = 1, ..., order, before the final time, at which a derivative of order at most
+    * order+1 of the solution may be discontinuous
+    */
+    std::vector<double> breakpoints;
+    for (unsigned int k = 1; k <= GetOrder(); k++) {
+        const double t = GetInitialTime() + k*delay;
+        if (GetFinalTime() - t <= 1e-12*std::max(1., std::abs(t))) {
+            break;
+        }
+        breakpoints.push_back(t);
+    }
+    return breakpoints;
+}
+
+double DDESolver::DelayedValue(double t) const {
+    /*! Value of the solution in the past, given by the history before t0 and interpolated in the past steps after.
+    * Called at each stage: t is not checked.
+    * \param t: time, at most the time of the last step and not before its time minus the delay
+    * \return The value of the solution at time t
+    */
+    if (t <= GetInitialTime()) {
+        return history != nullptr ? history(t) : GetInitialValue();
+    }
+    // t + c h - tau may exceed the time of the last step by a rounding error when h = tau
+    return past.Evaluate(std::min(t, past.GetNewestTime()));
+}
+
+double DDESolver::DelayedRightHandSide(const double y, const double t, void *context) {
+    /*! Right hand side of the base class, so that the evaluations are counted as for the other solvers
+    * \param y: solution at time t
+    * \param t: time
+    * \param context: the solver
+    * \return f(y, y(t - tau), t)
+    */
+    const DDESolver &solver = *static_cast<const DDESolver *>(context);
+    return solver.f_delayed(y, solver.DelayedValue(t - solver.delay), t);
+}
+
+void DDESolver::Solve(AbstractOutputSink &sink) {
+    /*!
+    * Runge-Kutta methods for the scalar DDE in the form y'(t)=f(y(t),y(t-tau),t). The grid goes through the
+    * breakpoints, and each step is pushed to the history with the derivative at its end, which is also the first
+    * stage of the next step.
+    * \param sink: sink receiving the numerical solution at each time t
+    */
+    double y = GetInitialValue();
+    double t = GetInitialTime();
+    const unsigned int order = GetOrder();
+    const double h_max = std::min(GetStepSize(), delay);
+    // a window of length tau holds at most 2 tau/h_max + 3 steps: the steps between two stops are at least h_max/2
+    // long, but the last one
+    past.Reset(2*static_cast<size_t>(std::ceil(delay/h_max)) + 4);
+    std::vector<double> stops = GetBreakpoints();
+    stops.push_back(GetFinalTime());
+
+    Output(sink, t, y);
+    double k[max_order+1]; // k_0, k_1, ..., k_{order-1}
+    k[0] = RightHandSide(y, t);
+    past.Push(t, y, k[0]);
+    for (double stop : stops) {
+        const unsigned long n = static_cast<unsigned long>(std::ceil((stop - t)/h_max - 1e-9));
+        const double t_start = t;
+        const double h = (stop - t_start)/n;
+        for (unsigned long i = 1; i <= n; ++i) {
+            for (unsigned int j = 1; j < order; j++) {
+                k[j] = RightHandSide(y + h*ScalarProduct(j, k, a[j]), t + c[j]*h);
+            }
+            y += h*ProductWithB(k, order);
+            t = i == n ? stop : t_start + i*h;
+            k[0] = RightHandSide(y, t);
+            past.Push(t, y, k[0]);
+            //pass the values to the sink
+            Output(sink, t, y);
+        }
+    }
+}
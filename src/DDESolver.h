@@ -0,0 +1,58 @@
+#ifndef PCSC_PROJECT_DDESOLVER_H
+#define PCSC_PROJECT_DDESOLVER_H
+
+#include "AbstractExplicitSolver.h"
+#include "DelayHistory.h"
+#include "RKSolver.h"
+#include <vector>
+
+/** Daughter of Abstract Explicit Solver class.
+ * The DDE solver solves the delay differential equation with a constant delay \f$ \tau > 0 \f$
+     * \f$ \frac{dy}{dt} = f(y(t), y(t - \tau), t), \quad y(t) = \phi(t) \text{ for } t < t_0, \quad y(t_0) = y_0 \f$
+     * with the explicit Runge-Kutta methods of order 1 to 4 of the Runge-Kutta solver. The delayed values are
+     * interpolated in the past steps, kept in a DelayHistory whose capacity only depends on \f$ \tau/h \f$, and
+     * the history \f$ \phi \f$ is y0 unless it is set with SetHistory. <br>
+     * The step size is at most \f$ \tau \f$, so that the delayed values of a step are always known and no iteration
+     * is needed. <br>
+     * The derivative of the solution is in general discontinuous at \f$ t_0 \f$, and this discontinuity propagates:
+     * the derivative of order k+1 jumps at \f$ t_0 + k\tau \f$. A step across such a breakpoint loses the order of the
+     * method, so the breakpoints \f$ t_0 + k\tau \f$, \f$ k = 1, \dots, p \f$ of a method of order p are points of
+     * the grid: each interval between two of them is divided into equal steps of size at most h. After the last one,
+     * the solution is smooth enough and the steps are not shortened anymore.
+     */
+class DDESolver : public AbstractExplicitSolver {
+public:
+    DDESolver();
+    DDESolver(double h, double t0, double t1, double y0, double (*f)(double y, double y_delayed, double t),
+              double tau, unsigned int s);
+    DDESolver(const DDESolver &other);
+    DDESolver &operator=(const DDESolver &other);
+    ~DDESolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetDelayedRightHandSide(double (*f)(double y, double y_delayed, double t));
+    void SetDelay(double tau);
+    void SetHistory(double (*phi)(double t)) { history = phi; }
+    double GetDelay() const { return delay; }
+    std::vector<double> GetBreakpoints() const;
+    const DelayHistory &GetHistory() const { return past; }
+
+    double DelayedValue(double t) const;
+
+private:
+    static double DelayedRightHandSide(double y, double t, void *context);
+    double (*f_delayed)(double y, double y_delayed, double t);
+    double (*history)(double t);
+    double delay;
+    DelayHistory past;
+    // coefficients of the Runge-Kutta method of the current order, as in RKSolver
+    double a[max_rk_order][max_rk_order];
+    double c[max_rk_order];
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_DDESOLVER_H
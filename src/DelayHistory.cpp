@@ -0,0 +1,69 @@
+#include "DelayHistory.h"
+
+#include <algorithm>
+#include <cassert>
+
+DelayHistory::DelayHistory(const size_t capacity) : first(0), count(0) {
+    /**
+    Constructor of an empty history.
+    * \param capacity: number of records kept, at least 2
+    */
+    Reset(capacity);
+}
+
+void DelayHistory::Reset(const size_t capacity) {
+    /*! Remove all the records
+    * \param capacity: number of records kept from now on, at least 2
+    */
+    const size_t size = std::max(capacity, static_cast<size_t>(2));
+    times.assign(size, 0.);
+    values.assign(size, 0.);
+    derivatives.assign(size, 0.);
+    first = 0;
+    count = 0;
+}
+
+void DelayHistory::Push(const double t, const double y, const double dy) {
+    /*! Append a record, after the newest one. The oldest record is removed if the buffer is full.
+    * \param t: time, bigger than the time of the newest record
+    * \param y: solution at time t
+    * \param dy: derivative of the solution at time t, i.e. f evaluated at time t
+    */
+    assert(count == 0 || t > GetNewestTime());
+    size_t i;
+    if (count < times.size()) {
+        i = Index(count);
+        ++count;
+    } else {
+        i = first;
+        first = Index(1);
+    }
+    times[i] = t;
+    values[i] = y;
+    derivatives[i] = dy;
+}
+
+double DelayHistory::Evaluate(const double t) const {
+    /*! Value of the solution, interpolated between the two records around t. Called at each stage: t is not checked.
+    * \param t: time between GetOldestTime() and GetNewestTime()
+    * \return The cubic Hermite interpolant at time t
+    */
+    assert(count >= 2 && t >= GetOldestTime() && t <= GetNewestTime());
+    // binary search of the last record at or before t, without the newest one
+    size_t low = 0;
+    size_t high = count - 1;
+    while (high - low > 1) {
+        const size_t middle = (low + high)/2;
+        if (times[Index(middle)] <= t) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    const size_t a = Index(low);
+    const size_t b = Index(low + 1);
+    const double h = times[b] - times[a];
+    const double s = (t - times[a])/h;
+    const double r = 1 - s;
+    return r*r*((1 + 2*s)*values[a] + s*h*derivatives[a]) + s*s*((3 - 2*s)*values[b] - r*h*derivatives[b]);
+}
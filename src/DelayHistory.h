@@ -0,0 +1,41 @@
+#ifndef PCSC_PROJECT_DELAYHISTORY_H
+#define PCSC_PROJECT_DELAYHISTORY_H
+
+#include <cstddef>
+#include <vector>
+
+/** Past values of the solution of a delay differential equation, kept in a circular buffer of fixed capacity. <br>
+ * Each record is a point (t, y, y') of the numerical solution, pushed in increasing order of time. When the buffer
+ * is full, a new record replaces the oldest one, so that the memory does not grow with the length of the
+ * integration. <br>
+ * Between two records, the solution is the cubic Hermite interpolant of the values and derivatives at both ends,
+ * which is the dense output of the step: its error is O(h^4), enough for the delayed values of methods up to
+ * order 4.
+ */
+class DelayHistory {
+public:
+    explicit DelayHistory(size_t capacity = 2);
+
+    void Reset(size_t capacity);
+    void Push(double t, double y, double dy);
+    double Evaluate(double t) const;
+
+    size_t Size() const { return count; }
+    size_t GetCapacity() const { return times.size(); }
+    /** Time of the oldest record, the beginning of the interval on which Evaluate can be called.*/
+    double GetOldestTime() const { return times[first]; }
+    /** Time of the newest record, the end of the interval on which Evaluate can be called.*/
+    double GetNewestTime() const { return times[Index(count - 1)]; }
+
+private:
+    /** Position in the buffer of the record i, 0 being the oldest one.*/
+    size_t Index(size_t i) const { return (first + i) % times.size(); }
+    std::vector<double> times;
+    std::vector<double> values;
+    std::vector<double> derivatives;
+    size_t first;
+    size_t count;
+};
+
+
+#endif //PCSC_PROJECT_DELAYHISTORY_H
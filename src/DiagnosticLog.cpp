@@ -0,0 +1,29 @@
+#include "DiagnosticLog.h"
+
+void DiagnosticLog::Report(const std::string &tag, const std::string &problem, const std::string &action) {
+    /*! Store the problem and the action taken
+    * \param tag: tag of the exception
+    * \param problem: problem of the exception
+    * \param action: action taken by the solver
+    */
+    std::lock_guard<std::mutex> lock(mutex);
+    diagnostics.push_back({tag, problem, action});
+}
+
+std::vector<Diagnostic> DiagnosticLog::GetDiagnostics() const {
+    /*!
+    * \return A copy of the problems reported so far
+    */
+    std::lock_guard<std::mutex> lock(mutex);
+    return diagnostics;
+}
+
+size_t DiagnosticLog::Size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return diagnostics.size();
+}
+
+void DiagnosticLog::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    diagnostics.clear();
+}
@@ -0,0 +1,33 @@
+#ifndef PCSC_PROJECT_DIAGNOSTICLOG_H
+#define PCSC_PROJECT_DIAGNOSTICLOG_H
+
+#include "AbstractDiagnosticSink.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** Problem reported by a solver.*/
+struct Diagnostic {
+    std::string tag;
+    std::string problem;
+    std::string action;
+};
+
+/** Daughter of AbstractDiagnosticSink. Keeps the problems in memory instead of printing them, e.g. for a solver
+ * running on a worker thread. The log is thread safe and can be shared by several solvers.
+ */
+class DiagnosticLog : public AbstractDiagnosticSink {
+public:
+    void Report(const std::string &tag, const std::string &problem, const std::string &action) override;
+
+    std::vector<Diagnostic> GetDiagnostics() const;
+    size_t Size() const;
+    void Clear();
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Diagnostic> diagnostics;
+};
+
+
+#endif //PCSC_PROJECT_DIAGNOSTICLOG_H
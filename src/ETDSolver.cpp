@@ -0,0 +1,184 @@
+#include "ETDSolver.h"
+#include "SetOrderException.h"
+
+#include <cassert>
+#include <cmath>
+
+ETDSolver::ETDSolver() : AbstractExplicitSolver(), linearPart(0.) {
+    /**
+    Constructor of an exponential time-differencing solver instance. The linear part is set to 0.
+    */
+    ETDSolver::SetOrder(1);
+}
+
+ETDSolver::ETDSolver(const double h, const double t0, const double t1, const double y0, const double L,
+                     double (*N)(double, double), const unsigned int s) : AbstractExplicitSolver(h,t0,t1,y0,N,s),
+                     linearPart(L) {
+    /**
+    Constructor of an exponential time-differencing solver instance, where each parameter are defined from outside
+     the class. The right hand side N is the nonlinear part of the equation and L its linear coefficient.
+    */
+    ETDSolver::SetOrder(s);
+}
+
+ETDSolver::~ETDSolver() = default;
+
+void ETDSolver::SetLinearPart(const double L) {
+    /*! Set the linear coefficient L of the right hand side L*y + N(y,t)
+    * \param L: linear coefficient
+    */
+    linearPart = L;
+}
+
+void ETDSolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: order that will be set for the ETD method.
+*/
+    try {
+        if(order < 1) {
+            throw SetOrderException("Order of the ETD solver should be bigger or equal to 1.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 1. ");
+        order = 1;
+    }
+    try {
+        if (order > 4) {
+            throw SetOrderException("Order of the ETD solver should be smaller or equal to 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "the order is set to the maximum order : 4.");
+        order = 4;
+    }
+    AbstractOdeSolver::SetOrder(order);
+    SetB();
+}
+
+void ETDSolver::SetB() {
+    /**
+   * Set the matrix B of coefficients weighting the evaluations of the nonlinear part in the limit L = 0.
+     The actual weights of a step are obtained by replacing these coefficients with combinations of
+     the functions phi_k(hL), see ETDSolver::SolveEquation. <br>
+     order = 1: ETD1 <br>
+     order = 2: ETD2RK <br>
+     order = 3: ETD3RK <br>
+     order = 4: ETDRK4 <br>
+   *
+   */
+    // s = 1: ETD1
+    b[0][0] = 1.;
+    // s = 2: ETD2RK
+    b[1][0] = 1./2;
+    b[1][1] = 1./2;
+    // s = 3: ETD3RK
+    b[2][0] = 1./6;
+    b[2][1] = 2./3;
+    b[2][2] = 1./6;
+    // s = 4: ETDRK4
+    b[3][0] = 1./6;
+    b[3][1] = 1./3;
+    b[3][2] = 1./3;
+    b[3][3] = 1./6;
+}
+
+double ETDSolver::Phi(const unsigned int k, const double z) {
+    /*! Stable evaluation of \f$ \varphi_k(z) = \sum_{m \geq 0} \frac{z^m}{(m+k)!} \f$.
+    * For small |z|, the closed form suffers from cancellation, hence the Taylor series is used. Otherwise, the
+    * recurrence \f$ \varphi_{k}(z) = (\varphi_{k-1}(z) - 1/(k-1)!)/z \f$ is used, starting from \f$ \varphi_1 \f$
+    * computed with expm1.
+    * \param k: index of the function
+    * \param z: argument, typically h*L
+    * \return value of phi_k at z
+    */
+    if (std::abs(z) < 1.) {
+        // Taylor series: the terms decrease at least as 1/(m+k)!, 30 terms are far below machine precision.
+        double term = 1.;
+        for (unsigned int i = 2; i <= k; i++) {
+            term /= i;
+        }
+        double sum = term;
+        for (unsigned int m = 1; m < 30; m++) {
+            term *= z/(m+k);
+            sum += term;
+        }
+        return sum;
+    }
+    if (k == 0) {
+        return std::exp(z);
+    }
+    double phi = std::expm1(z)/z;
+    double factorial = 1.;
+    for (unsigned int i = 2; i <= k; i++) {
+        factorial *= i-1;
+        phi = (phi - 1./factorial)/z;
+    }
+    return phi;
+}
+
+void ETDSolver::Solve(AbstractOutputSink &sink) {
+    /*!
+   * Exponential time-differencing methods for the scalar ODE in the form y'(t) = L*y + N(y,t).
+
+   * \param sink: sink receiving the numerical solution at each time t
+   */
+
+    double y = GetInitialValue();
+    double t = GetInitialTime();
+    double h = GetStepSize();
+    unsigned int order = GetOrder();
+    assert(h > 1e-6);
+
+    int n = static_cast<int>(std::floor((GetFinalTime() - GetInitialTime()) / h));
+    sink.Reserve(n + 1);
+
+    // the exponentials and phi functions only depend on z = hL, so they are computed once.
+    const double z = h*linearPart;
+    const double exp_z = std::exp(z);
+    const double exp_half_z = std::exp(z/2);
+    const double phi1 = Phi(1, z);
+    const double phi2 = Phi(2, z);
+    const double phi3 = Phi(3, z);
+    const double phi1_half = Phi(1, z/2);
+    // weights of the third and fourth order methods
+    const double f1 = phi1 - 3*phi2 + 4*phi3;
+    const double f2 = phi2 - 2*phi3;
+    const double f3 = -phi2 + 4*phi3;
+
+    Output(sink, t, y);
+    for (int i = 1; i <= n; ++i) {
+        double N_y = RightHandSide(y, t);
+        switch (order) {
+            case 1: { // ETD1
+                y = exp_z*y + h*phi1*N_y;
+                break;
+            }
+            case 2: { // ETD2RK
+                double y_a = exp_z*y + h*phi1*N_y;
+                double N_a = RightHandSide(y_a, t + h);
+                y = y_a + h*phi2*(N_a - N_y);
+                break;
+            }
+            case 3: { // ETD3RK
+                double y_a = exp_half_z*y + h/2*phi1_half*N_y;
+                double N_a = RightHandSide(y_a, t + h/2);
+                double y_b = exp_z*y + h*phi1*(2*N_a - N_y);
+                double N_b = RightHandSide(y_b, t + h);
+                y = exp_z*y + h*(f1*N_y + 4*f2*N_a + f3*N_b);
+                break;
+            }
+            default: { // ETDRK4
+                double y_a = exp_half_z*y + h/2*phi1_half*N_y;
+                double N_a = RightHandSide(y_a, t + h/2);
+                double y_b = exp_half_z*y + h/2*phi1_half*N_a;
+                double N_b = RightHandSide(y_b, t + h/2);
+                double y_c = exp_half_z*y_a + h/2*phi1_half*(2*N_b - N_y);
+                double N_c = RightHandSide(y_c, t + h);
+                y = exp_z*y + h*(f1*N_y + 2*f2*(N_a + N_b) + f3*N_c);
+                break;
+            }
+        }
+        t += h;
+        //pass the values to the sink
+        Output(sink, t, y);
+    }
+}
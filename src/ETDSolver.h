@@ -0,0 +1,45 @@
+#ifndef PCSC_PROJECT_ETDSOLVER_H
+#define PCSC_PROJECT_ETDSOLVER_H
+
+#include "AbstractExplicitSolver.h"
+#include <fstream>
+
+/** Daughter of Abstract Explicit Solver class.
+ * The exponential time-differencing (ETD) solver is designed for semilinear problems of the form
+     * \f$ \frac{dy}{dt} = L y + N(y,t), \quad y(t_0) = y_0 \f$
+     * where the linear coefficient \f$ L \f$ is given separately from the nonlinear part \f$ N \f$.
+     * The linear part is integrated exactly, so that the step size is only limited by the nonlinear dynamics.
+     * The right hand side of the solver is the nonlinear part \f$ N(y,t) \f$. <br>
+     * The updates are written with the functions
+     * \f$ \varphi_k(z) = \sum_{m \geq 0} \frac{z^m}{(m+k)!} \f$ evaluated at \f$ z = hL \f$. <br>
+     * The implemented methods with different order are: <br>
+     * order = 1: ETD1 (exponential Euler) <br>
+     * order = 2: ETD2RK (Cox and Matthews) <br>
+     * order = 3: ETD3RK (Cox and Matthews) <br>
+     * order = 4: ETDRK4 (Cox and Matthews) <br>
+     * For \f$ L = 0 \f$, these methods reduce to the Forward Euler, Heun, Kutta's third-order and the classic
+     * fourth-order Runge-Kutta methods.
+     */
+class ETDSolver : public AbstractExplicitSolver {
+public:
+    ETDSolver();
+    ETDSolver(double h, double t0, double t1, double y0, double L,
+              double (*N)(double y, double t), unsigned int s);
+    ~ETDSolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetLinearPart(double L);
+    double GetLinearPart() const { return linearPart; }
+
+    static double Phi(unsigned int k, double z);
+
+private:
+    double linearPart;
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_ETDSOLVER_H
@@ -17,6 +17,8 @@ private:
 public:
   Exception(std::string tagString, std::string problemString);
   void PrintDebug() const;
+  const std::string &GetTag() const { return mTag; }
+  const std::string &GetProblem() const { return mProblem; }
 };
 
 #endif // EXCEPTIONDEF
@@ -0,0 +1,638 @@
+#include "Expression.h"
+#include "ExpressionException.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+    void SkipBlanks(const std::string &s, size_t &pos) {
+        while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) {
+            ++pos;
+        }
+    }
+
+    std::string Where(size_t pos) {
+        return " (at character " + std::to_string(pos + 1) + ")";
+    }
+}
+
+Expression::Expression() : text("0"), root(-1), numberOfRegisters(0) {
+    /**
+    * Constructor of the expression 0.
+    */
+    root = MakeConstant(0.);
+    Compile();
+}
+
+Expression::Expression(const std::string &text, const std::map<std::string, double> &parameters) :
+        text(text), root(-1), numberOfRegisters(0) {
+    /**
+    * Constructor parsing and compiling the expression text.
+    * \param text: expression of y, t and the parameters
+    * \param parameters: names and values of the parameters used in text
+    */
+    for (const auto &parameter : parameters) {
+        parameterNames.push_back(parameter.first);
+        parameterValues.push_back(parameter.second);
+    }
+    size_t pos = 0;
+    root = ParseSum(text, pos);
+    SkipBlanks(text, pos);
+    if (pos != text.size()) {
+        throw ExpressionException("Unexpected '" + text.substr(pos, 1) + "'" + Where(pos) + " in " + text);
+    }
+    Compile();
+}
+
+void Expression::SetParameter(const std::string &name, const double value) {
+    /*! Set the value of a parameter, without compiling the expression again.
+    * \param name: name of the parameter
+    * \param value: new value of the parameter
+    */
+    for (unsigned int i = 0; i < parameterNames.size(); i++) {
+        if (parameterNames[i] == name) {
+            parameterValues[i] = value;
+            return;
+        }
+    }
+    throw ExpressionException("Unknown parameter " + name + " in " + text);
+}
+
+double Expression::GetParameter(const std::string &name) const {
+    /*!
+    * \param name: name of the parameter
+    * \return value of the parameter
+    */
+    for (unsigned int i = 0; i < parameterNames.size(); i++) {
+        if (parameterNames[i] == name) {
+            return parameterValues[i];
+        }
+    }
+    throw ExpressionException("Unknown parameter " + name + " in " + text);
+}
+
+bool Expression::IsConstant() const {
+    /*!
+    * \return true if the expression does not depend on y, t or the parameters.
+    */
+    return nodes[root].operation == Constant;
+}
+
+int Expression::ParseSum(const std::string &s, size_t &pos) {
+    // sum := product (('+' | '-') product)*
+    int node = ParseProduct(s, pos);
+    while (true) {
+        SkipBlanks(s, pos);
+        if (pos < s.size() && (s[pos] == '+' || s[pos] == '-')) {
+            Operation operation = (s[pos] == '+') ? Add : Subtract;
+            ++pos;
+            node = MakeNode(operation, node, ParseProduct(s, pos));
+        } else {
+            return node;
+        }
+    }
+}
+
+int Expression::ParseProduct(const std::string &s, size_t &pos) {
+    // product := unary (('*' | '/') unary)*
+    int node = ParseUnary(s, pos);
+    while (true) {
+        SkipBlanks(s, pos);
+        if (pos < s.size() && (s[pos] == '*' || s[pos] == '/')) {
+            Operation operation = (s[pos] == '*') ? Multiply : Divide;
+            ++pos;
+            node = MakeNode(operation, node, ParseUnary(s, pos));
+        } else {
+            return node;
+        }
+    }
+}
+
+int Expression::ParseUnary(const std::string &s, size_t &pos) {
+    // unary := ('-' | '+') unary | power
+    SkipBlanks(s, pos);
+    if (pos < s.size() && s[pos] == '-') {
+        ++pos;
+        return MakeNode(Negate, ParseUnary(s, pos));
+    }
+    if (pos < s.size() && s[pos] == '+') {
+        ++pos;
+        return ParseUnary(s, pos);
+    }
+    return ParsePower(s, pos);
+}
+
+int Expression::ParsePower(const std::string &s, size_t &pos) {
+    // power := primary ('^' unary)?, the power is right associative: 2^3^2 = 2^9
+    int node = ParsePrimary(s, pos);
+    SkipBlanks(s, pos);
+    if (pos < s.size() && s[pos] == '^') {
+        ++pos;
+        node = MakeNode(Power, node, ParseUnary(s, pos));
+    }
+    return node;
+}
+
+int Expression::ParsePrimary(const std::string &s, size_t &pos) {
+    // primary := number | variable | parameter | function '(' sum ')' | '(' sum ')'
+    SkipBlanks(s, pos);
+    if (pos >= s.size()) {
+        throw ExpressionException("Unexpected end of the expression " + s);
+    }
+    if (s[pos] == '(') {
+        ++pos;
+        int node = ParseSum(s, pos);
+        SkipBlanks(s, pos);
+        if (pos >= s.size() || s[pos] != ')') {
+            throw ExpressionException("Missing ')'" + Where(pos) + " in " + s);
+        }
+        ++pos;
+        return node;
+    }
+    if (std::isdigit(static_cast<unsigned char>(s[pos])) || s[pos] == '.') {
+        const char *begin = s.c_str() + pos;
+        char *end;
+        double value = std::strtod(begin, &end);
+        if (end == begin) {
+            throw ExpressionException("Invalid number" + Where(pos) + " in " + s);
+        }
+        pos += end - begin;
+        return MakeConstant(value);
+    }
+    if (std::isalpha(static_cast<unsigned char>(s[pos])) || s[pos] == '_') {
+        size_t begin = pos;
+        while (pos < s.size() && (std::isalnum(static_cast<unsigned char>(s[pos])) || s[pos] == '_')) {
+            ++pos;
+        }
+        std::string name = s.substr(begin, pos - begin);
+        SkipBlanks(s, pos);
+        if (pos < s.size() && s[pos] == '(') {
+            const std::map<std::string, Operation> functions = {
+                    {"sin", Sin}, {"cos", Cos}, {"tan", Tan}, {"asin", Asin}, {"acos", Acos}, {"atan", Atan},
+                    {"sinh", Sinh}, {"cosh", Cosh}, {"tanh", Tanh}, {"exp", Exp}, {"log", Log}, {"sqrt", Sqrt},
+                    {"abs", Abs}};
+            auto function = functions.find(name);
+            if (function == functions.end()) {
+                throw ExpressionException("Unknown function " + name + Where(begin) + " in " + s);
+            }
+            ++pos;
+            int argument = ParseSum(s, pos);
+            SkipBlanks(s, pos);
+            if (pos >= s.size() || s[pos] != ')') {
+                throw ExpressionException("Missing ')'" + Where(pos) + " in " + s);
+            }
+            ++pos;
+            return MakeNode(function->second, argument);
+        }
+        if (name == "y") {
+            return MakeNode(VariableY);
+        }
+        if (name == "t") {
+            return MakeNode(VariableT);
+        }
+        for (unsigned int i = 0; i < parameterNames.size(); i++) {
+            if (parameterNames[i] == name) {
+                return MakeNode(Parameter, -1, -1, i);
+            }
+        }
+        if (name == "pi") {
+            return MakeConstant(M_PI);
+        }
+        throw ExpressionException("Unknown variable " + name + Where(begin) + " in " + s);
+    }
+    throw ExpressionException("Unexpected '" + s.substr(pos, 1) + "'" + Where(pos) + " in " + s);
+}
+
+double Expression::Apply(const Operation operation, const double a, const double b) {
+    /*!
+    * \param operation: operation to apply
+    * \param a: first operand
+    * \param b: second operand, or constant value of the instruction
+    * \return result of the operation
+    */
+    switch (operation) {
+        case Add: return a + b;
+        case Subtract: return a - b;
+        case Multiply: return a * b;
+        case Divide: return a / b;
+        case Power: return std::pow(a, b);
+        case Negate: return -a;
+        case Sin: return std::sin(a);
+        case Cos: return std::cos(a);
+        case Tan: return std::tan(a);
+        case Asin: return std::asin(a);
+        case Acos: return std::acos(a);
+        case Atan: return std::atan(a);
+        case Sinh: return std::sinh(a);
+        case Cosh: return std::cosh(a);
+        case Tanh: return std::tanh(a);
+        case Exp: return std::exp(a);
+        case Log: return std::log(a);
+        case Sqrt: return std::sqrt(a);
+        case Abs: return std::abs(a);
+        case Sign: return (a > 0) - (a < 0);
+        case AddConstant: return a + b;
+        case MultiplyConstant: return a * b;
+        case ConstantMinus: return b - a;
+        case DivideByConstant: return a / b;
+        case ConstantDivide: return b / a;
+        case Square: return a * a;
+        default: return 0.;
+    }
+}
+
+int Expression::MakeNode(const Operation operation, int left, int right, const double value) {
+    /*!
+    * Add a node to the graph, after folding the constants and simplifying the neutral elements.
+    * If an identical node already exists, its index is returned instead.
+    * \return index of the node
+    */
+    auto is_constant = [&](int node, double c) {
+        return node >= 0 && nodes[node].operation == Constant && nodes[node].value == c;
+    };
+    bool binary = (operation >= Add && operation <= Power);
+    bool unary = (operation >= Negate && operation <= Sign);
+    if ((unary && nodes[left].operation == Constant)
+        || (binary && nodes[left].operation == Constant && nodes[right].operation == Constant)) {
+        double b = binary ? nodes[right].value : 0.;
+        return MakeConstant(Apply(operation, nodes[left].value, b));
+    }
+    switch (operation) {
+        case Add:
+            if (is_constant(left, 0.)) return right;
+            if (is_constant(right, 0.)) return left;
+            break;
+        case Subtract:
+            if (is_constant(right, 0.)) return left;
+            if (is_constant(left, 0.)) return MakeNode(Negate, right);
+            break;
+        case Multiply:
+            if (is_constant(left, 0.) || is_constant(right, 0.)) return MakeConstant(0.);
+            if (is_constant(left, 1.)) return right;
+            if (is_constant(right, 1.)) return left;
+            if (is_constant(left, -1.)) return MakeNode(Negate, right);
+            if (is_constant(right, -1.)) return MakeNode(Negate, left);
+            break;
+        case Divide:
+            if (is_constant(right, 1.)) return left;
+            if (is_constant(left, 0.)) return MakeConstant(0.);
+            break;
+        case Power:
+            if (is_constant(right, 1.)) return left;
+            if (is_constant(right, 0.)) return MakeConstant(1.);
+            break;
+        case Negate:
+            if (nodes[left].operation == Negate) return nodes[left].left;
+            break;
+        default:
+            break;
+    }
+    auto key = std::make_tuple(static_cast<int>(operation), left, right, value);
+    auto existing = nodeIndex.find(key);
+    if (existing != nodeIndex.end()) {
+        return existing->second;
+    }
+    nodes.push_back({operation, left, right, value});
+    nodeIndex[key] = nodes.size() - 1;
+    return nodes.size() - 1;
+}
+
+int Expression::Differentiate(const int node, const Operation variable, const int parameter,
+                              std::map<int, int> &derivatives) {
+    /*!
+    * Build the derivative of a node with the usual rules of differentiation.
+    * \param node: index of the node to differentiate
+    * \param variable: VariableY, VariableT or Parameter
+    * \param parameter: index of the parameter if variable is Parameter
+    * \param derivatives: derivatives of the nodes already differentiated, so that shared nodes are visited once
+    * \return index of the derivative
+    */
+    auto found = derivatives.find(node);
+    if (found != derivatives.end()) {
+        return found->second;
+    }
+    const Node n = nodes[node];
+    const int a = n.left;
+    const int b = n.right;
+    int da = -1;
+    int db = -1;
+    if (a >= 0) {
+        da = Differentiate(a, variable, parameter, derivatives);
+    }
+    if (b >= 0) {
+        db = Differentiate(b, variable, parameter, derivatives);
+    }
+    int d;
+    switch (n.operation) {
+        case Constant:
+            d = MakeConstant(0.);
+            break;
+        case VariableY:
+        case VariableT:
+            d = MakeConstant(n.operation == variable ? 1. : 0.);
+            break;
+        case Parameter:
+            d = MakeConstant((variable == Parameter && static_cast<int>(n.value) == parameter) ? 1. : 0.);
+            break;
+        case Add:
+            d = MakeNode(Add, da, db);
+            break;
+        case Subtract:
+            d = MakeNode(Subtract, da, db);
+            break;
+        case Multiply:
+            d = MakeNode(Add, MakeNode(Multiply, da, b), MakeNode(Multiply, a, db));
+            break;
+        case Divide:
+            // (a/b)' = a'/b - a*b'/b^2
+            d = MakeNode(Subtract, MakeNode(Divide, da, b),
+                         MakeNode(Divide, MakeNode(Multiply, a, db), MakeNode(Power, b, MakeConstant(2.))));
+            break;
+        case Power:
+            if (nodes[b].operation == Constant) {
+                // (a^c)' = c*a^(c-1)*a'
+                d = MakeNode(Multiply, MakeNode(Multiply, b, MakeNode(Power, a, MakeConstant(nodes[b].value - 1))), da);
+            } else {
+                // (a^b)' = a^b*(b'*log(a) + b*a'/a)
+                d = MakeNode(Multiply, node, MakeNode(Add, MakeNode(Multiply, db, MakeNode(Log, a)),
+                                                      MakeNode(Divide, MakeNode(Multiply, b, da), a)));
+            }
+            break;
+        case Negate:
+            d = MakeNode(Negate, da);
+            break;
+        case Sin:
+            d = MakeNode(Multiply, MakeNode(Cos, a), da);
+            break;
+        case Cos:
+            d = MakeNode(Negate, MakeNode(Multiply, MakeNode(Sin, a), da));
+            break;
+        case Tan:
+            d = MakeNode(Divide, da, MakeNode(Power, MakeNode(Cos, a), MakeConstant(2.)));
+            break;
+        case Asin:
+            d = MakeNode(Divide, da, MakeNode(Sqrt, MakeNode(Subtract, MakeConstant(1.),
+                                                           MakeNode(Power, a, MakeConstant(2.)))));
+            break;
+        case Acos:
+            d = MakeNode(Negate, MakeNode(Divide, da, MakeNode(Sqrt, MakeNode(Subtract, MakeConstant(1.),
+                                                                            MakeNode(Power, a, MakeConstant(2.))))));
+            break;
+        case Atan:
+            d = MakeNode(Divide, da, MakeNode(Add, MakeConstant(1.), MakeNode(Power, a, MakeConstant(2.))));
+            break;
+        case Sinh:
+            d = MakeNode(Multiply, MakeNode(Cosh, a), da);
+            break;
+        case Cosh:
+            d = MakeNode(Multiply, MakeNode(Sinh, a), da);
+            break;
+        case Tanh:
+            d = MakeNode(Multiply, MakeNode(Subtract, MakeConstant(1.), MakeNode(Power, node, MakeConstant(2.))), da);
+            break;
+        case Exp:
+            d = MakeNode(Multiply, node, da);
+            break;
+        case Log:
+            d = MakeNode(Divide, da, a);
+            break;
+        case Sqrt:
+            d = MakeNode(Divide, da, MakeNode(Multiply, MakeConstant(2.), node));
+            break;
+        case Abs:
+            // the derivative of abs(a) is the sign of a, taken as 0 at a = 0 so that it is finite
+            d = MakeNode(Multiply, MakeNode(Sign, a), da);
+            break;
+        default:
+            d = MakeConstant(0.);
+            break;
+    }
+    derivatives[node] = d;
+    return d;
+}
+
+Expression Expression::Derivative(const std::string &variable) const {
+    /*!
+    * \param variable: "y", "t" or the name of a parameter
+    * \return compiled expression of the derivative with respect to variable
+    */
+    Expression derivative(*this);
+    Operation operation = Parameter;
+    int parameter = -1;
+    if (variable == "y") {
+        operation = VariableY;
+    } else if (variable == "t") {
+        operation = VariableT;
+    } else {
+        for (unsigned int i = 0; i < parameterNames.size(); i++) {
+            if (parameterNames[i] == variable) {
+                parameter = i;
+            }
+        }
+        if (parameter < 0) {
+            throw ExpressionException("Unknown variable " + variable + " in " + text);
+        }
+    }
+    std::map<int, int> derivatives;
+    derivative.root = derivative.Differentiate(root, operation, parameter, derivatives);
+    derivative.text = "d(" + text + ")/d" + variable;
+    derivative.Compile();
+    return derivative;
+}
+
+void Expression::Compile() {
+    /*!
+    * Translate the expression graph into a list of instructions. Each node reachable from the root is computed once,
+    * and its register is released after its last use, so that the number of registers stays small.
+    * When an operand of an arithmetic operation is a constant, it is stored in the instruction itself.
+    */
+    instructions.clear();
+    numberOfRegisters = 0;
+
+    // operands of a node which need a register: the constant operand of an arithmetic operation is stored in the
+    // instruction, and x^2 is computed as x*x.
+    auto operands = [&](int node) {
+        const Node &n = nodes[node];
+        std::vector<int> result;
+        if (n.left < 0) {
+            return result;
+        }
+        if (n.right < 0) {
+            result.push_back(n.left);
+            return result;
+        }
+        bool left_constant = nodes[n.left].operation == Constant;
+        bool right_constant = nodes[n.right].operation == Constant;
+        if (n.operation == Power) {
+            result.push_back(n.left);
+            if (!(right_constant && nodes[n.right].value == 2.)) {
+                result.push_back(n.right);
+            }
+        } else if (left_constant) {
+            result.push_back(n.right);
+        } else if (right_constant) {
+            result.push_back(n.left);
+        } else {
+            result.push_back(n.left);
+            result.push_back(n.right);
+        }
+        return result;
+    };
+
+    // number of uses of each node, to know when its register can be released
+    std::vector<int> uses(nodes.size(), 0);
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<int> stack = {root};
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        if (visited[node]) {
+            continue;
+        }
+        visited[node] = true;
+        for (int operand : operands(node)) {
+            ++uses[operand];
+            stack.push_back(operand);
+        }
+    }
+
+    std::vector<int> registers(nodes.size(), -1);
+    std::vector<int> free_registers;
+    auto allocate = [&]() {
+        if (free_registers.empty()) {
+            return numberOfRegisters++;
+        }
+        int r = free_registers.back();
+        free_registers.pop_back();
+        return r;
+    };
+
+    // post-order traversal without recursion: a node is emitted once all its operands have a register
+    stack = {root};
+    while (!stack.empty()) {
+        int node = stack.back();
+        if (registers[node] >= 0) {
+            stack.pop_back();
+            continue;
+        }
+        std::vector<int> needed = operands(node);
+        bool ready = true;
+        for (int operand : needed) {
+            if (registers[operand] < 0) {
+                stack.push_back(operand);
+                ready = false;
+            }
+        }
+        if (!ready) {
+            continue;
+        }
+        stack.pop_back();
+
+        const Node &n = nodes[node];
+        Instruction instruction = {n.operation, -1, -1, -1, n.value};
+        if (n.left >= 0) {
+            instruction.left = registers[n.left];
+        }
+        if (n.right >= 0) {
+            instruction.right = registers[n.right];
+            bool left_constant = nodes[n.left].operation == Constant;
+            bool right_constant = nodes[n.right].operation == Constant;
+            double c = left_constant ? nodes[n.left].value : nodes[n.right].value;
+            int other = left_constant ? registers[n.right] : registers[n.left];
+            switch (n.operation) {
+                case Add:
+                    if (left_constant || right_constant) {
+                        instruction = {AddConstant, -1, other, -1, c};
+                    }
+                    break;
+                case Subtract:
+                    if (left_constant) {
+                        instruction = {ConstantMinus, -1, other, -1, c};
+                    } else if (right_constant) {
+                        // x - c = x + (-c) exactly
+                        instruction = {AddConstant, -1, other, -1, -c};
+                    }
+                    break;
+                case Multiply:
+                    if (left_constant || right_constant) {
+                        instruction = {MultiplyConstant, -1, other, -1, c};
+                    }
+                    break;
+                case Divide:
+                    if (left_constant) {
+                        instruction = {ConstantDivide, -1, other, -1, c};
+                    } else if (right_constant) {
+                        instruction = {DivideByConstant, -1, other, -1, c};
+                    }
+                    break;
+                case Power:
+                    if (right_constant && nodes[n.right].value == 2.) {
+                        instruction = {Square, -1, registers[n.left], -1, 0.};
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        for (int operand : needed) {
+            if (--uses[operand] == 0) {
+                free_registers.push_back(registers[operand]);
+            }
+        }
+        instruction.dest = allocate();
+        registers[node] = instruction.dest;
+        instructions.push_back(instruction);
+    }
+}
+
+double Expression::Evaluate(const double y, const double t) const {
+    /*!
+    * \param y: numerical solution at a certain time t
+    * \param t: time in seconds
+    * \return value of the expression at (y,t)
+    */
+    double small_registers[16];
+    std::vector<double> large_registers;
+    double *r = small_registers;
+    if (numberOfRegisters > 16) {
+        large_registers.resize(numberOfRegisters);
+        r = large_registers.data();
+    }
+    for (const Instruction &instruction : instructions) {
+        double value;
+        switch (instruction.operation) {
+            case Constant: value = instruction.value; break;
+            case VariableY: value = y; break;
+            case VariableT: value = t; break;
+            case Parameter: value = parameterValues[static_cast<int>(instruction.value)]; break;
+            case Add: value = r[instruction.left] + r[instruction.right]; break;
+            case Subtract: value = r[instruction.left] - r[instruction.right]; break;
+            case Multiply: value = r[instruction.left] * r[instruction.right]; break;
+            case Divide: value = r[instruction.left] / r[instruction.right]; break;
+            case AddConstant: value = r[instruction.left] + instruction.value; break;
+            case MultiplyConstant: value = r[instruction.left] * instruction.value; break;
+            case ConstantMinus: value = instruction.value - r[instruction.left]; break;
+            case DivideByConstant: value = r[instruction.left] / instruction.value; break;
+            case ConstantDivide: value = instruction.value / r[instruction.left]; break;
+            case Square: value = r[instruction.left] * r[instruction.left]; break;
+            case Negate: value = -r[instruction.left]; break;
+            default:
+                value = Apply(instruction.operation, r[instruction.left],
+                              instruction.right >= 0 ? r[instruction.right] : 0.);
+                break;
+        }
+        r[instruction.dest] = value;
+    }
+    return r[instructions.back().dest];
+}
+
+double Expression::RightHandSide(const double y, const double t, void *expression) {
+    /*!
+    * \param y: numerical solution at a certain time t
+    * \param t: time in seconds
+    * \param expression: pointer to the Expression to evaluate
+    * \return value of the expression at (y,t)
+    */
+    return static_cast<const Expression *>(expression)->Evaluate(y, t);
+}
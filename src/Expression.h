@@ -0,0 +1,87 @@
+#ifndef PCSC_PROJECT_EXPRESSION_H
+#define PCSC_PROJECT_EXPRESSION_H
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/** Right hand side f(y,t) given as a string, such as "-k*y + sin(t)".
+ * The expression may contain numbers, the variables y and t, named parameters, the operators + - * / ^ and the
+ * functions sin, cos, tan, asin, acos, atan, sinh, cosh, tanh, exp, log, sqrt and abs. <br>
+ * The string is parsed once into an expression graph in which constant sub-expressions are folded and identical
+ * sub-expressions are shared. The graph is then compiled into a flat list of register-based instructions, which
+ * Evaluate runs in a tight loop. <br>
+ * The parameters are read at evaluation time, so that SetParameter does not require a new compilation.
+ * The derivative with respect to y, t or a parameter is computed symbolically, e.g. to build the derivative
+ * of the right hand side needed by AbstractImplicitSolver. <br>
+ * Evaluate does not modify the expression, so that it can be called from several threads at the same time.
+ * RightHandSide evaluates the expression given as a context, e.g. to set it as the right hand side of a solver with
+ * AbstractOdeSolver::SetRightHandSide(Expression::RightHandSide, &expression).
+ */
+class Expression {
+public:
+    Expression();
+    explicit Expression(const std::string &text, const std::map<std::string, double> &parameters = {});
+
+    double Evaluate(double y, double t) const;
+    static double RightHandSide(double y, double t, void *expression);
+    Expression Derivative(const std::string &variable = "y") const;
+
+    void SetParameter(const std::string &name, double value);
+    double GetParameter(const std::string &name) const;
+    bool IsConstant() const;
+    unsigned int GetNumberOfInstructions() const { return instructions.size(); }
+    std::string GetText() const { return text; }
+
+private:
+    enum Operation {
+        Constant, VariableY, VariableT, Parameter,
+        Add, Subtract, Multiply, Divide, Power, Negate,
+        Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, Exp, Log, Sqrt, Abs,
+        // derivative of abs only: -1, 0 or 1
+        Sign,
+        // instructions only: one operand is the constant value of the instruction
+        AddConstant, MultiplyConstant, ConstantMinus, DivideByConstant, ConstantDivide, Square
+    };
+    /** node of the expression graph. The operands are indices of other nodes, -1 if unused.*/
+    struct Node {
+        Operation operation;
+        int left;
+        int right;
+        double value; // value of a constant, index of a parameter
+    };
+    /** instruction computing registers[dest] from registers[left] and registers[right] */
+    struct Instruction {
+        Operation operation;
+        int dest;
+        int left;
+        int right;
+        double value;
+    };
+
+    // parser
+    int ParseSum(const std::string &s, size_t &pos);
+    int ParseProduct(const std::string &s, size_t &pos);
+    int ParseUnary(const std::string &s, size_t &pos);
+    int ParsePower(const std::string &s, size_t &pos);
+    int ParsePrimary(const std::string &s, size_t &pos);
+
+    int MakeNode(Operation operation, int left = -1, int right = -1, double value = 0.);
+    int MakeConstant(double value) { return MakeNode(Constant, -1, -1, value); }
+    int Differentiate(int node, Operation variable, int parameter, std::map<int, int> &derivatives);
+    void Compile();
+    static double Apply(Operation operation, double a, double b);
+
+    std::string text;
+    std::vector<Node> nodes;
+    std::map<std::tuple<int, int, int, double>, int> nodeIndex; // identical nodes are only stored once
+    int root;
+    std::vector<std::string> parameterNames;
+    std::vector<double> parameterValues;
+    std::vector<Instruction> instructions;
+    int numberOfRegisters;
+};
+
+
+#endif //PCSC_PROJECT_EXPRESSION_H
@@ -0,0 +1,3 @@
+#include "ExpressionException.h"
+
+ExpressionException::ExpressionException(std::string probString) : Exception("EXPRESSION", probString){}
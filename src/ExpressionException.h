@@ -0,0 +1,13 @@
+#ifndef PCSC_PROJECT_EXPRESSIONEXCEPTION_H
+#define PCSC_PROJECT_EXPRESSIONEXCEPTION_H
+
+#include "Exception.hpp"
+
+/** Daughter of Exception class. Is thrown when a mathematical expression cannot be parsed.*/
+class ExpressionException : public Exception{
+public:
+    ExpressionException(std::string probString);
+};
+
+
+#endif //PCSC_PROJECT_EXPRESSIONEXCEPTION_H
@@ -0,0 +1,315 @@
+#include "ExtrapolationSolver.h"
+#include "SetOrderException.h"
+#include "UncoherentValueException.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+ExtrapolationSolver::ExtrapolationSolver()
+    : AbstractExplicitSolver(), tolerance(0.), numberOfThreads(1), controller(nullptr),
+      automaticInitialStep(false) {
+    /**
+    Constructor of an extrapolation solver instance. The step size is fixed and one thread is used.
+    */
+    ExtrapolationSolver::SetOrder(1);
+}
+
+ExtrapolationSolver::ExtrapolationSolver(const double h, const double t0, const double t1, const double y0,
+                                         double (*f)(double, double), const unsigned int s) :
+                                         AbstractExplicitSolver(h,t0,t1,y0,f,s), tolerance(0.), numberOfThreads(1),
+                                         controller(nullptr), automaticInitialStep(false) {
+    /**
+    Constructor of an extrapolation solver instance, where each parameter are defined from outside the class.
+    */
+    ExtrapolationSolver::SetOrder(s);
+}
+
+ExtrapolationSolver::~ExtrapolationSolver() = default;
+
+void ExtrapolationSolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: number of stages k of the extrapolation, between 1 and max_extrapolation_stages. The order of the
+ * method is 2k.
+*/
+    try {
+        if(order < 1 || order > max_extrapolation_stages) {
+            throw SetOrderException("The number of stages of the extrapolation solver should be between 1 and "
+                                    + std::to_string(max_extrapolation_stages) + ".");
+        }
+    } catch (SetOrderException &error) {
+        order = order < 1 ? 1 : max_extrapolation_stages;
+        Report(error, "The order is set to ", order, ". ");
+    }
+    AbstractOdeSolver::SetOrder(order);
+    SetB();
+}
+
+void ExtrapolationSolver::SetTolerance(double tol) {
+    /*! Set the tolerance on the local error. A tolerance equal to 0 means that the step size is fixed.
+    * \param tol: tolerance
+    */
+    try {
+        if (tol<0) {
+            throw UncoherentValueException("The tolerance must be positive.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The tolerance is set to |tol| = ", -tol);
+        tol = -tol;
+    }
+    tolerance = tol;
+}
+
+void ExtrapolationSolver::SetNumberOfThreads(unsigned int n) {
+    /*! Set the number of threads on which the sub-sequences of a step are computed.
+    * \param n: number of threads
+    */
+    try {
+        if (n<1) {
+            throw UncoherentValueException("The number of threads must be strictly positive.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The number of threads is set to 1.");
+        n = 1;
+    }
+    numberOfThreads = n;
+}
+
+void ExtrapolationSolver::SetB() {
+    /**
+   * Set the matrix B of coefficients of the extrapolation with a fixed number of stages.
+     Row k-1 contains the weights \f$ w_j \f$ such that \f$ T_{k,k} = \sum_{j=1}^k w_j T_{j,1} \f$, i.e. the values
+     at zero of the Lagrange polynomials in the variable \f$ 1/n_j^2 \f$. With \f$ n_j = 2j \f$,
+     \f$ w_j = \prod_{i \neq j} \frac{j^2}{j^2 - i^2} \f$. Note that each row sums to 1.
+   *
+   */
+    for (int k = 1; k <= static_cast<int>(max_order); k++) {
+        for (int j = 1; j <= k; j++) {
+            double w = 1.;
+            for (int i = 1; i <= k; i++) {
+                if (i != j) {
+                    w *= static_cast<double>(j*j)/(j*j - i*i);
+                }
+            }
+            b[k-1][j-1] = w;
+        }
+    }
+}
+
+void ExtrapolationSolver::SetStepSizeController(AbstractStepSizeController *controller) {
+    /*! Set the controller of the step size, used if the tolerance is not zero
+    * \param controller: step size controller, which must live as long as the solver. nullptr restores the default
+    * I controller.
+    */
+    this->controller = controller;
+}
+
+double ExtrapolationSolver::ModifiedMidpoint(const double y, const double t, const double f_y, const double H,
+                                             const unsigned int n) const {
+    /*! Explicit midpoint rule with n sub-steps over a macro step of size H (Gragg's method), i.e.
+    * \f$ z_1 = z_0 + h f(t, z_0), \quad z_{m+1} = z_{m-1} + 2h f(t + mh, z_m) \f$ with \f$ h = H/n \f$.
+    * \param y: value at the beginning of the step
+    * \param t: time at the beginning of the step
+    * \param f_y: evaluation of f(y,t), shared by all the sub-sequences
+    * \param H: size of the macro step
+    * \param n: number of sub-steps
+    * \return approximation of the solution at t+H, obtained with n-1 evaluations of f which are not counted in the
+    * result of the solver, the sub-sequences being computed on several threads
+    */
+    const double h = H/n;
+    double z_prev = y;
+    double z = y + h*f_y;
+    for (unsigned int m = 1; m < n; m++) {
+        double z_next = z_prev + 2*h*EvaluateRightHandSide(z, t + m*h);
+        z_prev = z;
+        z = z_next;
+    }
+    return z;
+}
+
+void ExtrapolationSolver::Solve(AbstractOutputSink &sink) {
+    /*!
+   * Gragg-Bulirsch-Stoer extrapolation method for the scalar ODE in the form y'(t)=f(y,t).
+
+   * \param sink: sink receiving the numerical solution at each time t
+   */
+    double y = GetInitialValue();
+    double t = GetInitialTime();
+    double H = GetStepSize();
+    const double t1 = GetFinalTime();
+    const unsigned int order = GetOrder();
+    assert(H > 1e-6);
+
+    // data of the current macro step, shared with the worker threads
+    double f_y = 0.;
+    unsigned int stages = order;
+    double T[max_order]; // T_{j,1}, j = 1, ..., stages
+    std::vector<std::vector<unsigned int>> assignment(numberOfThreads);
+
+    auto compute = [&](unsigned int w) {
+        for (unsigned int j : assignment[w]) {
+            T[j] = ModifiedMidpoint(y, t, f_y, H, 2*(j+1));
+        }
+    };
+
+    // the worker threads live for the whole integration and wait for the next macro step.
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    unsigned int generation = 0;
+    unsigned int remaining = 0;
+    bool stop = false;
+    std::vector<std::thread> workers;
+    for (unsigned int w = 1; w < numberOfThreads; w++) {
+        workers.emplace_back([&, w]() {
+            unsigned int seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    start_cv.wait(lock, [&]() { return stop || generation != seen; });
+                    if (stop) {
+                        return;
+                    }
+                    seen = generation;
+                }
+                compute(w);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0) {
+                    done_cv.notify_one();
+                }
+            }
+        });
+    }
+
+    auto compute_stages = [&]() {
+        // the cost of the sub-sequence j is proportional to n_j: the most expensive ones are given first to the
+        // least loaded thread.
+        std::vector<unsigned int> load(numberOfThreads, 0);
+        for (auto &tasks : assignment) {
+            tasks.clear();
+        }
+        for (int j = static_cast<int>(stages) - 1; j >= 0; j--) {
+            unsigned int w = std::min_element(load.begin(), load.end()) - load.begin();
+            assignment[w].push_back(j);
+            load[w] += 2*(j+1);
+        }
+        for (unsigned int j = 0; j < stages; j++) {
+            result.rhsEvaluations += 2*(j+1) - 1;
+        }
+        if (numberOfThreads == 1) {
+            compute(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining = numberOfThreads - 1;
+            ++generation;
+        }
+        start_cv.notify_all();
+        compute(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [&]() { return remaining == 0; });
+    };
+
+    if (tolerance == 0.) {
+        sink.Reserve(GetNumberOfSteps() + 1);
+    }
+    Output(sink, t, y);
+    if (tolerance == 0.) {
+        // fixed step size: the extrapolated value is a linear combination of the T_{j,1}
+        int n = static_cast<int>(std::floor((t1 - GetInitialTime()) / H));
+        for (int i = 1; i <= n; ++i) {
+            f_y = RightHandSide(y, t);
+            compute_stages();
+            y = ProductWithB(T, order);
+            t += H;
+            //pass the values to the sink
+            Output(sink, t, y);
+        }
+    } else {
+        // adaptive step size and number of stages: at least 2 stages are needed to estimate the error.
+        const unsigned int max_stages = std::max(order, 2u);
+        unsigned int k = max_stages;
+        double work[max_order+1]; // work[j]: number of evaluations of f for j+1 stages
+        work[0] = 2.;
+        for (unsigned int j = 1; j < max_stages; j++) {
+            work[j] = work[j-1] + 2*(j+1) - 1;
+        }
+        GetStepSizeController()->Reset();
+        if (automaticInitialStep) {
+            H = InitialStepSize(tolerance, 2*max_stages);
+        }
+        f_y = RightHandSide(y, t);
+        while (t1 - t > 1e-12*std::max(1., std::abs(t1))) {
+            if (t + H > t1) {
+                H = t1 - t;
+            }
+            stages = k;
+            compute_stages();
+
+            // Aitken-Neville extrapolation table and estimation of the error of each column
+            double table[max_order][max_order];
+            double H_new[max_order] = {}; // step size for which the error of column j would match the tolerance
+            for (unsigned int j = 0; j < k; j++) {
+                table[j][0] = T[j];
+                for (unsigned int l = 1; l <= j; l++) {
+                    double ratio = static_cast<double>(j+1)/(j+1-l);
+                    table[j][l] = table[j][l-1] + (table[j][l-1] - table[j-1][l-1])/(ratio*ratio - 1);
+                }
+            }
+            const double scale = tolerance*(1 + std::max(std::abs(y), std::abs(table[k-1][k-1])));
+            double error = 0.;
+            for (unsigned int j = 1; j < k; j++) {
+                error = std::abs(table[j][j] - table[j][j-1])/scale;
+                H_new[j] = H*GetStepSizeController()->Factor(error/0.65, 2*j+1);
+            }
+
+            // choose the number of stages that minimizes the work per unit step
+            unsigned int k_new = k;
+            double H_next = H_new[k-1];
+            if (k > 2 && work[k-2]/H_new[k-2] < 0.8*work[k-1]/H_new[k-1]) {
+                k_new = k-1;
+                H_next = H_new[k-2];
+            } else if (k < max_stages && (k == 2 || work[k-1]/H_new[k-1] < 0.9*work[k-2]/H_new[k-2])) {
+                k_new = k+1;
+                H_next = H_new[k-1]*work[k]/work[k-1];
+            }
+
+            if (error <= 1.) {
+                // the step is accepted
+                GetStepSizeController()->Accept(error/0.65);
+                ++result.acceptedSteps;
+                t += H;
+                y = table[k-1][k-1];
+                f_y = RightHandSide(y, t);
+                //pass the values to the sink
+                Output(sink, t, y);
+                k = k_new;
+                H = H_next;
+            } else {
+                // the step is rejected and restarted with a smaller step size
+                GetStepSizeController()->Reject();
+                ++result.rejectedSteps;
+                H = std::min(H_new[k-1], H_next);
+            }
+            if (H < 1e-12*std::max(1., std::abs(t))) {
+                // reported at the end of the integration
+                result.status = SolverStatus::StepSizeTooSmall;
+                break;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    start_cv.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef PCSC_PROJECT_EXTRAPOLATIONSOLVER_H
+#define PCSC_PROJECT_EXTRAPOLATIONSOLVER_H
+
+#include "AbstractExplicitSolver.h"
+#include "IStepSizeController.h"
+#include <fstream>
+
+/** largest number of stages of the extrapolation, as in Hairer's ODEX: the weights of the extrapolation grow quickly
+ * with the number of stages, so that the round-off errors would dominate above.*/
+const unsigned int max_extrapolation_stages = 9;
+
+/** Daughter of Abstract Explicit Solver class.
+ * The Gragg-Bulirsch-Stoer extrapolation solver solves the initial value problem
+     * \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0 \f$
+     * Each macro step of size \f$ H \f$ is computed with the explicit midpoint rule (the order 2 method of the
+     * Runge-Kutta solver) applied with \f$ n_j = 2j \f$ sub-steps, \f$ j = 1, \dots, k \f$. The results
+     * \f$ T_{j,1} \f$ have an error expansion in powers of \f$ (H/n_j)^2 \f$ and are extrapolated to
+     * \f$ H/n_j \to 0 \f$ with the Aitken-Neville algorithm, which gives a method of order \f$ 2k \f$. <br>
+     * The order of the solver is the number of stages \f$ k \f$, at most max_extrapolation_stages. <br>
+     * If the tolerance is zero, the step size is fixed. Otherwise, the step size and the number of stages
+     * (at most the order of the solver) are adapted to keep the local error below the tolerance. The step size
+     * of each column of the extrapolation table is given by a step size controller, by default an I controller as in
+     * Hairer's ODEX (see AbstractStepSizeController). The initial step size is the one set with SetStepSize, or is
+     * estimated from f(y0,t0) with SetAutomaticInitialStep. <br>
+     * The sub-sequences \f$ T_{j,1} \f$ are independent and can be computed on several threads, in which case
+     * the right hand side must be safe to call concurrently.
+     */
+class ExtrapolationSolver : public AbstractExplicitSolver {
+public:
+    ExtrapolationSolver();
+    ExtrapolationSolver(double h, double t0, double t1, double y0,
+                        double (*f)(double y, double t), unsigned int s);
+    ~ExtrapolationSolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetTolerance(double tol);
+    void SetNumberOfThreads(unsigned int n);
+    void SetStepSizeController(AbstractStepSizeController *controller);
+    void SetAutomaticInitialStep(bool automatic) { automaticInitialStep = automatic; }
+    double GetTolerance() const { return tolerance; }
+    unsigned int GetNumberOfThreads() const { return numberOfThreads; }
+    /** Controller set with SetStepSizeController, or the default I controller of this instance.*/
+    AbstractStepSizeController *GetStepSizeController() const {
+        return controller != nullptr ? controller : &defaultController;
+    }
+    bool GetAutomaticInitialStep() const { return automaticInitialStep; }
+
+    double ModifiedMidpoint(double y, double t, double f_y, double H, unsigned int n) const;
+
+private:
+    double tolerance;
+    unsigned int numberOfThreads;
+    // the error is compared with 0.65 times the tolerance, with a safety factor 0.94, as in ODEX
+    mutable IStepSizeController defaultController{0.94, 0.02, 4.};
+    // nullptr for the default controller, resolved at use time so that a copy of the solver uses its own
+    AbstractStepSizeController *controller;
+    bool automaticInitialStep;
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_EXTRAPOLATIONSOLVER_H
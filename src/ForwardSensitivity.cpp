@@ -0,0 +1,82 @@
+#include "ForwardSensitivity.h"
+#include <cassert>
+
+ForwardSensitivity::ForwardSensitivity() : jacobian(0), jacobianContext(0) {}
+
+void ForwardSensitivity::SetJacobian(double (*dfdy)(double y, double t, void *context), void *context) {
+    /*! Set the derivative of f with respect to y, needed by the explicit solvers
+    * \param dfdy: function handle for df/dy(y,t,context)
+    * \param context: pointer given to each call of dfdy, which must live as long as the sensitivity
+    */
+    jacobian = dfdy;
+    jacobianContext = context;
+}
+
+void ForwardSensitivity::AddParameter(double (*dfdp)(double y, double t, void *context), void *context) {
+    /*! Add the sensitivity with respect to a parameter p of the right hand side
+    * \param dfdp: function handle for df/dp(y,t,context)
+    * \param context: pointer given to each call of dfdp, which must live as long as the sensitivity
+    */
+    terms.push_back({dfdp, context, 0.});
+}
+
+void ForwardSensitivity::AddInitialValue() {
+    /*! Add the sensitivity with respect to the initial value y0
+    */
+    terms.push_back({0, 0, 1.});
+}
+
+ForwardSensitivity ForwardSensitivity::FromExpression(const Expression &f, const std::vector<std::string> &parameters,
+                                                      const bool initialValue) {
+    /*! Build the sensitivities of the solution of y' = f from the symbolic derivatives of f. The values of the
+    * parameters are those of f when the sensitivity is built.
+    * \param f: right hand side given to the solver
+    * \param parameters: names of the parameters of f, in the order of the sensitivities
+    * \param initialValue: if true, the sensitivity with respect to y0 is added after those of the parameters
+    * \return The sensitivities, to be given to a solver with SetSensitivity
+    */
+    ForwardSensitivity sensitivity;
+    sensitivity.expressions.emplace_back(new Expression(f.Derivative("y")));
+    sensitivity.SetJacobian(Expression::RightHandSide, sensitivity.expressions.back().get());
+    for (const std::string &name : parameters) {
+        sensitivity.expressions.emplace_back(new Expression(f.Derivative(name)));
+        sensitivity.AddParameter(Expression::RightHandSide, sensitivity.expressions.back().get());
+    }
+    if (initialValue) {
+        sensitivity.AddInitialValue();
+    }
+    return sensitivity;
+}
+
+void ForwardSensitivity::Start(const unsigned long records) {
+    /*! Remove the sensitivities of the previous solution
+    * \param records: number of records about to be written, 0 if unknown
+    */
+    history.clear();
+    history.reserve(records*terms.size());
+}
+
+unsigned long ForwardSensitivity::GetNumberOfRecords() const {
+    /*!
+    * \return The number of records whose sensitivities are kept
+    */
+    return terms.empty() ? 0 : history.size()/terms.size();
+}
+
+double ForwardSensitivity::GetSensitivity(const unsigned int k) const {
+    /*!
+    * \param k: index of the parameter
+    * \return The sensitivity of the last record, i.e. at the final time
+    */
+    return GetSensitivity(k, GetNumberOfRecords() - 1);
+}
+
+double ForwardSensitivity::GetSensitivity(const unsigned int k, const unsigned long record) const {
+    /*!
+    * \param k: index of the parameter
+    * \param record: index of the record, in the order in which the solver wrote them
+    * \return The derivative of the solution of the record with respect to the kth parameter
+    */
+    assert(k < terms.size() && record < GetNumberOfRecords());
+    return history[record*terms.size() + k];
+}
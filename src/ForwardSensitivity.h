@@ -0,0 +1,69 @@
+#ifndef PCSC_PROJECT_FORWARDSENSITIVITY_H
+#define PCSC_PROJECT_FORWARDSENSITIVITY_H
+
+#include "Expression.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Forward sensitivities of the solution y(t) of \f$ y' = f(y,t,p) \f$ with respect to parameters
+ * \f$ p_1, \dots, p_m \f$ and to the initial value \f$ y_0 \f$, computed by one call to SolveEquation. <br>
+ * Each sensitivity \f$ s_k = \partial y / \partial p_k \f$ satisfies the linear equation
+ * \f$ s_k' = \frac{\partial f}{\partial y}(y,t) s_k + \frac{\partial f}{\partial p_k}(y,t) \f$, with
+ * \f$ s_k(t_0) = 0 \f$ (\f$ s' = \frac{\partial f}{\partial y} s \f$ and \f$ s(t_0) = 1 \f$ for the initial value),
+ * which the solver integrates with the same method and the same steps as y: the sensitivities are the exact
+ * derivatives of the numerical solution. <br>
+ * The derivatives of f are given as functions called with a context, or built symbolically from an Expression with
+ * FromExpression. The implicit solvers use their own derivative df instead of the Jacobian given here, so that
+ * the sensitivities are obtained from the Newton matrix of each step, without any further iteration. <br>
+ * The sensitivities of each record written by the solver are kept, in the order of the parameters.
+ */
+class ForwardSensitivity {
+public:
+    ForwardSensitivity();
+    ForwardSensitivity(ForwardSensitivity &&other) noexcept = default;
+    ForwardSensitivity &operator=(ForwardSensitivity &&other) noexcept = default;
+    // the functions built by FromExpression point to expressions owned by the object
+    ForwardSensitivity(const ForwardSensitivity &other) = delete;
+    ForwardSensitivity &operator=(const ForwardSensitivity &other) = delete;
+
+    void SetJacobian(double (*dfdy)(double y, double t, void *context), void *context);
+    void AddParameter(double (*dfdp)(double y, double t, void *context), void *context);
+    void AddInitialValue();
+    static ForwardSensitivity FromExpression(const Expression &f, const std::vector<std::string> &parameters,
+                                             bool initialValue = true);
+
+    unsigned int Size() const { return terms.size(); }
+    bool HasJacobian() const { return jacobian != 0; }
+    double Jacobian(double y, double t) const { return jacobian(y, t, jacobianContext); }
+    /** Derivative of f with respect to the kth parameter, 0 for the initial value.*/
+    double Forcing(unsigned int k, double y, double t) const {
+        return terms[k].dfdp != 0 ? terms[k].dfdp(y, t, terms[k].context) : 0.;
+    }
+    double GetInitialSensitivity(unsigned int k) const { return terms[k].initial; }
+
+    // called by the solvers
+    void Start(unsigned long records);
+    void Record(const double *s) { history.insert(history.end(), s, s + terms.size()); }
+
+    unsigned long GetNumberOfRecords() const;
+    double GetSensitivity(unsigned int k) const;
+    double GetSensitivity(unsigned int k, unsigned long record) const;
+
+private:
+    struct Term {
+        double (*dfdp)(double y, double t, void *context);
+        void *context;
+        double initial;
+    };
+    double (*jacobian)(double y, double t, void *context);
+    void *jacobianContext;
+    std::vector<Term> terms;
+    // derivatives of the expression given to FromExpression
+    std::vector<std::unique_ptr<Expression>> expressions;
+    // sensitivities of each record, Size() values per record
+    std::vector<double> history;
+};
+
+
+#endif //PCSC_PROJECT_FORWARDSENSITIVITY_H
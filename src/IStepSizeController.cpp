@@ -0,0 +1,14 @@
+#include "IStepSizeController.h"
+#include <cmath>
+
+IStepSizeController::IStepSizeController(const double safety, const double minFactor, const double maxFactor)
+    : AbstractStepSizeController(safety, minFactor, maxFactor) {}
+
+double IStepSizeController::RawFactor(const double error, const unsigned int k) const {
+    /*!
+    * \param error: error of the step divided by the tolerance
+    * \param k: order of the error estimate
+    * \return \f$ (1/err_n)^{1/k} \f$
+    */
+    return std::pow(error, -1./k);
+}
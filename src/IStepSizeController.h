@@ -0,0 +1,18 @@
+#ifndef PCSC_PROJECT_ISTEPSIZECONTROLLER_H
+#define PCSC_PROJECT_ISTEPSIZECONTROLLER_H
+
+#include "AbstractStepSizeController.h"
+
+/** Daughter of AbstractStepSizeController. Elementary (integral) controller: the factor is
+ * \f$ (1/err_n)^{1/k} \f$, which would give an error equal to the tolerance if the error constant did not change.
+ */
+class IStepSizeController : public AbstractStepSizeController {
+public:
+    explicit IStepSizeController(double safety = 0.9, double minFactor = 0.2, double maxFactor = 5.);
+
+protected:
+    double RawFactor(double error, unsigned int k) const override;
+};
+
+
+#endif //PCSC_PROJECT_ISTEPSIZECONTROLLER_H
@@ -0,0 +1,233 @@
+#include "JobManifest.h"
+#include "ManifestException.h"
+#include "AbstractOdeSolver.hpp"
+#include "ExtrapolationSolver.h"
+#include "Expression.h"
+#include "ExpressionException.h"
+#include "ProblemLibrary.h"
+
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <type_traits>
+
+namespace {
+    std::string Trim(const std::string &s) {
+        const std::string blanks(" \t\r");
+        size_t begin = s.find_first_not_of(blanks);
+        if (begin == std::string::npos) {
+            return "";
+        }
+        size_t end = s.find_last_not_of(blanks);
+        return s.substr(begin, end - begin + 1);
+    }
+
+    template <class T>
+    T ParseNumber(const std::string &key, const std::string &value, unsigned int line) {
+        // the whole value must be consumed, e.g. "1e-3x" or "2.5" for an integer are rejected.
+        if (std::is_unsigned<T>::value && !value.empty() && value[0] == '-') {
+            throw ManifestException("Line " + std::to_string(line) + ": " + key + " must be positive.");
+        }
+        std::stringstream stream(value);
+        T number;
+        stream >> number;
+        if (stream.fail() || !stream.eof()) {
+            throw ManifestException("Line " + std::to_string(line) + ": invalid value '" + value + "' for " + key + ".");
+        }
+        return number;
+    }
+}
+
+JobManifest::JobManifest() = default;
+
+JobManifest::JobManifest(const std::string &filename) {
+    /**
+    * Constructor reading the jobs of the manifest file filename.
+    */
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw ManifestException("The manifest " + filename + " can't be opened.");
+    }
+    Read(file);
+}
+
+void JobManifest::Read(std::istream &stream) {
+    /*!
+     * Read and validate the jobs of a manifest. The jobs are appended to the ones already read.
+     * \param stream: stream containing the manifest
+     */
+    const std::set<std::string> mandatory_keys = {"solver", "h", "t0", "t1", "y0", "order", "output"};
+    std::vector<Job> new_jobs;
+    std::set<std::string> keys;
+
+    auto close_job = [&]() {
+        if (new_jobs.empty()) {
+            return;
+        }
+        for (const std::string &key : mandatory_keys) {
+            if (keys.count(key) == 0) {
+                throw ManifestException("Job of line " + std::to_string(new_jobs.back().line) + ": missing key "
+                                        + key + ".");
+            }
+        }
+        if (keys.count("choice") + keys.count("rhs") + keys.count("problem") != 1) {
+            throw ManifestException("Job of line " + std::to_string(new_jobs.back().line)
+                                    + ": exactly one of the keys choice, rhs and problem must be given.");
+        }
+        Validate(new_jobs.back());
+        keys.clear();
+    };
+
+    std::string raw_line;
+    unsigned int line = 0;
+    while (std::getline(stream, raw_line)) {
+        ++line;
+        std::string content = Trim(raw_line);
+        if (content.empty() || content[0] == '#') {
+            continue;
+        }
+        if (content == "[job]") {
+            close_job();
+            new_jobs.emplace_back();
+            new_jobs.back().line = line;
+            continue;
+        }
+        size_t equal = content.find('=');
+        if (equal == std::string::npos) {
+            throw ManifestException("Line " + std::to_string(line) + ": expected '[job]' or 'key = value'.");
+        }
+        if (new_jobs.empty()) {
+            throw ManifestException("Line " + std::to_string(line) + ": key given before the first [job].");
+        }
+        std::string key = Trim(content.substr(0, equal));
+        std::string value = Trim(content.substr(equal + 1));
+        if (!keys.insert(key).second) {
+            throw ManifestException("Line " + std::to_string(line) + ": key " + key + " is given twice.");
+        }
+        SetValue(new_jobs.back(), key, value, line);
+    }
+    close_job();
+
+    // every job writes its own file
+    std::set<std::string> outputs;
+    for (const Job &job : jobs) {
+        outputs.insert(job.output);
+    }
+    for (const Job &job : new_jobs) {
+        if (!outputs.insert(job.output).second) {
+            throw ManifestException("Job of line " + std::to_string(job.line) + ": the output " + job.output
+                                    + " is already written by another job.");
+        }
+    }
+    jobs.insert(jobs.end(), new_jobs.begin(), new_jobs.end());
+}
+
+void JobManifest::SetValue(Job &job, const std::string &key, const std::string &value, const unsigned int line) const {
+    /*!
+     * Set the field of job corresponding to key.
+     * \param job: job being read
+     * \param key: name of the field
+     * \param value: value of the field, as written in the manifest
+     * \param line: line of the manifest, used in the error messages
+     */
+    if (key == "solver") {
+        job.type_solver = value;
+    } else if (key == "h") {
+        job.h = ParseNumber<double>(key, value, line);
+    } else if (key == "t0") {
+        job.t0 = ParseNumber<double>(key, value, line);
+    } else if (key == "t1") {
+        job.t1 = ParseNumber<double>(key, value, line);
+    } else if (key == "y0") {
+        job.y0 = ParseNumber<double>(key, value, line);
+    } else if (key == "order") {
+        job.order = ParseNumber<unsigned int>(key, value, line);
+    } else if (key == "choice") {
+        job.choice = ParseNumber<int>(key, value, line);
+    } else if (key == "rhs") {
+        job.rhs = value;
+        job.choice = 4;
+    } else if (key == "problem") {
+        job.problem = value;
+        job.choice = 5;
+    } else if (key.compare(0, 10, "parameter.") == 0 && key.size() > 10) {
+        job.parameters[key.substr(10)] = ParseNumber<double>(key, value, line);
+    } else if (key == "output") {
+        job.output = value;
+    } else if (key == "format") {
+        job.format = value;
+    } else if (key == "quantum") {
+        job.quantum = ParseNumber<double>(key, value, line);
+    } else if (key == "backpressure") {
+        job.backpressure = value;
+    } else if (key == "tolerance") {
+        job.tolerance = ParseNumber<double>(key, value, line);
+    } else if (key == "threads") {
+        job.threads = ParseNumber<unsigned int>(key, value, line);
+    } else {
+        throw ManifestException("Line " + std::to_string(line) + ": unknown key " + key + ".");
+    }
+}
+
+void JobManifest::Validate(const Job &job) const {
+    /*!
+     * Check that the parameters of a job are coherent. Unlike the interactive mode, nothing is corrected.
+     * \param job: job to check
+     */
+    const std::string where = "Job of line " + std::to_string(job.line) + ": ";
+    unsigned int order_min = 1;
+    unsigned int order_max = max_order;
+    if (job.type_solver == "AM") {
+        order_min = 0;
+        order_max = max_order-1;
+    } else if (job.type_solver == "RK" || job.type_solver == "LSRK" || job.type_solver == "ETD"
+               || job.type_solver == "ROS" || job.type_solver == "auto") {
+        order_max = 4;
+    } else if (job.type_solver == "GBS") {
+        order_max = max_extrapolation_stages;
+    } else if (job.type_solver != "AB") {
+        throw ManifestException(where + "unknown solver " + job.type_solver + ".");
+    }
+    if (job.order < order_min || job.order > order_max) {
+        throw ManifestException(where + "the order of the " + job.type_solver + " solver must be between "
+                                + std::to_string(order_min) + " and " + std::to_string(order_max) + ".");
+    }
+    if (!(job.h >= 1e-6)) {
+        throw ManifestException(where + "the step size must be bigger than 1e-6.");
+    }
+    if (job.t0 < 0 || job.t1 < job.t0) {
+        throw ManifestException(where + "the time interval must satisfy 0 <= t0 <= t1.");
+    }
+    if (job.choice == 4) {
+        try {
+            Expression expression(job.rhs, job.parameters);
+        } catch (ExpressionException &error) {
+            throw ManifestException(where + "invalid rhs " + job.rhs + ".");
+        }
+    } else if (job.choice == 5) {
+        if (ProblemLibrary::Find(job.problem) == nullptr) {
+            throw ManifestException(where + "unknown problem " + job.problem + ".");
+        }
+    } else if (!(job.choice == 1 || job.choice == 2 || job.choice == 3)) {
+        throw ManifestException(where + "choice must be either 1, 2, or 3, or the right hand side must be given "
+                                        "with an rhs or a problem key.");
+    }
+    if (job.output.empty()) {
+        throw ManifestException(where + "the output file name is empty.");
+    }
+    if (!(job.format == "text" || job.format == "binary" || job.format == "compressed")) {
+        throw ManifestException(where + "unknown output format " + job.format + ".");
+    }
+    if (!(job.backpressure == "block" || job.backpressure == "decimate" || job.backpressure == "grow")) {
+        throw ManifestException(where + "backpressure must be either block, decimate, or grow.");
+    }
+    if (job.quantum < 0) {
+        throw ManifestException(where + "the quantum must be positive.");
+    }
+    if (job.tolerance < 0) {
+        throw ManifestException(where + "the tolerance must be positive.");
+    }
+    if (job.threads < 1) {
+        throw ManifestException(where + "the number of threads must be strictly positive.");
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef PCSC_PROJECT_JOBMANIFEST_H
+#define PCSC_PROJECT_JOBMANIFEST_H
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+/** Description of one job of a manifest: the solver, its parameters, the right hand side and the output file.*/
+struct Job {
+    std::string type_solver;
+    double h = 0.;
+    double t0 = 0.;
+    double t1 = 0.;
+    double y0 = 0.;
+    unsigned int order = 0;
+    int choice = 0;
+    /** right hand side given as an expression, in which case choice is 4*/
+    std::string rhs;
+    /** name of a problem of the ProblemLibrary, in which case choice is 5*/
+    std::string problem;
+    std::map<std::string, double> parameters;
+    std::string output;
+    std::string format = "text";
+    /** maximal error of the compressed format is quantum/2, 0 for a compression without loss*/
+    double quantum = 0.;
+    /** what the asynchronous writer does when the solver is faster than the disk: block, decimate or grow*/
+    std::string backpressure = "block";
+    double tolerance = 0.;
+    unsigned int threads = 1;
+    /** line of the [job] header in the manifest, used in the error messages*/
+    unsigned int line = 0;
+};
+
+/** Reads a declarative job file, so that main_solver can run a batch of jobs without asking anything to the user.
+ * The manifest is a list of sections starting with a `[job]` header, followed by `key = value` lines.
+ * Empty lines and lines starting with `#` are ignored. The keys are: <br>
+ * `solver`, `h`, `t0`, `t1`, `y0`, `order`, `choice`, `rhs` or `problem`, and `output` (mandatory), <br>
+ * `format` (`text`, `binary` for a file mapped in memory, see MappedOutputSink, or `compressed`, see
+ * CompressedOutputSink), `quantum` (for the compressed format), `backpressure` (`block`, `decimate` or `grow`, see AsyncOutputSink),
+ * `tolerance` (for the GBS, ROS and auto solvers) and `threads` (for the GBS solver) (optional). <br>
+ * `rhs` is an expression of y, t and parameters, see Expression. The value of a parameter k is given by the key
+ * `parameter.k`. `problem` is the name of a problem of the ProblemLibrary, e.g. `logistic`. <br>
+ * All the jobs are validated when the manifest is read: an invalid manifest throws a ManifestException
+ * instead of prompting the user, and no job is run.
+ */
+class JobManifest {
+public:
+    JobManifest();
+    explicit JobManifest(const std::string &filename);
+
+    void Read(std::istream &stream);
+    const std::vector<Job> &GetJobs() const { return jobs; }
+
+private:
+    void SetValue(Job &job, const std::string &key, const std::string &value, unsigned int line) const;
+    void Validate(const Job &job) const;
+    std::vector<Job> jobs;
+};
+
+
+#endif //PCSC_PROJECT_JOBMANIFEST_H
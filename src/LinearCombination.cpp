@@ -0,0 +1,192 @@
+#include "LinearCombination.h"
+
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LINEAR_COMBINATION_X86
+#endif
+
+namespace {
+
+void CombineScalar(const size_t first, const size_t n, const double *y, const double h, const unsigned int m,
+                   const double *c, const double *const *k, double *result) {
+    // portable loop, also used for the last elements of the vector kernels
+    for (size_t i = first; i < n; i++) {
+        double sum = 0.;
+        for (unsigned int j = 0; j < m; j++) {
+            sum += c[j]*k[j][i];
+        }
+        result[i] = y[i] + h*sum;
+    }
+}
+
+void KernelScalar(const size_t n, const double *y, const double h, const unsigned int m, const double *c,
+                  const double *const *k, double *result) {
+    CombineScalar(0, n, y, h, m, c, k, result);
+}
+
+#ifdef LINEAR_COMBINATION_X86
+__attribute__((target("sse2")))
+void KernelSSE2(const size_t n, const double *y, const double h, const unsigned int m, const double *c,
+                const double *const *k, double *result) {
+    const __m128d h_v = _mm_set1_pd(h);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d sum = _mm_setzero_pd();
+        for (unsigned int j = 0; j < m; j++) {
+            sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(c[j]), _mm_loadu_pd(k[j] + i)));
+        }
+        _mm_storeu_pd(result + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(h_v, sum)));
+    }
+    CombineScalar(i, n, y, h, m, c, k, result);
+}
+
+__attribute__((target("avx2,fma")))
+void KernelAVX2(const size_t n, const double *y, const double h, const unsigned int m, const double *c,
+                const double *const *k, double *result) {
+    const __m256d h_v = _mm256_set1_pd(h);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sum = _mm256_setzero_pd();
+        for (unsigned int j = 0; j < m; j++) {
+            sum = _mm256_fmadd_pd(_mm256_set1_pd(c[j]), _mm256_loadu_pd(k[j] + i), sum);
+        }
+        _mm256_storeu_pd(result + i, _mm256_fmadd_pd(h_v, sum, _mm256_loadu_pd(y + i)));
+    }
+    CombineScalar(i, n, y, h, m, c, k, result);
+}
+
+__attribute__((target("avx512f")))
+void KernelAVX512(const size_t n, const double *y, const double h, const unsigned int m, const double *c,
+                  const double *const *k, double *result) {
+    const __m512d h_v = _mm512_set1_pd(h);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d sum = _mm512_setzero_pd();
+        for (unsigned int j = 0; j < m; j++) {
+            sum = _mm512_fmadd_pd(_mm512_set1_pd(c[j]), _mm512_loadu_pd(k[j] + i), sum);
+        }
+        _mm512_storeu_pd(result + i, _mm512_fmadd_pd(h_v, sum, _mm512_loadu_pd(y + i)));
+    }
+    CombineScalar(i, n, y, h, m, c, k, result);
+}
+#endif
+
+}
+
+std::atomic<LinearCombination::Kernel> LinearCombination::kernel(nullptr);
+std::atomic<InstructionSet> LinearCombination::selected(InstructionSet::Scalar);
+
+void LinearCombination::Compute(const size_t n, const double *y, const double h, const unsigned int m,
+                                const double *c, const double *const *k, double *result) {
+    /*! Compute \f$ r_i = y_i + h \sum_{j=0}^{m-1} c_j k_j[i] \f$ for \f$ i = 0, \dots, n-1 \f$
+    * \param n: length of the arrays
+    * \param y: array added to the combination, which may be the same as result
+    * \param h: factor of the combination, e.g. the step size
+    * \param m: number of terms, possibly 0
+    * \param c: coefficients of the terms
+    * \param k: arrays of the terms, which must not overlap result
+    * \param result: array receiving the combination
+    */
+    Kernel compute = kernel.load(std::memory_order_acquire);
+    if (compute == nullptr) {
+        SetInstructionSet(Best());
+        compute = kernel.load(std::memory_order_acquire);
+    }
+    compute(n, y, h, m, c, k, result);
+}
+
+InstructionSet LinearCombination::GetInstructionSet() {
+    /*!
+    * \return The instruction set of the kernel used by Compute, the best one supported by the processor unless
+    * another one was set
+    */
+    if (kernel.load(std::memory_order_acquire) == nullptr) {
+        SetInstructionSet(Best());
+    }
+    return selected.load(std::memory_order_acquire);
+}
+
+bool LinearCombination::IsSupported(const InstructionSet set) {
+    /*!
+    * \param set: instruction set
+    * \return Whether the processor, and the compiler, support the kernel of this instruction set
+    */
+#ifdef LINEAR_COMBINATION_X86
+    switch (set) {
+        case InstructionSet::Scalar:
+            return true;
+        case InstructionSet::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case InstructionSet::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case InstructionSet::AVX512:
+            return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return set == InstructionSet::Scalar;
+#endif
+}
+
+void LinearCombination::SetInstructionSet(InstructionSet set) {
+    /*! Force the instruction set of the kernel, e.g. to compare the kernels. The change is seen by the next calls to
+    * Compute from all the threads.
+    * \param set: instruction set. The portable loop is used if the processor does not support it.
+    */
+    if (!IsSupported(set)) {
+        set = InstructionSet::Scalar;
+    }
+    selected.store(set, std::memory_order_release);
+    kernel.store(GetKernel(set), std::memory_order_release);
+}
+
+const char *LinearCombination::GetName(const InstructionSet set) {
+    /*!
+    * \param set: instruction set
+    * \return The name of the instruction set
+    */
+    switch (set) {
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        default:
+            return "scalar";
+    }
+}
+
+LinearCombination::Kernel LinearCombination::GetKernel(const InstructionSet set) {
+    /*!
+    * \param set: instruction set, supported by the processor
+    * \return The kernel of this instruction set
+    */
+#ifdef LINEAR_COMBINATION_X86
+    switch (set) {
+        case InstructionSet::SSE2:
+            return KernelSSE2;
+        case InstructionSet::AVX2:
+            return KernelAVX2;
+        case InstructionSet::AVX512:
+            return KernelAVX512;
+        default:
+            break;
+    }
+#endif
+    return KernelScalar;
+}
+
+InstructionSet LinearCombination::Best() {
+    /*!
+    * \return The widest instruction set supported by the processor
+    */
+    for (InstructionSet set : {InstructionSet::AVX512, InstructionSet::AVX2, InstructionSet::SSE2}) {
+        if (IsSupported(set)) {
+            return set;
+        }
+    }
+    return InstructionSet::Scalar;
+}
@@ -0,0 +1,44 @@
+#ifndef PCSC_PROJECT_LINEARCOMBINATION_H
+#define PCSC_PROJECT_LINEARCOMBINATION_H
+
+#include <atomic>
+#include <cstddef>
+
+/** Instruction sets of the kernels of LinearCombination.*/
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    /** AVX2 with fused multiply-add*/
+    AVX2,
+    AVX512
+};
+
+/** Fused linear combination of arrays \f$ r = y + h \sum_{j=0}^{m-1} c_j k_j \f$, the update of the stages and of the
+ * history of the solvers once their values are arrays (e.g. the forward sensitivities of several parameters). <br>
+ * All the terms are accumulated in registers in one pass over the arrays, instead of one pass per term. The kernel is
+ * chosen at the first call from the instruction sets of the processor (CPUID): AVX-512, AVX2, SSE2, or a portable
+ * loop on other processors. Without FMA, the vector kernels give the same values as the portable loop; with it, the
+ * values may differ in the last bit.
+ */
+class LinearCombination {
+public:
+    static void Compute(size_t n, const double *y, double h, unsigned int m, const double *c, const double *const *k,
+                        double *result);
+
+    static InstructionSet GetInstructionSet();
+    static bool IsSupported(InstructionSet set);
+    static void SetInstructionSet(InstructionSet set);
+    static const char *GetName(InstructionSet set);
+
+private:
+    typedef void (*Kernel)(size_t n, const double *y, double h, unsigned int m, const double *c,
+                           const double *const *k, double *result);
+    static Kernel GetKernel(InstructionSet set);
+    static InstructionSet Best();
+    // kernel of the selected instruction set, nullptr until the first call
+    static std::atomic<Kernel> kernel;
+    static std::atomic<InstructionSet> selected;
+};
+
+
+#endif //PCSC_PROJECT_LINEARCOMBINATION_H
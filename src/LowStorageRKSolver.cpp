@@ -0,0 +1,153 @@
+#include "LowStorageRKSolver.h"
+#include "SetOrderException.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+LowStorageRKSolver::LowStorageRKSolver() : AbstractExplicitSolver() {
+    /**
+    Constructor of a low-storage Runge Kutta solver instance.
+    */
+    LowStorageRKSolver::SetOrder(1);
+}
+
+LowStorageRKSolver::LowStorageRKSolver(const double h, const double t0, const double t1, const double y0,
+                                       double (*f)(double, double), const unsigned int s)
+                                       : AbstractExplicitSolver(h,t0,t1,y0,f,s) {
+    /**
+    Constructor of a low-storage Runge Kutta solver instance, where each parameter are defined from outside the class.
+    */
+    LowStorageRKSolver::SetOrder(s);
+}
+
+LowStorageRKSolver::~LowStorageRKSolver() = default;
+
+void LowStorageRKSolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: order that will be set for the low-storage Runge Kutta method.
+*/
+    try {
+        if(order < 1) {
+            throw SetOrderException("Order of the low-storage RK solver should be bigger or equal to 1.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 1. ");
+        order = 1;
+    }
+    try {
+        if (order > max_rk_order) {
+            throw SetOrderException("Order of the low-storage RK solver should be smaller or equal to 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "the order is set to the maximum order : 4.");
+        order = max_rk_order;
+    }
+    AbstractOdeSolver::SetOrder(order);
+    SetB();
+    const unsigned int number_of_stages[max_rk_order] = {1, 2, 3, 5};
+    stages = number_of_stages[order-1];
+}
+
+void LowStorageRKSolver::SetB() {
+    /**
+   * Set the coefficients A_j, B_j and c_j of the 2N form for each order. Row order-1 of b contains the B_j: unlike
+     the weights of RKSolver, they do not sum to 1. <br>
+     order = 1: Forward Euler (first order) <br>
+     order = 2: Heun's method <br>
+     order = 3: Williamson's third-order method <br>
+     order = 4: Carpenter and Kennedy's RK4(3)5[2N] <br>
+   *
+   */
+    // s = 1: Forward Euler (first order)
+    a[0][0] = 0.;
+    b[0][0] = 1.;
+    c[0][0] = 0.;
+    // s = 2: Heun's method
+    a[1][0] = 0.;
+    a[1][1] = -1.;
+    b[1][0] = 1.;
+    b[1][1] = 1./2;
+    c[1][0] = 0.;
+    c[1][1] = 1.;
+    // s = 3: Williamson's third-order method
+    a[2][0] = 0.;
+    a[2][1] = -5./9;
+    a[2][2] = -153./128;
+    b[2][0] = 1./3;
+    b[2][1] = 15./16;
+    b[2][2] = 8./15;
+    c[2][0] = 0.;
+    c[2][1] = 1./3;
+    c[2][2] = 3./4;
+    // s = 4: Carpenter and Kennedy's RK4(3)5[2N]
+    a[3][0] = 0.;
+    a[3][1] = -567301805773./1357537059087;
+    a[3][2] = -2404267990393./2016746695238;
+    a[3][3] = -3550918686646./2091501179385;
+    a[3][4] = -1275806237668./842570457699;
+    b[3][0] = 1432997174477./9575080441755;
+    b[3][1] = 5161836677717./13612068292357;
+    b[3][2] = 1720146321549./2090206949498;
+    b[3][3] = 3134564353537./4481467310338;
+    b[3][4] = 2277821191437./14882151754819;
+    c[3][0] = 0.;
+    c[3][1] = 1432997174477./9575080441755;
+    c[3][2] = 2526269341429./6820363962896;
+    c[3][3] = 2006345519317./3224310063776;
+    c[3][4] = 2802321613138./2924317926251;
+}
+
+void LowStorageRKSolver::Solve(AbstractOutputSink &sink) {
+    /*!
+   * Low-storage Runge Kutta methods for the scalar ODE in the form y'(t)=f(y,t). Only the registers y and dy are
+   * updated by the stages, and each sensitivity has the same two registers.
+
+   * \param sink: sink receiving the numerical solution at each time t
+   */
+    double y = GetInitialValue();
+    double t = GetInitialTime();
+    const double h = GetStepSize();
+    const unsigned int order = GetOrder();
+    const double *A = a[order-1];
+    const double *B = b[order-1];
+    const double *C = c[order-1];
+    assert(h > 1e-6);
+
+    int n = static_cast<int>(std::floor((GetFinalTime() - GetInitialTime()) / h));
+    sink.Reserve(n + 1);
+    Output(sink, t, y);
+    // sensitivities S_p and their registers dS_p, integrated with the same method
+    const unsigned int m = sensitivity != nullptr ? sensitivity->Size() : 0;
+    std::vector<double> S(m);
+    std::vector<double> dS(m);
+    if (sensitivity != nullptr) {
+        for (unsigned int p = 0; p < m; p++) {
+            S[p] = sensitivity->GetInitialSensitivity(p);
+        }
+        sensitivity->Start(n + 1);
+        sensitivity->Record(S.data());
+    }
+    double dy = 0.;
+    for (int i = 1; i <= n; ++i) {
+        for (unsigned int j = 0; j < stages; j++) {
+            const double t_j = t + C[j]*h;
+            if (m > 0) {
+                // the stages of the sensitivities are evaluated at the stage value of y, before it is updated
+                const double J = sensitivity->Jacobian(y, t_j);
+                for (unsigned int p = 0; p < m; p++) {
+                    dS[p] = A[j]*dS[p] + h*(J*S[p] + sensitivity->Forcing(p, y, t_j));
+                    S[p] += B[j]*dS[p];
+                }
+            }
+            dy = A[j]*dy + h*RightHandSide(y, t_j);
+            y += B[j]*dy;
+        }
+        t += h;
+        //pass the values to the sink
+        Output(sink, t, y);
+        if (m > 0) {
+            sensitivity->Record(S.data());
+        }
+    }
+}
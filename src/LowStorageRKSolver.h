@@ -0,0 +1,47 @@
+#ifndef PCSC_PROJECT_LOWSTORAGERKSOLVER_H
+#define PCSC_PROJECT_LOWSTORAGERKSOLVER_H
+
+#include "RKSolver.h"
+
+/** Daughter of Abstract Explicit Solver class.
+ * The low-storage Runge-Kutta solver uses explicit Runge-Kutta methods written in Williamson's 2N form: for
+ * \f$ j = 1, \dots, s \f$ <br>
+ * \f$ \Delta_j = A_j \Delta_{j-1} + h f(t_n + c_j h, Y_{j-1}), \quad Y_j = Y_{j-1} + B_j \Delta_j \f$ <br>
+ * with \f$ Y_0 = y_n \f$, \f$ A_1 = 0 \f$ and \f$ y_{n+1} = Y_s \f$. Only the two registers \f$ Y \f$ and
+ * \f$ \Delta \f$ are kept, whatever the number of stages, instead of one register per stage for RKSolver: for a
+ * system with a very large state, this is the memory of two copies of the state, and two streams through memory per
+ * stage. The methods of order 3 and 4 need more stages than those of RKSolver. <br>
+ * The implemented methods with different order are: <br>
+ * order = 1: Forward Euler (first order) <br>
+ * order = 2: Heun's method <br>
+ * order = 3: Williamson's third-order method, 3 stages <br>
+ * order = 4: Carpenter and Kennedy's RK4(3)5[2N], 5 stages <br>
+ */
+class LowStorageRKSolver : public AbstractExplicitSolver {
+public:
+    LowStorageRKSolver();
+    LowStorageRKSolver(double h, double t0, double t1, double y0, double (*f)(double y, double t), unsigned int s);
+    ~LowStorageRKSolver() override;
+    void SetOrder(unsigned int order) override;
+
+    /** number of stages of the method of the current order*/
+    unsigned int GetStages() const { return stages; }
+    /** maximum number of stages of the implemented methods*/
+    static const unsigned int max_stages = 5;
+
+private:
+    unsigned int stages;
+    // coefficients A_j, B_j and c_j of the 2N form, for each order
+    double a[max_rk_order][max_stages];
+    double c[max_rk_order][max_stages];
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    bool SupportsSensitivity(const ForwardSensitivity &sensitivity) const override {
+        return sensitivity.HasJacobian();
+    }
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_LOWSTORAGERKSOLVER_H
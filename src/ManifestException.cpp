@@ -0,0 +1,3 @@
+#include "ManifestException.h"
+
+ManifestException::ManifestException(std::string probString) : Exception("MANIFEST", probString){}
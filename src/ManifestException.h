@@ -0,0 +1,13 @@
+#ifndef PCSC_PROJECT_MANIFESTEXCEPTION_H
+#define PCSC_PROJECT_MANIFESTEXCEPTION_H
+
+#include "Exception.hpp"
+
+/** Daughter of Exception class. Is thrown when a job manifest cannot be read or contains an invalid job.*/
+class ManifestException : public Exception{
+public:
+    ManifestException(std::string probString);
+};
+
+
+#endif //PCSC_PROJECT_MANIFESTEXCEPTION_H
@@ -0,0 +1,103 @@
+#include "MappedOutputSink.h"
+#include "FileNotOpenException.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+const char MappedOutputSink::magic[8] = {'O', 'D', 'E', 'T', 'R', 'A', 'J', '1'};
+
+MappedOutputSink::MappedOutputSink(const std::string &filename, bool hugePages)
+    /**
+    * Constructor creating (or truncating) the binary file. Nothing is mapped until the first record.
+    * \param filename: name of the binary file
+    * \param hugePages: advise the kernel to back the mapping with huge pages
+    */
+    : filename(filename), hugePages(hugePages), mapping(nullptr), records(nullptr), capacity(0), numberOfRecords(0) {
+    fileDescriptor = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0) {
+        throw FileNotOpenException("File " + filename + " can't be opened.");
+    }
+}
+
+MappedOutputSink::~MappedOutputSink() {
+    Close();
+}
+
+void MappedOutputSink::Reserve(unsigned long records) {
+    /*! Size the file for the records about to be written, in a single step
+    * \param records: number of records that are about to be written
+    */
+    if (numberOfRecords + records > capacity) {
+        Grow(numberOfRecords + records);
+    }
+}
+
+void MappedOutputSink::Flush() {
+    /*! Write the number of records in the header, so that the file can be read while the solver runs
+    */
+    if (mapping != nullptr) {
+        const uint64_t count = numberOfRecords;
+        std::memcpy(mapping + sizeof(magic), &count, sizeof(count));
+    }
+}
+
+void MappedOutputSink::Close() {
+    /*! Unmap the file and truncate it to the records written. Nothing can be written afterwards.
+    */
+    if (fileDescriptor < 0) {
+        return;
+    }
+    bool written;
+    if (mapping == nullptr) {
+        // no record: the file only contains the header
+        char header[headerSize] = {};
+        std::memcpy(header, magic, sizeof(magic));
+        written = pwrite(fileDescriptor, header, headerSize, 0) == static_cast<ssize_t>(headerSize);
+    } else {
+        Flush();
+        Unmap();
+        written = ftruncate(fileDescriptor, headerSize + 2*sizeof(double)*numberOfRecords) == 0;
+    }
+    if (!written) {
+        std::perror(filename.c_str());
+    }
+    close(fileDescriptor);
+    fileDescriptor = -1;
+}
+
+void MappedOutputSink::Grow(unsigned long newCapacity) {
+    /*! Extend the file and map it again.
+    * \param newCapacity: number of records the mapping can hold
+    */
+    Flush();
+    Unmap();
+    const size_t length = headerSize + 2*sizeof(double)*newCapacity;
+    void *address = MAP_FAILED;
+    if (ftruncate(fileDescriptor, length) == 0) {
+        address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    }
+    if (address == MAP_FAILED) {
+        throw FileNotOpenException("File " + filename + " can't be mapped in memory.");
+    }
+    mapping = static_cast<char *>(address);
+    records = reinterpret_cast<double *>(mapping + headerSize);
+    capacity = newCapacity;
+    std::memcpy(mapping, magic, sizeof(magic));
+    Flush();
+    madvise(address, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        madvise(address, length, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+void MappedOutputSink::Unmap() {
+    if (mapping != nullptr) {
+        munmap(mapping, headerSize + 2*sizeof(double)*capacity);
+        mapping = nullptr;
+        records = nullptr;
+    }
+}
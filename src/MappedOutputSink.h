@@ -0,0 +1,55 @@
+#ifndef PCSC_PROJECT_MAPPEDOUTPUTSINK_H
+#define PCSC_PROJECT_MAPPEDOUTPUTSINK_H
+
+#include "AbstractOutputSink.h"
+#include <cstdint>
+#include <string>
+
+/** Daughter of AbstractOutputSink. Writes the records in a binary file mapped in memory, so that writing a record
+ * is two stores, without any system call or formatting. <br>
+ * The file starts with a header of 16 bytes: the magic string "ODETRAJ1" and the number of records (uint64), followed
+ * by the records, each made of the time t and the solution y as two doubles in the byte order of the machine. <br>
+ * The file is sized once when the solver announces its number of steps (see AbstractOutputSink::Reserve). The
+ * adaptive solvers do not know it: the mapping is then doubled when it is full. On Close, the file is truncated
+ * to the records actually written. <br>
+ * The mapping is advised as sequential. Huge pages can be requested as well; this is only a hint, which the
+ * kernel follows for file systems supporting them (e.g. tmpfs with transparent huge pages).
+ */
+class MappedOutputSink : public AbstractOutputSink {
+public:
+    explicit MappedOutputSink(const std::string &filename, bool hugePages = false);
+    ~MappedOutputSink() override;
+
+    void Write(double t, double y) override {
+        if (numberOfRecords == capacity) {
+            Grow(capacity == 0 ? 4096 : 2*capacity);
+        }
+        double *record = records + 2*numberOfRecords;
+        record[0] = t;
+        record[1] = y;
+        ++numberOfRecords;
+    }
+    void Reserve(unsigned long records) override;
+    void Flush() override;
+    void Close();
+
+    unsigned long GetNumberOfRecords() const { return numberOfRecords; }
+
+    static const char magic[8];
+    static const size_t headerSize = 16;
+
+private:
+    void Grow(unsigned long newCapacity);
+    void Unmap();
+
+    std::string filename;
+    bool hugePages;
+    int fileDescriptor;
+    char *mapping;
+    double *records;
+    unsigned long capacity;
+    unsigned long numberOfRecords;
+};
+
+
+#endif //PCSC_PROJECT_MAPPEDOUTPUTSINK_H
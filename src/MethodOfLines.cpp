@@ -0,0 +1,263 @@
+#include "MethodOfLines.h"
+#include "UncoherentValueException.h"
+
+#include <algorithm>
+#include <utility>
+
+MethodOfLines MethodOfLines::Heat1D(const size_t n, const double length, const double diffusion,
+                                    const Boundary boundary) {
+    /*! Heat equation \f$ u_t = D u_{xx} \f$ on [0, length]
+    * \param n: number of unknowns
+    * \param length: length of the segment
+    * \param diffusion: diffusion coefficient D
+    * \param boundary: boundary condition
+    * \return The semi-discretization
+    */
+    return ReactionDiffusion1D(n, length, diffusion, nullptr, nullptr, nullptr, boundary);
+}
+
+MethodOfLines MethodOfLines::Heat2D(const size_t nx, const size_t ny, const double length_x, const double length_y,
+                                    const double diffusion, const Boundary boundary) {
+    /*! Heat equation \f$ u_t = D (u_{xx} + u_{yy}) \f$ on [0, length_x] x [0, length_y]
+    * \param nx: number of unknowns in the x direction
+    * \param ny: number of unknowns in the y direction
+    * \param length_x: length of the rectangle in the x direction
+    * \param length_y: length of the rectangle in the y direction
+    * \param diffusion: diffusion coefficient D
+    * \param boundary: boundary condition
+    * \return The semi-discretization
+    */
+    return ReactionDiffusion2D(nx, ny, length_x, length_y, diffusion, nullptr, nullptr, nullptr, boundary);
+}
+
+MethodOfLines MethodOfLines::Advection1D(const size_t n, const double length, const double velocity,
+                                         const Boundary boundary) {
+    /*! Advection equation \f$ u_t + v u_x = 0 \f$ on [0, length], with the first-order upwind scheme
+    * \param n: number of unknowns
+    * \param length: length of the segment
+    * \param velocity: velocity v
+    * \param boundary: boundary condition
+    * \return The semi-discretization
+    */
+    if (n == 0 || length <= 0) {
+        throw UncoherentValueException("The grid needs at least one point and a positive length.");
+    }
+    const double dx = length/(boundary == Boundary::Periodic ? n : n + 1);
+    return MethodOfLines(n, 1, dx, 1., 0., velocity, 0., boundary);
+}
+
+MethodOfLines MethodOfLines::ReactionDiffusion1D(const size_t n, const double length, const double diffusion,
+                                                 double (*r)(double, double, void *),
+                                                 double (*drdu)(double, double, void *), void *context,
+                                                 const Boundary boundary) {
+    /*! Reaction-diffusion equation \f$ u_t = D u_{xx} + r(u,t) \f$ on [0, length]
+    * \param n: number of unknowns
+    * \param length: length of the segment
+    * \param diffusion: diffusion coefficient D
+    * \param r: reaction r(u,t,context), nullptr for none
+    * \param drdu: derivative of the reaction with respect to u, needed by Jacobian
+    * \param context: pointer given to each call of r and drdu
+    * \param boundary: boundary condition
+    * \return The semi-discretization
+    */
+    if (n == 0 || length <= 0) {
+        throw UncoherentValueException("The grid needs at least one point and a positive length.");
+    }
+    const double dx = length/(boundary == Boundary::Periodic ? n : n + 1);
+    MethodOfLines system(n, 1, dx, 1., diffusion, 0., 0., boundary);
+    system.SetReaction(r, drdu, context);
+    return system;
+}
+
+MethodOfLines MethodOfLines::ReactionDiffusion2D(const size_t nx, const size_t ny, const double length_x,
+                                                 const double length_y, const double diffusion,
+                                                 double (*r)(double, double, void *),
+                                                 double (*drdu)(double, double, void *), void *context,
+                                                 const Boundary boundary) {
+    /*! Reaction-diffusion equation \f$ u_t = D (u_{xx} + u_{yy}) + r(u,t) \f$ on [0, length_x] x [0, length_y]
+    * \param nx: number of unknowns in the x direction
+    * \param ny: number of unknowns in the y direction
+    * \param length_x: length of the rectangle in the x direction
+    * \param length_y: length of the rectangle in the y direction
+    * \param diffusion: diffusion coefficient D
+    * \param r: reaction r(u,t,context), nullptr for none
+    * \param drdu: derivative of the reaction with respect to u, needed by Jacobian
+    * \param context: pointer given to each call of r and drdu
+    * \param boundary: boundary condition
+    * \return The semi-discretization
+    */
+    if (nx == 0 || ny == 0 || length_x <= 0 || length_y <= 0) {
+        throw UncoherentValueException("The grid needs at least one point and positive lengths.");
+    }
+    const size_t intervals_x = boundary == Boundary::Periodic ? nx : nx + 1;
+    const size_t intervals_y = boundary == Boundary::Periodic ? ny : ny + 1;
+    MethodOfLines system(nx, ny, length_x/intervals_x, length_y/intervals_y, diffusion, 0., 0., boundary);
+    system.SetReaction(r, drdu, context);
+    return system;
+}
+
+MethodOfLines::MethodOfLines(const size_t nx, const size_t ny, const double dx, const double dy,
+                             const double diffusion, const double velocity_x, const double velocity_y,
+                             const Boundary boundary)
+    : nx(nx), ny(ny), dx(dx), dy(dy), boundary(boundary), reaction(nullptr), dReaction(nullptr), context(nullptr),
+      blockSize(1024), zeros(nx, 0.) {
+    /*!
+    * \param nx: number of unknowns in the x direction
+    * \param ny: number of unknowns in the y direction, 1 for a segment
+    * \param dx: step of the grid in the x direction
+    * \param dy: step of the grid in the y direction, not used for a segment
+    * \param diffusion: diffusion coefficient
+    * \param velocity_x: velocity in the x direction
+    * \param velocity_y: velocity in the y direction, not used for a segment
+    * \param boundary: boundary condition
+    */
+    if (nx == 0 || ny == 0 || dx <= 0 || dy <= 0) {
+        throw UncoherentValueException("The grid needs at least one point and positive steps.");
+    }
+    if (diffusion < 0) {
+        throw UncoherentValueException("The diffusion coefficient must be positive.");
+    }
+    // upwind differences: the advection only adds to the coefficient of the upstream neighbour
+    west = diffusion/(dx*dx) + std::max(velocity_x, 0.)/dx;
+    east = diffusion/(dx*dx) + std::max(-velocity_x, 0.)/dx;
+    if (ny > 1) {
+        south = diffusion/(dy*dy) + std::max(velocity_y, 0.)/dy;
+        north = diffusion/(dy*dy) + std::max(-velocity_y, 0.)/dy;
+    } else {
+        south = 0.;
+        north = 0.;
+    }
+    center = -(west + east + south + north);
+    BuildSparsity();
+}
+
+void MethodOfLines::SetReaction(double (*r)(double, double, void *), double (*drdu)(double, double, void *),
+                                void *context) {
+    /*! Set the reaction term r(u,t) of the equation
+    * \param r: reaction r(u,t,context), nullptr for none
+    * \param drdu: derivative of the reaction with respect to u, needed by Jacobian
+    * \param context: pointer given to each call of r and drdu, which must live as long as the system
+    */
+    reaction = r;
+    dReaction = drdu;
+    this->context = context;
+}
+
+void MethodOfLines::SetBlockSize(const size_t columns) {
+    /*! Set the width of the tiles of columns swept by RightHandSide. The three rows of a tile read by the stencil
+    * should fit in the cache: the default 1024 columns use 24 kB.
+    * \param columns: number of columns of a tile, at least 1
+    */
+    if (columns == 0) {
+        throw UncoherentValueException("The tiles need at least one column.");
+    }
+    blockSize = columns;
+}
+
+double MethodOfLines::EdgePoint(const double *row, const double *row_south, const double *row_north,
+                                const size_t i) const {
+    /*!
+    * \param row: row of the point
+    * \param row_south: row below, or zeros
+    * \param row_north: row above, or zeros
+    * \param i: first or last index of the row
+    * \return The linear part of F at the point, whose west or east neighbour is outside of the grid
+    */
+    const bool periodic = boundary == Boundary::Periodic;
+    const double u_west = i > 0 ? row[i-1] : (periodic ? row[nx-1] : 0.);
+    const double u_east = i + 1 < nx ? row[i+1] : (periodic ? row[0] : 0.);
+    return center*row[i] + west*u_west + east*u_east + south*row_south[i] + north*row_north[i];
+}
+
+void MethodOfLines::RightHandSide(const double *u, const double t, double *du) const {
+    /*! Evaluate the right hand side of the system
+    * \param u: values of the unknowns, Size() values
+    * \param t: time
+    * \param du: values of F(u,t), Size() values, which must not overlap u
+    */
+    const bool periodic = boundary == Boundary::Periodic && ny > 1;
+    for (size_t first = 0; first < nx; first += blockSize) {
+        const size_t last = std::min(first + blockSize, nx);
+        // interior points of the tile, whose west and east neighbours are in the row
+        const size_t begin = std::max<size_t>(first, 1);
+        const size_t end = std::min(last, nx - 1);
+        for (size_t j = 0; j < ny; j++) {
+            const double *row = u + j*nx;
+            const double *s = j > 0 ? row - nx : (periodic ? u + (ny-1)*nx : zeros.data());
+            const double *n = j + 1 < ny ? row + nx : (periodic ? u : zeros.data());
+            double *out = du + j*nx;
+            for (size_t i = begin; i < end; i++) {
+                out[i] = center*row[i] + west*row[i-1] + east*row[i+1] + south*s[i] + north*n[i];
+            }
+            if (first == 0) {
+                out[0] = EdgePoint(row, s, n, 0);
+            }
+            if (last == nx && nx > 1) {
+                out[nx-1] = EdgePoint(row, s, n, nx-1);
+            }
+            if (reaction != nullptr) {
+                for (size_t i = first; i < last; i++) {
+                    out[i] += reaction(row[i], t, context);
+                }
+            }
+        }
+    }
+}
+
+void MethodOfLines::BuildSparsity() {
+    /*! Build the sparsity pattern of the Jacobian, the values of its linear part and the position of the diagonal
+    * entries. With periodic conditions on small grids, several neighbours can be the same unknown: their coefficients
+    * are added.
+    */
+    const bool periodic = boundary == Boundary::Periodic;
+    const size_t size = nx*ny;
+    sparsity.rowStart.assign(1, 0);
+    sparsity.columns.clear();
+    linearValues.clear();
+    diagonal.resize(size);
+    std::vector<std::pair<size_t, double>> entries;
+    for (size_t k = 0; k < size; k++) {
+        const size_t i = k % nx;
+        const size_t j = k / nx;
+        entries.assign(1, {k, center});
+        if (i > 0 || periodic) {
+            entries.push_back({j*nx + (i > 0 ? i-1 : nx-1), west});
+        }
+        if (i + 1 < nx || periodic) {
+            entries.push_back({j*nx + (i + 1 < nx ? i+1 : 0), east});
+        }
+        if (ny > 1 && (j > 0 || periodic)) {
+            entries.push_back({(j > 0 ? j-1 : ny-1)*nx + i, south});
+        }
+        if (ny > 1 && (j + 1 < ny || periodic)) {
+            entries.push_back({(j + 1 < ny ? j+1 : 0)*nx + i, north});
+        }
+        std::sort(entries.begin(), entries.end());
+        for (size_t e = 0; e < entries.size(); e++) {
+            if (e > 0 && entries[e].first == entries[e-1].first) {
+                linearValues.back() += entries[e].second;
+                continue;
+            }
+            if (entries[e].first == k) {
+                diagonal[k] = sparsity.columns.size();
+            }
+            sparsity.columns.push_back(entries[e].first);
+            linearValues.push_back(entries[e].second);
+        }
+        sparsity.rowStart.push_back(sparsity.columns.size());
+    }
+}
+
+void MethodOfLines::Jacobian(const double *u, const double t, double *values) const {
+    /*! Evaluate the Jacobian dF/du in the sparsity pattern given by GetSparsity
+    * \param u: values of the unknowns, Size() values
+    * \param t: time
+    * \param values: values of the non-zero entries, in the order of the columns of the sparsity pattern
+    */
+    std::copy(linearValues.begin(), linearValues.end(), values);
+    if (dReaction != nullptr) {
+        for (size_t k = 0; k < nx*ny; k++) {
+            values[diagonal[k]] += dReaction(u[k], t, context);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef PCSC_PROJECT_METHODOFLINES_H
+#define PCSC_PROJECT_METHODOFLINES_H
+
+#include <cstddef>
+#include <vector>
+
+/** Boundary condition of a MethodOfLines grid.*/
+enum class Boundary {
+    /** u = 0 outside of the domain*/
+    Dirichlet,
+    Periodic
+};
+
+/** Sparsity pattern of a Jacobian in compressed sparse row format: the columns of the non-zero entries of row i are
+ * columns[rowStart[i]], ..., columns[rowStart[i+1]-1], in increasing order.*/
+struct SparsityPattern {
+    std::vector<size_t> rowStart;
+    std::vector<size_t> columns;
+};
+
+/** Semi-discretization in space of the reaction-advection-diffusion equation
+ * \f$ u_t = D \Delta u - v \cdot \nabla u + r(u,t) \f$ on a rectangle (or a segment), which gives a system of
+ * ODEs \f$ U' = F(U,t) \f$ with one unknown per point of a uniform grid. <br>
+ * The Laplacian is discretized with the 3-point (1D) or 5-point (2D) stencil and the advection with the first-order
+ * upwind scheme, so that the linear part of F is one constant 5-point stencil. The unknowns are stored row by row
+ * (the index of point (i,j) is j*nx + i). <br>
+ * RightHandSide applies the stencil and the reaction in one pass, without branches in the inner loop, which the
+ * compiler vectorizes. The grid is swept by tiles of columns, so that the three rows of a tile read by the stencil
+ * stay in cache for large grids. <br>
+ * The sparsity pattern and the values of the Jacobian are given for implicit methods. The solvers of this project
+ * integrate scalar equations: the system is the workload of an integrator of systems.
+ */
+class MethodOfLines {
+public:
+    static MethodOfLines Heat1D(size_t n, double length, double diffusion, Boundary boundary = Boundary::Dirichlet);
+    static MethodOfLines Heat2D(size_t nx, size_t ny, double length_x, double length_y, double diffusion,
+                                Boundary boundary = Boundary::Dirichlet);
+    static MethodOfLines Advection1D(size_t n, double length, double velocity, Boundary boundary = Boundary::Periodic);
+    static MethodOfLines ReactionDiffusion1D(size_t n, double length, double diffusion,
+                                             double (*r)(double u, double t, void *context),
+                                             double (*drdu)(double u, double t, void *context), void *context,
+                                             Boundary boundary = Boundary::Dirichlet);
+    static MethodOfLines ReactionDiffusion2D(size_t nx, size_t ny, double length_x, double length_y, double diffusion,
+                                             double (*r)(double u, double t, void *context),
+                                             double (*drdu)(double u, double t, void *context), void *context,
+                                             Boundary boundary = Boundary::Dirichlet);
+    MethodOfLines(size_t nx, size_t ny, double dx, double dy, double diffusion, double velocity_x, double velocity_y,
+                  Boundary boundary);
+
+    void SetReaction(double (*r)(double u, double t, void *context),
+                     double (*drdu)(double u, double t, void *context), void *context);
+    void SetBlockSize(size_t columns);
+
+    void RightHandSide(const double *u, double t, double *du) const;
+    void Jacobian(const double *u, double t, double *values) const;
+    const SparsityPattern &GetSparsity() const { return sparsity; }
+
+    size_t Size() const { return nx*ny; }
+    size_t GetNx() const { return nx; }
+    size_t GetNy() const { return ny; }
+    double GetDx() const { return dx; }
+    double GetDy() const { return dy; }
+    /** coordinates of the point of index k, the grid starting at dx (Dirichlet) or 0 (periodic) in each direction*/
+    double GetX(size_t k) const { return (k % nx + (boundary == Boundary::Dirichlet ? 1 : 0))*dx; }
+    double GetY(size_t k) const { return (k / nx + (boundary == Boundary::Dirichlet ? 1 : 0))*dy; }
+    size_t GetBlockSize() const { return blockSize; }
+
+private:
+    void BuildSparsity();
+    double EdgePoint(const double *row, const double *row_south, const double *row_north, size_t i) const;
+
+    size_t nx;
+    size_t ny;
+    double dx;
+    double dy;
+    Boundary boundary;
+    // coefficients of the stencil: center, west (i-1), east (i+1), south (j-1) and north (j+1)
+    double center;
+    double west;
+    double east;
+    double south;
+    double north;
+    double (*reaction)(double u, double t, void *context);
+    double (*dReaction)(double u, double t, void *context);
+    void *context;
+    size_t blockSize;
+    // row of zeros, neighbour of the first and last rows with Dirichlet conditions
+    std::vector<double> zeros;
+    SparsityPattern sparsity;
+    // values of the linear part of the Jacobian, and position of the diagonal entry of each row
+    std::vector<double> linearValues;
+    std::vector<size_t> diagonal;
+};
+
+
+#endif //PCSC_PROJECT_METHODOFLINES_H
@@ -0,0 +1,33 @@
+#include "PIDStepSizeController.h"
+#include <algorithm>
+#include <cmath>
+
+PIDStepSizeController::PIDStepSizeController(const double beta1, const double beta2, const double beta3,
+                                             const double safety, const double minFactor, const double maxFactor)
+    : AbstractStepSizeController(safety, minFactor, maxFactor), beta{beta1, beta2, beta3}, previousErrors{1., 1.} {}
+
+void PIDStepSizeController::Accept(const double error) {
+    /*!
+    * \param error: error of the accepted step divided by the tolerance
+    */
+    AbstractStepSizeController::Accept(error);
+    previousErrors[1] = previousErrors[0];
+    previousErrors[0] = std::max(error, 1e-10);
+}
+
+void PIDStepSizeController::Reset() {
+    /*! Forget the previous steps
+    */
+    AbstractStepSizeController::Reset();
+    previousErrors[0] = 1.;
+    previousErrors[1] = 1.;
+}
+
+double PIDStepSizeController::RawFactor(const double error, const unsigned int k) const {
+    /*!
+    * \param error: error of the step divided by the tolerance
+    * \param k: order of the error estimate
+    * \return \f$ (1/err_n)^{\beta_1/k} (1/err_{n-1})^{\beta_2/k} (1/err_{n-2})^{\beta_3/k} \f$
+    */
+    return std::pow(error, -beta[0]/k)*std::pow(previousErrors[0], -beta[1]/k)*std::pow(previousErrors[1], -beta[2]/k);
+}
@@ -0,0 +1,28 @@
+#ifndef PCSC_PROJECT_PIDSTEPSIZECONTROLLER_H
+#define PCSC_PROJECT_PIDSTEPSIZECONTROLLER_H
+
+#include "AbstractStepSizeController.h"
+
+/** Daughter of AbstractStepSizeController. Proportional-integral-derivative controller (digital filter of
+ * Söderlind): the factor is \f$ (1/err_n)^{\beta_1/k} (1/err_{n-1})^{\beta_2/k} (1/err_{n-2})^{\beta_3/k} \f$, from
+ * the errors of the two previous accepted steps. With \f$ \beta_2 = \beta_3 = 0 \f$ it is the I controller, with
+ * \f$ \beta_3 = 0 \f$ a PI controller.
+ */
+class PIDStepSizeController : public AbstractStepSizeController {
+public:
+    explicit PIDStepSizeController(double beta1 = 0.49, double beta2 = -0.34, double beta3 = 0.1, double safety = 0.9,
+                                   double minFactor = 0.2, double maxFactor = 5.);
+
+    void Accept(double error) override;
+    void Reset() override;
+
+protected:
+    double RawFactor(double error, unsigned int k) const override;
+
+private:
+    double beta[3];
+    double previousErrors[2];
+};
+
+
+#endif //PCSC_PROJECT_PIDSTEPSIZECONTROLLER_H
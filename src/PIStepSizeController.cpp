@@ -0,0 +1,31 @@
+#include "PIStepSizeController.h"
+#include <algorithm>
+#include <cmath>
+
+PIStepSizeController::PIStepSizeController(const double alpha, const double beta, const double safety,
+                                           const double minFactor, const double maxFactor)
+    : AbstractStepSizeController(safety, minFactor, maxFactor), alpha(alpha), beta(beta), previousError(1.) {}
+
+void PIStepSizeController::Accept(const double error) {
+    /*!
+    * \param error: error of the accepted step divided by the tolerance
+    */
+    AbstractStepSizeController::Accept(error);
+    previousError = std::max(error, 1e-10);
+}
+
+void PIStepSizeController::Reset() {
+    /*! Forget the previous steps
+    */
+    AbstractStepSizeController::Reset();
+    previousError = 1.;
+}
+
+double PIStepSizeController::RawFactor(const double error, const unsigned int k) const {
+    /*!
+    * \param error: error of the step divided by the tolerance
+    * \param k: order of the error estimate
+    * \return \f$ (1/err_n)^{\alpha/k} (err_{n-1})^{\beta/k} \f$
+    */
+    return std::pow(error, -alpha/k)*std::pow(previousError, beta/k);
+}
@@ -0,0 +1,29 @@
+#ifndef PCSC_PROJECT_PISTEPSIZECONTROLLER_H
+#define PCSC_PROJECT_PISTEPSIZECONTROLLER_H
+
+#include "AbstractStepSizeController.h"
+
+/** Daughter of AbstractStepSizeController. Proportional-integral controller of Gustafsson: the factor is
+ * \f$ (1/err_n)^{\alpha/k} (err_{n-1})^{\beta/k} \f$, where \f$ err_{n-1} \f$ is the error of the previous accepted
+ * step. The proportional term damps the oscillations of the step size of the I controller, e.g. when the stability
+ * of the method limits the step size.
+ */
+class PIStepSizeController : public AbstractStepSizeController {
+public:
+    explicit PIStepSizeController(double alpha = 0.7, double beta = 0.4, double safety = 0.9, double minFactor = 0.2,
+                                  double maxFactor = 5.);
+
+    void Accept(double error) override;
+    void Reset() override;
+
+protected:
+    double RawFactor(double error, unsigned int k) const override;
+
+private:
+    double alpha;
+    double beta;
+    double previousError;
+};
+
+
+#endif //PCSC_PROJECT_PISTEPSIZECONTROLLER_H
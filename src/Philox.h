@@ -0,0 +1,71 @@
+#ifndef PCSC_PROJECT_PHILOX_H
+#define PCSC_PROJECT_PHILOX_H
+
+#include <cmath>
+#include <cstdint>
+
+/** Counter-based random number generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3", 2011). <br>
+ * The random numbers are a function of a 128-bit counter and a 64-bit key, computed with 10 rounds of
+ * multiplications and exclusive or: there is no state to share or to advance, so that the number of a given counter
+ * is the same whatever the thread, the order or the vector lane which computes it. A stream is reproduced by giving
+ * the same key and counters, e.g. the seed as key and the index of the path and of the step as counter.
+ */
+class Philox4x32 {
+public:
+    explicit Philox4x32(uint64_t key) : key{static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)} {}
+
+    /** Four random 32-bit integers of the counter, written in out.*/
+    void Generate(const uint32_t counter[4], uint32_t out[4]) const {
+        uint32_t x[4] = {counter[0], counter[1], counter[2], counter[3]};
+        uint32_t k[2] = {key[0], key[1]};
+        for (int round = 0; round < 10; round++) {
+            if (round > 0) {
+                k[0] += 0x9E3779B9u;
+                k[1] += 0xBB67AE85u;
+            }
+            const uint64_t product0 = static_cast<uint64_t>(0xD2511F53u)*x[0];
+            const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u)*x[2];
+            const uint32_t y[4] = {static_cast<uint32_t>(product1 >> 32) ^ x[1] ^ k[0],
+                                   static_cast<uint32_t>(product1),
+                                   static_cast<uint32_t>(product0 >> 32) ^ x[3] ^ k[1],
+                                   static_cast<uint32_t>(product0)};
+            x[0] = y[0];
+            x[1] = y[1];
+            x[2] = y[2];
+            x[3] = y[3];
+        }
+        out[0] = x[0];
+        out[1] = x[1];
+        out[2] = x[2];
+        out[3] = x[3];
+    }
+
+    /** Two independent standard normal numbers of the counter (a, b), written in z0 and z1: the 128 random bits give
+     * two uniform numbers of 52 bits in (0, 1), transformed with the Box-Muller method.*/
+    void Normal(uint64_t a, uint64_t b, double &z0, double &z1) const {
+        const uint32_t counter[4] = {static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32),
+                                     static_cast<uint32_t>(b), static_cast<uint32_t>(b >> 32)};
+        uint32_t bits[4];
+        Generate(counter, bits);
+        const double u0 = Uniform(bits[0], bits[1]);
+        const double u1 = Uniform(bits[2], bits[3]);
+        const double radius = std::sqrt(-2*std::log(u0));
+        const double angle = 6.283185307179586477*u1;
+        z0 = radius*std::cos(angle);
+        z1 = radius*std::sin(angle);
+    }
+
+    /** Uniform number in (0, 1) made of the 52 high bits of (high, low), centered in its interval of width 2^-52: it
+     * is never 0, so that its logarithm is finite, nor rounded to 1.*/
+    static double Uniform(uint32_t high, uint32_t low) {
+        const uint64_t bits = (static_cast<uint64_t>(high) << 32 | low) >> 12;
+        return (static_cast<double>(bits) + 0.5)*0x1p-52;
+    }
+
+private:
+    uint32_t key[2];
+};
+
+
+#endif //PCSC_PROJECT_PHILOX_H
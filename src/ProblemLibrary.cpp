@@ -0,0 +1,75 @@
+#include "ProblemLibrary.h"
+
+#include <cmath>
+
+namespace {
+
+double fPolynomial(double y, double t) { return 1 + t; }
+double dfPolynomial(double y, double t) { return 0.; }
+double solPolynomial(double t) { return 0.5*t*t + t; }
+
+double fStiffDecay(double y, double t) { return -100*y; }
+double dfStiffDecay(double y, double t) { return -100.; }
+double solStiffDecay(double t) { return std::exp(-100*t); }
+double nStiffDecay(double y, double t) { return 0.; }
+
+double fTrigonometric(double y, double t) { return std::sin(t)*std::cos(t); }
+double dfTrigonometric(double y, double t) { return 0.; }
+double solTrigonometric(double t) { return 0.5*std::pow(std::sin(t), 2); }
+
+double fExpSin(double y, double t) { return y*std::cos(t); }
+double dfExpSin(double y, double t) { return std::cos(t); }
+double solExpSin(double t) { return std::exp(std::sin(t)); }
+
+double fLogistic(double y, double t) { return y*(1 - y); }
+double dfLogistic(double y, double t) { return 1 - 2*y; }
+double solLogistic(double t) { return 1/(1 + std::exp(-t)); }
+
+double fRiccati(double y, double t) { return 1 + y*y; }
+double dfRiccati(double y, double t) { return 2*y; }
+double solRiccati(double t) { return std::tan(t); }
+
+// Prothero-Robinson: y' = lambda (y - g(t)) + g'(t), whose solution y = g(t) attracts the others at the rate lambda
+const double PROTHERO_ROBINSON_LAMBDA = -1000.;
+double fProtheroRobinson(double y, double t) { return PROTHERO_ROBINSON_LAMBDA*(y - std::sin(t)) + std::cos(t); }
+double dfProtheroRobinson(double y, double t) { return PROTHERO_ROBINSON_LAMBDA; }
+double solProtheroRobinson(double t) { return std::sin(t); }
+double nProtheroRobinson(double y, double t) { return -PROTHERO_ROBINSON_LAMBDA*std::sin(t) + std::cos(t); }
+
+}
+
+const std::vector<TestProblem> &ProblemLibrary::GetProblems() {
+    /*!
+    * \return All the problems of the library, the functions 1, 2 and 3 of main_solver first
+    */
+    static const std::vector<TestProblem> problems = {
+            {"polynomial", "f(y,t) = 1+t, y(t) = t^2/2 + t", fPolynomial, dfPolynomial, solPolynomial,
+             0., 10., 0., 0., fPolynomial, false},
+            {"stiff_decay", "f(y,t) = -100*y, y(t) = exp(-100 t)", fStiffDecay, dfStiffDecay, solStiffDecay,
+             0., 1., 1., -100., nStiffDecay, true},
+            {"trigonometric", "f(y,t) = sin(t)*cos(t), y(t) = sin(t)^2/2", fTrigonometric, dfTrigonometric,
+             solTrigonometric, 0., 10., 0., 0., fTrigonometric, false},
+            {"exp_sin", "f(y,t) = y*cos(t), y(t) = exp(sin(t))", fExpSin, dfExpSin, solExpSin,
+             0., 10., 1., 0., fExpSin, false},
+            {"logistic", "f(y,t) = y*(1-y), y(t) = 1/(1 + exp(-t))", fLogistic, dfLogistic, solLogistic,
+             0., 10., 0.5, 0., fLogistic, false},
+            {"riccati", "f(y,t) = 1 + y^2, y(t) = tan(t), close to its blow-up at pi/2", fRiccati, dfRiccati,
+             solRiccati, 0., 1.4, 0., 0., fRiccati, false},
+            {"prothero_robinson", "f(y,t) = -1000*(y - sin(t)) + cos(t), y(t) = sin(t)", fProtheroRobinson,
+             dfProtheroRobinson, solProtheroRobinson, 0., 1., 0., PROTHERO_ROBINSON_LAMBDA, nProtheroRobinson, true},
+    };
+    return problems;
+}
+
+const TestProblem *ProblemLibrary::Find(const std::string &name) {
+    /*!
+    * \param name: name of a problem
+    * \return The problem, nullptr if no problem has this name
+    */
+    for (const TestProblem &problem : GetProblems()) {
+        if (problem.name == name) {
+            return &problem;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,38 @@
+#ifndef PCSC_PROJECT_PROBLEMLIBRARY_H
+#define PCSC_PROJECT_PROBLEMLIBRARY_H
+
+#include <string>
+#include <vector>
+
+/** Scalar initial value problem \f$ y' = f(y,t), y(t_0) = y_0 \f$ of the ProblemLibrary, with its exact solution.*/
+struct TestProblem {
+    std::string name;
+    std::string description;
+    double (*f)(double y, double t);
+    /** derivative of f with respect to y*/
+    double (*df)(double y, double t);
+    double (*solution)(double t);
+    double t0;
+    double t1;
+    double y0;
+    /** linear coefficient L of the splitting f(y,t) = L*y + N(y,t) used by the ETD solver*/
+    double linearPart;
+    /** nonlinear part N(y,t)*/
+    double (*nonlinearPart)(double y, double t);
+    /** true if the explicit solvers need a step size much smaller than the one needed for accuracy*/
+    bool stiff;
+};
+
+/** Library of standard scalar test problems, shared by main_solver, the manifests and the work-precision benchmark,
+ * and selected by name. Each problem comes with the derivative df/dy of its right hand side and its exact
+ * solution. <br>
+ * The first three problems are the functions 1, 2 and 3 of main_solver: 1+t, -100*y and sin(t)*cos(t).
+ */
+class ProblemLibrary {
+public:
+    static const std::vector<TestProblem> &GetProblems();
+    static const TestProblem *Find(const std::string &name);
+};
+
+
+#endif //PCSC_PROJECT_PROBLEMLIBRARY_H
@@ -0,0 +1,181 @@
+#include "RKAdjoint.h"
+#include "UncoherentValueException.h"
+#include <algorithm>
+#include <climits>
+
+RKAdjoint::RKAdjoint(RKSolver &solver, const ForwardSensitivity &derivatives, const unsigned int checkpoints)
+    : solver(solver), derivatives(derivatives), checkpoints(checkpoints), order(0), finalValue(0.), forwardSteps(0),
+      stored(0), checkpointsUsed(0), steps(0), dgdy(nullptr), context(nullptr) {
+    /*!
+    * \param solver: Runge-Kutta solver, whose step size, time interval, initial value, right hand side and order
+    * are those of the forward solution
+    * \param derivatives: derivatives of the right hand side, whose Jacobian must be set
+    * \param checkpoints: maximal number of solutions kept at the same time during the backward sweep
+    */
+    if (!derivatives.HasJacobian()) {
+        throw UncoherentValueException("The adjoint needs the Jacobian df/dy of the right hand side.");
+    }
+}
+
+unsigned long RKAdjoint::Binomial(const unsigned int c, const unsigned int r) {
+    /*!
+    * \param c: number of checkpoints
+    * \param r: number of times each step is recomputed
+    * \return The largest number of steps reversible with c checkpoints and r recomputations, i.e. (c+r)!/(c!r!),
+    * ULONG_MAX if it does not fit in an unsigned long
+    */
+    unsigned long binomial = 1;
+    for (unsigned int i = 1; i <= c; i++) {
+        // binomial = (r+i)!/(i!r!) is an integer at each iteration
+        if (binomial > ULONG_MAX/(r + i)) {
+            return ULONG_MAX;
+        }
+        binomial = binomial*(r + i)/i;
+    }
+    return binomial;
+}
+
+std::vector<double> RKAdjoint::Gradient(double (*dgdy)(double y, void *context), void *context) {
+    /*! Compute the gradient of J = g(y(t1)) with the discrete adjoint of the solver
+    * \param dgdy: derivative g'(y) of the objective, nullptr for J = y(t1)
+    * \param context: pointer given to each call of dgdy
+    * \return The derivatives of J with respect to the parameters of the derivatives given to the constructor
+    */
+    order = solver.GetOrder();
+    for (unsigned int j = 0; j < order; j++) {
+        b[j] = solver.GetB(order-1, j);
+        c[j] = solver.GetC(order-1, j);
+        for (unsigned int i = 0; i < j; i++) {
+            a[j][i] = solver.GetA(j, i);
+        }
+    }
+    this->dgdy = dgdy;
+    this->context = context;
+    steps = solver.GetNumberOfSteps();
+    gradient.assign(derivatives.Size(), 0.);
+    forwardSteps = 0;
+    stored = 0;
+    checkpointsUsed = 0;
+    finalValue = solver.GetInitialValue();
+
+    // adjoint of the initial value, set by the reversal of the last step
+    double lambda = dgdy != nullptr ? dgdy(finalValue, context) : 1.;
+    Reverse(solver.GetInitialValue(), 0, steps, checkpoints, lambda);
+    for (unsigned int k = 0; k < derivatives.Size(); k++) {
+        // the initial sensitivity is 1 for y0 and 0 for the parameters of f
+        gradient[k] += lambda*derivatives.GetInitialSensitivity(k);
+    }
+    return gradient;
+}
+
+double RKAdjoint::Advance(double y, const unsigned long first, const unsigned long steps) {
+    /*! Recompute the solution forward
+    * \param y: solution after first steps
+    * \param first: index of the first step
+    * \param steps: number of steps
+    * \return The solution after first+steps steps
+    */
+    const double h = solver.GetStepSize();
+    double k[max_rk_order];
+    for (unsigned long n = first; n < first + steps; n++) {
+        const double t = solver.GetInitialTime() + n*h;
+        double y_next = y;
+        for (unsigned int j = 0; j < order; j++) {
+            double Y = y;
+            for (unsigned int i = 0; i < j; i++) {
+                Y += h*a[j][i]*k[i];
+            }
+            k[j] = solver.RightHandSide(Y, t + c[j]*h);
+            y_next += h*b[j]*k[j];
+        }
+        y = y_next;
+    }
+    forwardSteps += steps;
+    return y;
+}
+
+void RKAdjoint::Reverse(const double y, const unsigned long first, const unsigned long steps,
+                        const unsigned int checkpoints, double &lambda) {
+    /*! Reverse the steps first, ..., first+steps-1, the last one first, with the binomial schedule
+    * \param y: solution after first steps, stored by the caller
+    * \param first: index of the first step
+    * \param steps: number of steps
+    * \param checkpoints: number of checkpoints which can still be stored
+    * \param lambda: adjoint of the solution after first+steps steps, replaced by the one after first steps
+    */
+    if (steps == 0) {
+        return;
+    }
+    if (steps == 1) {
+        ReverseStep(y, first, lambda);
+        return;
+    }
+    if (checkpoints == 0) {
+        // every step is recomputed from y
+        for (unsigned long i = steps; i-- > 0;) {
+            ReverseStep(Advance(y, first, i), first + i, lambda);
+        }
+        return;
+    }
+    // smallest number of recomputations r, then a split which leaves at most Binomial(checkpoints-1, r) steps after
+    // the new checkpoint, and at most Binomial(checkpoints, r-1) steps before it
+    unsigned int r = 1;
+    while (Binomial(checkpoints, r) < steps) {
+        r++;
+    }
+    const unsigned long after = std::min(Binomial(checkpoints - 1, r), steps - 1);
+    const unsigned long split = steps - after;
+
+    const double checkpoint = Advance(y, first, split);
+    stored++;
+    checkpointsUsed = std::max(checkpointsUsed, stored);
+    Reverse(checkpoint, first + split, after, checkpoints - 1, lambda);
+    stored--;
+    Reverse(y, first, split, checkpoints, lambda);
+}
+
+void RKAdjoint::ReverseStep(const double y, const unsigned long n, double &lambda) {
+    /*! Propagate the adjoint backward through the stages of a step
+    * \param y: solution after n steps
+    * \param n: index of the step
+    * \param lambda: adjoint of the solution after n+1 steps, replaced by the one after n steps
+    */
+    const double h = solver.GetStepSize();
+    const double t = solver.GetInitialTime() + n*h;
+    double Y[max_rk_order];
+    double k[max_rk_order];
+    double y_next = y;
+    for (unsigned int j = 0; j < order; j++) {
+        Y[j] = y;
+        for (unsigned int i = 0; i < j; i++) {
+            Y[j] += h*a[j][i]*k[i];
+        }
+        k[j] = solver.RightHandSide(Y[j], t + c[j]*h);
+        y_next += h*b[j]*k[j];
+    }
+    forwardSteps++;
+    if (n + 1 == steps) {
+        // last step: the adjoint starts from the derivative of the objective
+        finalValue = y_next;
+        lambda = dgdy != nullptr ? dgdy(y_next, context) : 1.;
+    }
+
+    // y_{n+1} = y_n + h sum_j b_j k_j, k_j = f(Y_j), Y_j = y_n + h sum_{i<j} a_ji k_i
+    double k_bar[max_rk_order];
+    for (unsigned int j = 0; j < order; j++) {
+        k_bar[j] = h*b[j]*lambda;
+    }
+    double lambda_n = lambda;
+    for (unsigned int j = order; j-- > 0;) {
+        const double t_j = t + c[j]*h;
+        const double Y_bar = k_bar[j]*derivatives.Jacobian(Y[j], t_j);
+        for (unsigned int p = 0; p < derivatives.Size(); p++) {
+            gradient[p] += k_bar[j]*derivatives.Forcing(p, Y[j], t_j);
+        }
+        lambda_n += Y_bar;
+        for (unsigned int i = 0; i < j; i++) {
+            k_bar[i] += h*a[j][i]*Y_bar;
+        }
+    }
+    lambda = lambda_n;
+}
@@ -0,0 +1,59 @@
+#ifndef PCSC_PROJECT_RKADJOINT_H
+#define PCSC_PROJECT_RKADJOINT_H
+
+#include "RKSolver.h"
+#include "ForwardSensitivity.h"
+#include <vector>
+
+/** Gradient of an objective \f$ J = g(y(t_1)) \f$ with respect to all the parameters of the right hand side and to
+ * \f$ y_0 \f$, by the discrete adjoint of the Runge-Kutta solver: the adjoint \f$ \lambda_n = \partial J /
+ * \partial y_n \f$ is propagated backward through the stages of each step, from \f$ \lambda_N = g'(y_N) \f$. The
+ * gradient is the exact derivative of the numerical solution, for the cost of about two forward solves, whatever
+ * the number of parameters. <br>
+ * The backward sweep needs the solution at each step. Only a fixed number of checkpoints is kept: the steps are
+ * reversed with the binomial schedule of Griewank's Revolve algorithm, which recomputes the missing values from the
+ * checkpoints with the smallest number of forward steps. With c checkpoints and r recomputations of each step, up to
+ * \f$ \binom{c+r}{c} \f$ steps can be reversed. <br>
+ * The derivatives of f are described as for the forward sensitivities, with a ForwardSensitivity whose Jacobian is
+ * set: the gradient has one value per sensitivity, in the same order.
+ */
+class RKAdjoint {
+public:
+    RKAdjoint(RKSolver &solver, const ForwardSensitivity &derivatives, unsigned int checkpoints = 10);
+
+    std::vector<double> Gradient(double (*dgdy)(double y, void *context) = nullptr, void *context = nullptr);
+
+    /** solution at the final time, computed by the last call to Gradient*/
+    double GetFinalValue() const { return finalValue; }
+    /** number of steps computed by the last call to Gradient, the first forward sweep included*/
+    unsigned long GetNumberOfForwardSteps() const { return forwardSteps; }
+    /** largest number of checkpoints stored at the same time by the last call to Gradient*/
+    unsigned int GetNumberOfCheckpointsUsed() const { return checkpointsUsed; }
+    static unsigned long Binomial(unsigned int c, unsigned int r);
+
+private:
+    double Advance(double y, unsigned long first, unsigned long steps);
+    void Reverse(double y, unsigned long first, unsigned long steps, unsigned int checkpoints, double &lambda);
+    void ReverseStep(double y, unsigned long n, double &lambda);
+
+    RKSolver &solver;
+    const ForwardSensitivity &derivatives;
+    const unsigned int checkpoints;
+    // coefficients of the method of the solver
+    unsigned int order;
+    double a[max_rk_order][max_rk_order];
+    double b[max_rk_order];
+    double c[max_rk_order];
+    // adjoints of the parameters, accumulated by the backward sweep
+    std::vector<double> gradient;
+    double finalValue;
+    unsigned long forwardSteps;
+    unsigned int stored;
+    unsigned int checkpointsUsed;
+    unsigned long steps;
+    double (*dgdy)(double y, void *context);
+    void *context;
+};
+
+
+#endif //PCSC_PROJECT_RKADJOINT_H
@@ -0,0 +1,125 @@
+#include "RKNSolver.h"
+#include "SetOrderException.h"
+
+RKNSolver::RKNSolver()
+    : AbstractExplicitSolver(), initialVelocity(0.), finalVelocity(0.), velocitySink(nullptr) {
+    /**
+    Constructor of a Runge-Kutta-Nyström solver instance, of order 4 with an initial velocity of 0.
+    */
+    SetB();
+    RKNSolver::SetOrder(max_rk_order);
+}
+
+RKNSolver::RKNSolver(const double h, const double t0, const double t1, const double y0, const double v0,
+                     double (*f)(double, double), const unsigned int s)
+    : AbstractExplicitSolver(h, t0, t1, y0, f, s), initialVelocity(v0), finalVelocity(v0), velocitySink(nullptr) {
+    /**
+    Constructor of a Runge-Kutta-Nyström solver instance, where each parameter are defined from outside the class.
+     f is the acceleration y''.
+    */
+    SetB();
+    RKNSolver::SetOrder(s);
+}
+
+RKNSolver::~RKNSolver() = default;
+
+void RKNSolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: order of the method, between 1 and 4
+*/
+    try {
+        if (order < 1 || order > max_rk_order) {
+            throw SetOrderException("The order of the Runge-Kutta-Nyström solver should be between 1 and 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 4.");
+        order = max_rk_order;
+    }
+    AbstractOdeSolver::SetOrder(order);
+}
+
+void RKNSolver::SetB() {
+    /**
+   * Set the coefficients of the methods of each order, the position weights of order p being in the row p-1 of b.
+     The position weights are \f$ \bar{b}_j = b_j (1 - c_j) \f$.
+   *
+   */
+    for (unsigned int p = 0; p < max_rk_order; p++) {
+        for (unsigned int j = 0; j < max_rk_order; j++) {
+            c[p][j] = 0.;
+            v[p][j] = 0.;
+            b[p][j] = 0.;
+            for (unsigned int l = 0; l < max_rk_order; l++) {
+                a[p][j][l] = 0.;
+            }
+        }
+    }
+    // s = 1: symplectic Euler method, v_{n+1} = v_n + h f(y_n), y_{n+1} = y_n + h v_{n+1}
+    v[0][0] = 1.;
+    b[0][0] = 1.;
+    // s = 2: Störmer-Verlet method, the second stage being evaluated at y_{n+1}
+    c[1][1] = 1.;
+    a[1][1][0] = 1./2;
+    v[1][0] = 1./2;
+    v[1][1] = 1./2;
+    b[1][0] = 1./2;
+    // s = 3: Nyström's third-order method
+    c[2][1] = 2./3;
+    a[2][1][0] = 2./9;
+    v[2][0] = 1./4;
+    v[2][1] = 3./4;
+    b[2][0] = 1./4;
+    b[2][1] = 1./4;
+    // s = 4: classic fourth-order Runge-Kutta-Nyström method
+    c[3][1] = 1./2;
+    c[3][2] = 1.;
+    a[3][1][0] = 1./8;
+    a[3][2][1] = 1./2;
+    v[3][0] = 1./6;
+    v[3][1] = 2./3;
+    v[3][2] = 1./6;
+    b[3][0] = 1./6;
+    b[3][1] = 1./3;
+}
+
+void RKNSolver::Solve(AbstractOutputSink &sink) {
+    /*!
+    * Runge-Kutta-Nyström methods for the scalar ODE in the form y''(t)=f(y,t).
+    * \param sink: sink receiving the position y at each time t
+    */
+    double y = GetInitialValue();
+    double velocity = initialVelocity;
+    double t = GetInitialTime();
+    const double h = GetStepSize();
+    const unsigned int p = GetOrder() - 1;
+    const unsigned int s = stages[p];
+    const unsigned long n = GetNumberOfSteps();
+    sink.Reserve(n + 1);
+    if (velocitySink != nullptr) {
+        velocitySink->Reserve(n + 1);
+        velocitySink->Write(t, velocity);
+    }
+    Output(sink, t, y);
+    double k[max_order+1];
+    k[0] = RightHandSide(y, t);
+    for (unsigned long i = 1; i <= n; ++i) {
+        for (unsigned int j = 1; j < s; j++) {
+            k[j] = RightHandSide(y + c[p][j]*h*velocity + h*h*ScalarProduct(j, k, a[p][j]), t + c[p][j]*h);
+        }
+        y += h*velocity + h*h*ScalarProduct(s, k, b[p]);
+        velocity += h*ScalarProduct(s, k, v[p]);
+        t += h;
+        // first stage of the next step
+        if (firstSameAsLast[p]) {
+            k[0] = k[s-1];
+        } else if (i < n) {
+            k[0] = RightHandSide(y, t);
+        }
+        //pass the values to the sinks
+        Output(sink, t, y);
+        if (velocitySink != nullptr) {
+            velocitySink->Write(t, velocity);
+        }
+    }
+    finalVelocity = velocity;
+}
@@ -0,0 +1,54 @@
+#ifndef PCSC_PROJECT_RKNSOLVER_H
+#define PCSC_PROJECT_RKNSOLVER_H
+
+#include "AbstractExplicitSolver.h"
+#include "RKSolver.h"
+
+/** Daughter of Abstract Explicit Solver class.
+ * The Runge-Kutta-Nyström solver solves the second order initial value problem
+     * \f$ \frac{d^2y}{dt^2} = f(y,t), \quad y(t_0) = y_0, \quad y'(t_0) = v_0 \f$
+     * directly, the right hand side being the acceleration f. Each step computes for \f$ j = 1, \dots, s \f$ <br>
+     * \f$ k_j = f(y_n + c_j h v_n + h^2 \sum_{l<j} a_{jl} k_l, t_n + c_j h) \f$ <br>
+     * \f$ y_{n+1} = y_n + h v_n + h^2 \sum_j \bar{b}_j k_j, \quad v_{n+1} = v_n + h \sum_j b_j k_j. \f$ <br>
+     * As f does not depend on y', the stages need no velocity, and an order p is reached with fewer evaluations than
+     * the Runge-Kutta method of order p applied to the first order system (y, y'). The implemented methods are: <br>
+     * order = 1: symplectic Euler method, 1 evaluation per step <br>
+     * order = 2: Störmer-Verlet method, whose last stage is the first one of the next step (1 evaluation per step)<br>
+     * order = 3: Nyström's third-order method, 2 evaluations per step <br>
+     * order = 4: classic fourth-order Runge-Kutta-Nyström method, 3 evaluations per step <br>
+     * The methods of order 1 and 2 are symplectic: the energy of a conservative problem does not drift. The records
+     * are the positions y; the velocities are passed to the sink set with SetVelocitySink.
+     */
+class RKNSolver : public AbstractExplicitSolver {
+public:
+    RKNSolver();
+    RKNSolver(double h, double t0, double t1, double y0, double v0, double (*f)(double y, double t), unsigned int s);
+    ~RKNSolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetInitialVelocity(double v0) { initialVelocity = v0; }
+    void SetVelocitySink(AbstractOutputSink *sink) { velocitySink = sink; }
+    double GetInitialVelocity() const { return initialVelocity; }
+    double GetFinalVelocity() const { return finalVelocity; }
+    unsigned int GetNumberOfStages() const { return stages[GetOrder()-1]; }
+
+private:
+    double initialVelocity;
+    double finalVelocity;
+    AbstractOutputSink *velocitySink;
+    // coefficients of the method of order p: a[p-1][j][l], c[p-1][j] and the velocity weights v[p-1][j], the
+    // position weights being the rows of b
+    double a[max_rk_order][max_rk_order][max_rk_order];
+    double c[max_rk_order][max_rk_order];
+    double v[max_rk_order][max_rk_order];
+    unsigned int stages[max_rk_order] = {1, 2, 2, 3};
+    // whether the last stage is evaluated at the new position, and is therefore the first stage of the next step
+    bool firstSameAsLast[max_rk_order] = {false, true, false, false};
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_RKNSOLVER_H
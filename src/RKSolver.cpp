@@ -6,10 +6,11 @@
 #include "UnsetOrderException.h"
 #include "SetOrderException.h"
 #include "OutOfRangeException.h"
+#include "LinearCombination.h"
 
 #include <cassert>
-#include <iostream>
 #include <cmath>
+#include <vector>
 
 
 RKSolver::RKSolver() : AbstractExplicitSolver() {
@@ -93,26 +94,23 @@ double RKSolver::GetC(int i, int j) const {
             throw OutOfRangeException("Out of range index. i should be bigger than 0.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "i is set to 0." << std::endl;
+        Report(error, "i is set to 0.");
         i = 0;
     }
     try {
-        if (i>=max_order) {
-            throw OutOfRangeException("Out of range index. i cannot be bigger than max_order");
+        if (i>=max_rk_order) {
+            throw OutOfRangeException("Out of range index. i cannot be bigger than max_rk_order");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "i is set to " << std::to_string(max_order) << "-1" << std::endl;
-        i = max_order-1;
+        Report(error, "i is set to ", std::to_string(max_rk_order), "-1");
+        i = max_rk_order-1;
     }
     try {
         if (j<0) {
             throw OutOfRangeException("Out of range index. j must be bigger or equal to 0.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set to 0." << std::endl;
+        Report(error, "j is set to 0.");
         j = 0;
     }
     //since the C matrix is triangular inferior:
@@ -121,8 +119,7 @@ double RKSolver::GetC(int i, int j) const {
             throw OutOfRangeException("j must be smaller or equal to i.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set equal to i. " << std::endl;
+        Report(error, "j is set equal to i. ");
         j = i;
     }
     return c[i][j];
@@ -136,7 +133,7 @@ void RKSolver::SetA() {
    */
     unsigned int order = GetOrder();
     assert(order > 0);
-    assert(order < max_order);
+    assert(order <= max_rk_order);
     switch (order) {
         case 1: // s = 1: Forward Euler (first order)
             a[0][0] = 0.;
@@ -182,26 +179,23 @@ double RKSolver::GetA(int i, int j) {
             throw OutOfRangeException("Out of range index. i should be bigger than 0.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "i is set to 0." << std::endl;
+        Report(error, "i is set to 0.");
         i = 0;
     }
     try {
-        if (i>=max_order) {
-            throw OutOfRangeException("Out of range index. i cannot be bigger than max_order");
+        if (i>=max_rk_order) {
+            throw OutOfRangeException("Out of range index. i cannot be bigger than max_rk_order");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "i is set to " << std::to_string(max_order-1) << std::endl;
-        i = max_order-1;
+        Report(error, "i is set to ", std::to_string(max_rk_order-1));
+        i = max_rk_order-1;
     }
     try {
         if (j<0) {
             throw OutOfRangeException("Out of range index. j must be bigger or equal to 0.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set to 0." << std::endl;
+        Report(error, "j is set to 0.");
         j = 0;
     }
     //since the A matrix is triangular inferior:
@@ -210,8 +204,7 @@ double RKSolver::GetA(int i, int j) {
             throw OutOfRangeException("j must be smaller or equal to i.");
         }
     } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set equal to i. " << std::endl;
+        Report(error, "j is set equal to i. ");
         j = i;
     }
     unsigned int order = GetOrder();
@@ -220,8 +213,7 @@ double RKSolver::GetA(int i, int j) {
             throw UnsetOrderException("When setting the coefficient As, the order needs to be set.");
         }
     } catch (UnsetOrderException &error) {
-        error.PrintDebug();
-        std::cout << "the order is set to 1." << std::endl;
+        Report(error, "the order is set to 1.");
         SetOrder(1);
     }
 
@@ -237,18 +229,16 @@ void RKSolver::SetOrder(unsigned int order) {
             throw SetOrderException("Order of the RK solver should be bigger or equal to 1.");
         }
     } catch (SetOrderException &error) {
-        error.PrintDebug();
-        std::cout << "The order is set to 1. " << std::endl;
+        Report(error, "The order is set to 1. ");
         order = 1;
     }
     try {
-        if (order >= max_order) {
+        if (order > max_rk_order) {
             throw SetOrderException("Order of the RK solver should be smaller or equal to 4.");
         }
     } catch (SetOrderException &error) {
-        error.PrintDebug();
-        std::cout << "the order is set to the maximum order : 4." << std::endl;
-        order = 4;
+        Report(error, "the order is set to the maximum order : 4.");
+        order = max_rk_order;
     }
     AbstractOdeSolver::SetOrder(order);
     SetB();
@@ -256,41 +246,11 @@ void RKSolver::SetOrder(unsigned int order) {
     SetA();
 }
 
-double RKSolver::ProductWithA(const double *k, int j) const {
-/*!
- * \param k: pointer to a double vector/array
- * \param j: row index of A
- * \return scalar product of k with the jth row of A, i.e. \f$\sum_{i=0}^{j-1} a[j][i]*k[i]\f$
-*/
-    try {
-        if (j>max_order) {
-            throw OutOfRangeException("j must be smaller than max_order.");
-        }
-    } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set 4. " << std::endl;
-        j = 4;
-    }
-    try {
-        if (j<0) {
-            throw OutOfRangeException("j must be positive.");
-        }
-    } catch (OutOfRangeException &error) {
-        error.PrintDebug();
-        std::cout << "j is set 0. " << std::endl;
-        j = 0;
-    }
-    double product;
-    product = ScalarProduct(j, k, &a[j][0]);
-    return product;
-}
-
-
-void RKSolver::SolveEquation(std::ostream &stream) {
+void RKSolver::Solve(AbstractOutputSink &sink) {
     /*!
    * Runge Kutta methods for the scalar ODE in the form y'(t)=f(y,t).
 
-   * \param stream: name of the file on which write the numerical solution at each time t
+   * \param sink: sink receiving the numerical solution at each time t
    */
 
     double y = GetInitialValue();
@@ -300,13 +260,31 @@ void RKSolver::SolveEquation(std::ostream &stream) {
     assert(h > 1e-6);
 
     int n = static_cast<int>(std::floor((GetFinalTime() - GetInitialTime()) / h));
+    sink.Reserve(n + 1);
 
-    stream << t << " " << y << "\n";
+    Output(sink, t, y);
     double temp; // y_n
     double k[order]; // k_0, k_1, ..., k_{order-1}
     temp = y;
     double product;
     double final_product;
+    // sensitivities S_p and their stages ks[j*m + p], integrated with the same method: the sensitivities of a stage
+    // are contiguous, so that the combinations of the stages are computed by LinearCombination
+    const unsigned int m = sensitivity != nullptr ? sensitivity->Size() : 0;
+    std::vector<double> S(m);
+    std::vector<double> S_j(m);
+    std::vector<double> ks(m*order);
+    const double *stages[max_rk_order];
+    for (unsigned int j = 0; j < order; j++) {
+        stages[j] = ks.data() + j*m;
+    }
+    if (sensitivity != nullptr) {
+        for (unsigned int p = 0; p < m; p++) {
+            S[p] = sensitivity->GetInitialSensitivity(p);
+        }
+        sensitivity->Start(n + 1);
+        sensitivity->Record(S.data());
+    }
     for (int i = 1; i <= n; ++i) {
         // compute the values k_j
         for(int j = 0; j < order; j++){
@@ -316,13 +294,26 @@ void RKSolver::SolveEquation(std::ostream &stream) {
             else{
                 product = 0;
             }
-            k[j] = RightHandSide(temp + h*product, t + c[order-1][j]*h);
+            const double Y = temp + h*product;
+            const double t_j = t + c[order-1][j]*h;
+            k[j] = RightHandSide(Y, t_j);
+            if (m > 0) {
+                const double J = sensitivity->Jacobian(Y, t_j);
+                LinearCombination::Compute(m, S.data(), h, j, a[j], stages, S_j.data());
+                for (unsigned int p = 0; p < m; p++) {
+                    ks[j*m + p] = J*S_j[p] + sensitivity->Forcing(p, Y, t_j);
+                }
+            }
         }
         final_product = ProductWithB(k, order);
         y = temp + h*final_product;
         t += h;
-        //store the values in the outstream
-        stream << t << " " << y << "\n";
+        //pass the values to the sink
+        Output(sink, t, y);
+        if (m > 0) {
+            LinearCombination::Compute(m, S.data(), h, order, b[order-1], stages, S.data());
+            sensitivity->Record(S.data());
+        }
         temp = y;
     }
 }
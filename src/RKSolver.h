@@ -8,6 +8,9 @@
 #include "AbstractExplicitSolver.h"
 #include <fstream>
 
+//the maximum order of the Runge-Kutta methods, whose coefficients are typed in
+const unsigned int max_rk_order = 4;
+
 /** Daughter of Abstract Explicit Solver class.
  * The Runge-Kutta solves the initial value problem
      * \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0 \f$
@@ -24,7 +27,6 @@
      */
 class RKSolver : public AbstractExplicitSolver {
 public:
-    void SolveEquation(std::ostream &stream) override;
     RKSolver();
     RKSolver(double h, double t0, double t1, double y0,
                          double (*f)(double y, double t), unsigned int s);
@@ -34,17 +36,25 @@ public:
     double GetC(int i, int j) const;
     double GetA(int i, int j);
 
-    // compute sum_{j=0}^{l-1} a[l-1][j]*k[j]
-    double ProductWithA(const double k[max_order-1], int j) const;
+    /** Scalar product of k with the jth row of A, \f$\sum_{i=0}^{j-1} a[j][i]*k[i]\f$. Called at each stage: j is not
+     * checked, the order being checked by SetOrder.*/
+    double ProductWithA(const double k[max_rk_order], int j) const {
+        assert(j >= 0 && j < static_cast<int>(max_rk_order));
+        return ScalarProduct(j, k, &a[j][0]);
+    }
 
 private:
-    double c[max_order-1][max_order-1];
-    double a[max_order-1][max_order-1];
+    double c[max_rk_order][max_rk_order];
+    double a[max_rk_order][max_rk_order];
 
     void SetC();
     void SetA();
 
 protected:
+    void Solve(AbstractOutputSink &sink) override;
+    bool SupportsSensitivity(const ForwardSensitivity &sensitivity) const override {
+        return sensitivity.HasJacobian();
+    }
     void SetB() override;
 };
 
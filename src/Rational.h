@@ -0,0 +1,61 @@
+#ifndef PCSC_PROJECT_RATIONAL_H
+#define PCSC_PROJECT_RATIONAL_H
+
+#include <cassert>
+#include <cstdlib>
+#include <numeric>
+
+/** Exact fraction of two 64 bits integers, always reduced and with a positive denominator. <br>
+ * Used to build coefficients of the methods without round-off: the operands are reduced by their common factors
+ * before being multiplied, which keeps the numerators and denominators of the Adams coefficients up to order 12
+ * far from an overflow.
+ */
+class Rational {
+public:
+    Rational(long long numerator = 0, long long denominator = 1) : numerator(numerator), denominator(denominator) {
+        assert(denominator != 0);
+        Reduce();
+    }
+
+    long long GetNumerator() const { return numerator; }
+    long long GetDenominator() const { return denominator; }
+    double ToDouble() const { return static_cast<double>(numerator)/static_cast<double>(denominator); }
+
+    Rational operator+(const Rational &other) const {
+        const long long g = std::gcd(denominator, other.denominator);
+        return Rational(numerator*(other.denominator/g) + other.numerator*(denominator/g),
+                        denominator/g*other.denominator);
+    }
+    Rational operator-() const { return Rational(-numerator, denominator); }
+    Rational operator-(const Rational &other) const { return *this + (-other); }
+    Rational operator*(const Rational &other) const {
+        const long long g1 = std::gcd(numerator, other.denominator);
+        const long long g2 = std::gcd(other.numerator, denominator);
+        return Rational((numerator/g1)*(other.numerator/g2), (denominator/g2)*(other.denominator/g1));
+    }
+    Rational &operator+=(const Rational &other) { return *this = *this + other; }
+    Rational &operator*=(const Rational &other) { return *this = *this*other; }
+    bool operator==(const Rational &other) const {
+        return numerator == other.numerator && denominator == other.denominator;
+    }
+    bool operator!=(const Rational &other) const { return !(*this == other); }
+
+private:
+    void Reduce() {
+        const long long g = std::gcd(numerator, denominator);
+        if (g > 1) {
+            numerator /= g;
+            denominator /= g;
+        }
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+
+    long long numerator;
+    long long denominator;
+};
+
+
+#endif //PCSC_PROJECT_RATIONAL_H
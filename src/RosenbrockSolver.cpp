@@ -0,0 +1,267 @@
+#include "RosenbrockSolver.h"
+#include "SetOrderException.h"
+#include "UncoherentValueException.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+RosenbrockSolver::RosenbrockSolver()
+    : AbstractImplicitSolver(), tolerance(0.), defaultController(0.9, 0.2, 6.), controller(nullptr) {
+    /**
+    Constructor of a Rosenbrock solver instance, of order 4 with a fixed step size.
+    */
+    RosenbrockSolver::SetOrder(4);
+}
+
+RosenbrockSolver::RosenbrockSolver(const double h, const double t0, const double t1, const double y0,
+                                   double (*f)(double, double), double (*df)(double, double), const unsigned int s)
+    : AbstractImplicitSolver(h, t0, t1, y0, f, df, s), tolerance(0.), defaultController(0.9, 0.2, 6.),
+      controller(nullptr) {
+    /**
+    Constructor of a Rosenbrock solver instance, where each parameter are defined from outside the class. df may be
+     nullptr, in which case the Jacobian is a finite difference of f.
+    */
+    RosenbrockSolver::SetOrder(s);
+}
+
+RosenbrockSolver::~RosenbrockSolver() = default;
+
+void RosenbrockSolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: order of the method, between 1 and 4
+*/
+    try {
+        if (order < 1 || order > 4) {
+            throw SetOrderException("The order of the Rosenbrock solver should be between 1 and 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 4.");
+        order = 4;
+    }
+    AbstractOdeSolver::SetOrder(order);
+    SetB();
+}
+
+void RosenbrockSolver::SetTolerance(double tol) {
+    /*! Set the tolerance on the local error, relative to 1 + |y|. A tolerance equal to 0 means that the step size is
+    * fixed.
+    * \param tol: tolerance
+    */
+    try {
+        if (tol < 0) {
+            throw UncoherentValueException("The tolerance must be positive.");
+        }
+    } catch (UncoherentValueException &error) {
+        Report(error, "The tolerance is set to |tol| = ", -tol);
+        tol = -tol;
+    }
+    tolerance = tol;
+}
+
+void RosenbrockSolver::SetStepSizeController(AbstractStepSizeController *controller) {
+    /*! Set the controller of the step size, used if the tolerance is not zero
+    * \param controller: step size controller, which must live as long as the solver. nullptr restores the default
+    * I controller.
+    */
+    this->controller = controller;
+}
+
+void RosenbrockSolver::SetB() {
+    /**
+   * Set the coefficients of the method of the current order, the weights m_i being written in the row order-1 of
+     b. ROS2 is the method of Verwer et al. (1999), ROS3 the one of Sandu et al. (1997) and RODAS4 the one of
+     Hairer and Wanner, whose last two stages give the solution and the embedded solution.
+   *
+   */
+    for (unsigned int i = 0; i < max_rosenbrock_stages; i++) {
+        alpha[i] = 0.;
+        gammas[i] = 0.;
+        e[i] = 0.;
+        newEvaluation[i] = true;
+        for (unsigned int j = 0; j < max_rosenbrock_stages; j++) {
+            a[i][j] = 0.;
+            c[i][j] = 0.;
+        }
+    }
+    double *m = b[GetOrder()-1];
+    switch (GetOrder()) {
+        case 1:
+            // linearly implicit Euler method
+            stages = 1;
+            gamma = 1.;
+            m[0] = 1.;
+            break;
+        case 2: {
+            stages = 2;
+            gamma = 1 + 1/std::sqrt(2.);
+            a[1][0] = 1/gamma;
+            c[1][0] = -2/gamma;
+            alpha[1] = 1.;
+            gammas[0] = gamma;
+            gammas[1] = -gamma;
+            m[0] = 3/(2*gamma);
+            m[1] = 1/(2*gamma);
+            e[0] = 1/(2*gamma);
+            e[1] = 1/(2*gamma);
+            break;
+        }
+        case 3:
+            stages = 3;
+            gamma = 0.43586652150845899942;
+            a[1][0] = 1.;
+            a[2][0] = 1.;
+            c[1][0] = -1.0156171083877702092;
+            c[2][0] = 4.0759956452537699825;
+            c[2][1] = 9.2076794298330791242;
+            alpha[1] = gamma;
+            alpha[2] = gamma;
+            // the third stage evaluates f at the point of the second one
+            newEvaluation[2] = false;
+            gammas[0] = gamma;
+            gammas[1] = 0.24291996454816804367;
+            gammas[2] = 2.1851380027664058512;
+            m[0] = 1.;
+            m[1] = 6.1697947043828245593;
+            m[2] = -0.42772256543218573326;
+            e[0] = 0.5;
+            e[1] = -2.9079558716805469822;
+            e[2] = 0.22354069897811569627;
+            break;
+        default:
+            stages = 6;
+            gamma = 0.25;
+            a[1][0] = 1.544;
+            a[2][0] = 0.9466785280815826;
+            a[2][1] = 0.2557011698983284;
+            a[3][0] = 3.314825187068521;
+            a[3][1] = 2.896124015972201;
+            a[3][2] = 0.9986419139977817;
+            a[4][0] = 1.221224509226641;
+            a[4][1] = 6.019134481288629;
+            a[4][2] = 12.53708332932087;
+            a[4][3] = -0.6878860361058950;
+            c[1][0] = -5.6688;
+            c[2][0] = -2.430093356833875;
+            c[2][1] = -0.2063599157091915;
+            c[3][0] = -0.1073529058151375;
+            c[3][1] = -9.594562251023355;
+            c[3][2] = -20.47028614809616;
+            c[4][0] = 7.496443313967647;
+            c[4][1] = -10.24680431464352;
+            c[4][2] = -33.99990352819905;
+            c[4][3] = 11.70890893206160;
+            c[5][0] = 8.083246795921522;
+            c[5][1] = -7.981132988064893;
+            c[5][2] = -31.52159432874371;
+            c[5][3] = 16.31930543123136;
+            c[5][4] = -6.058818238834054;
+            const double alphas[] = {0., 0.386, 0.21, 0.63, 1., 1.};
+            const double time_coefficients[] = {0.25, -0.1043, 0.1035, -0.0362, 0., 0.};
+            for (unsigned int i = 0; i < stages; i++) {
+                alpha[i] = alphas[i];
+                gammas[i] = time_coefficients[i];
+            }
+            // the fifth stage is evaluated at the embedded solution, the sixth at the solution
+            for (unsigned int j = 0; j < 4; j++) {
+                a[5][j] = a[4][j];
+                m[j] = a[4][j];
+            }
+            a[5][4] = 1.;
+            m[4] = 1.;
+            m[5] = 1.;
+            e[5] = 1.;
+            break;
+    }
+}
+
+double RosenbrockSolver::Step(const double y, const double t, const double h, const double f_y,
+                              double &error) const {
+    /*! Step of the Rosenbrock method of the current order, with one evaluation of the Jacobian, one division per stage
+    * and no iteration.
+    * \param y: value at time t
+    * \param t: time
+    * \param h: step size
+    * \param f_y: evaluation of f(y,t), used by the first stage
+    * \param error: receives the difference between the solution and the embedded solution, 0 for order 1
+    * \return The value at time t+h
+    */
+    const double jacobian = Jacobian(y, t, f_y);
+    // time derivative of f, which the linearly implicit Euler method (gamma_1 = 0) does not use. The central
+    // difference is of order 2: with delta ~ eps^(1/3), its error ~ eps^(2/3) stays below the error of RODAS4, which
+    // a forward difference (error ~ sqrt(eps)) limits to order 2 for small steps
+    double f_t = 0.;
+    if (gammas[0] != 0.) {
+        const double delta = std::cbrt(std::numeric_limits<double>::epsilon())*std::max(1., std::abs(t));
+        f_t = (RightHandSide(y, t + delta) - RightHandSide(y, t - delta))/(2*delta);
+    }
+    const double denominator = 1/(h*gamma) - jacobian;
+    double K[max_rosenbrock_stages];
+    double f_stage = f_y;
+    for (unsigned int i = 0; i < stages; i++) {
+        if (i > 0 && newEvaluation[i]) {
+            f_stage = RightHandSide(y + ScalarProduct(i, K, a[i]), t + alpha[i]*h);
+        }
+        K[i] = (f_stage + ScalarProduct(i, K, c[i])/h + gammas[i]*h*f_t)/denominator;
+    }
+    error = ScalarProduct(stages, K, e);
+    return y + ScalarProduct(stages, K, b[GetOrder()-1]);
+}
+
+void RosenbrockSolver::Solve(AbstractOutputSink &sink) {
+    /*!
+    * Rosenbrock methods for the scalar ODE in the form y'(t)=f(y,t).
+    * \param sink: sink receiving the numerical solution at each time t
+    */
+    double y = GetInitialValue();
+    double t = GetInitialTime();
+    const double t1 = GetFinalTime();
+    const unsigned int order = GetOrder();
+    double h = GetStepSize();
+    double error;
+    if (tolerance == 0. || order == 1) {
+        const unsigned long n = GetNumberOfSteps();
+        sink.Reserve(n + 1);
+        Output(sink, t, y);
+        for (unsigned long i = 1; i <= n; ++i) {
+            y = Step(y, t, h, RightHandSide(y, t), error);
+            t += h;
+            //pass the values to the sink
+            Output(sink, t, y);
+        }
+        return;
+    }
+
+    Output(sink, t, y);
+    GetStepSizeController()->Reset();
+    double f_y = RightHandSide(y, t);
+    while (t1 - t > 1e-12*std::max(1., std::abs(t1))) {
+        if (t + h > t1) {
+            h = t1 - t;
+        }
+        const double y_new = Step(y, t, h, f_y, error);
+        // the embedded solution is of order p-1: its local error is proportional to h^p
+        error = std::abs(error)/(tolerance*(1 + std::max(std::abs(y), std::abs(y_new))));
+        const double factor = GetStepSizeController()->Factor(error, order);
+        if (error <= 1.) {
+            // the step is accepted
+            GetStepSizeController()->Accept(error);
+            ++result.acceptedSteps;
+            t += h;
+            y = y_new;
+            f_y = RightHandSide(y, t);
+            //pass the values to the sink
+            Output(sink, t, y);
+        } else {
+            // the step is rejected and restarted with a smaller step size, also if the error is not finite
+            GetStepSizeController()->Reject();
+            ++result.rejectedSteps;
+        }
+        h *= factor;
+        if (h < 1e-12*std::max(1., std::abs(t))) {
+            // reported at the end of the integration
+            result.status = SolverStatus::StepSizeTooSmall;
+            break;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef PCSC_PROJECT_ROSENBROCKSOLVER_H
+#define PCSC_PROJECT_ROSENBROCKSOLVER_H
+
+#include "AbstractImplicitSolver.h"
+#include "IStepSizeController.h"
+
+/** largest number of stages of the Rosenbrock methods*/
+const unsigned int max_rosenbrock_stages = 6;
+
+/** Daughter of Abstract Implicit Solver class.
+ * The Rosenbrock solver solves the initial value problem
+     * \f$ \frac{dy}{dt} f(t,y), \quad y(t_0) = y_0 \f$
+     * with linearly implicit Runge-Kutta (Rosenbrock-Wanner) methods, which use the Jacobian
+     * \f$ J = \partial f/\partial y \f$ at the beginning of each step instead of solving the equations of an implicit
+     * method with the Newton method. Each stage is the solution of one linear equation,
+     * \f$ \left(\frac{1}{h\gamma} - J\right) K_i = f\left(t + \alpha_i h, y + \sum_{j<i} a_{ij} K_j\right)
+     * + \sum_{j<i} \frac{c_{ij}}{h} K_j + \gamma_i h \frac{\partial f}{\partial t} \f$,
+     * which is a division for a scalar equation, and \f$ y_{n+1} = y_n + \sum_i m_i K_i \f$. <br>
+     * The order of the solver is the order of the method: 1 for the linearly implicit Euler method, 2 for ROS2,
+     * 3 for ROS3 and 4 for RODAS4 (Hairer and Wanner, Solving ODE II, VI.4), all L-stable. J is given by
+     * dRightHandSide if it is set, by a finite difference of f otherwise, and \f$ \partial f/\partial t \f$ by a
+     * central difference of f. <br>
+     * If the tolerance is zero, the step size is fixed. Otherwise, the step size is adapted to keep the error
+     * \f$ \sum_i e_i K_i \f$ of the embedded method of order p-1 below the tolerance, with a step size controller
+     * (see AbstractStepSizeController). The linearly implicit Euler method has no embedded method: its step size is
+     * always fixed.
+     */
+class RosenbrockSolver : public AbstractImplicitSolver {
+public:
+    RosenbrockSolver();
+    RosenbrockSolver(double h, double t0, double t1, double y0, double (*f)(double y, double t),
+                     double (*df)(double y, double t), unsigned int s);
+    ~RosenbrockSolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetTolerance(double tol);
+    void SetStepSizeController(AbstractStepSizeController *controller);
+    double GetTolerance() const { return tolerance; }
+    /** Controller set with SetStepSizeController, or the default I controller of this instance.*/
+    AbstractStepSizeController *GetStepSizeController() const {
+        return controller != nullptr ? controller : &defaultController;
+    }
+    unsigned int GetNumberOfStages() const { return stages; }
+
+    double Step(double y, double t, double h, double f_y, double &error) const;
+
+private:
+    double tolerance;
+    mutable IStepSizeController defaultController;
+    AbstractStepSizeController *controller;
+    // coefficients of the method of the current order, the weights m_i being the row order-1 of b
+    unsigned int stages;
+    double gamma;
+    double a[max_rosenbrock_stages][max_rosenbrock_stages];
+    double c[max_rosenbrock_stages][max_rosenbrock_stages];
+    double alpha[max_rosenbrock_stages];
+    double gammas[max_rosenbrock_stages];
+    double e[max_rosenbrock_stages];
+    // false if the stage evaluates f at the same point as the previous stage
+    bool newEvaluation[max_rosenbrock_stages];
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    bool SupportsSensitivity(const ForwardSensitivity &) const override { return false; }
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_ROSENBROCKSOLVER_H
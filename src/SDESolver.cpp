@@ -0,0 +1,224 @@
+#include "SDESolver.h"
+#include "SetOrderException.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace {
+
+// number of paths of a block of SolveEnsemble, whose increments are generated by the same loop
+const unsigned int LANES = 8;
+
+// coefficients of the diffusion stages of SRIW1 (Rößler 2010), multiplying dW, I_(1,1)/sqrt(h), I_(1,0)/h and
+// I_(1,1,1)/h
+const double BETA1[4] = {-1., 4./3, 2./3, 0.};
+const double BETA2[4] = {-1., 4./3, -1./3, 0.};
+const double BETA3[4] = {2., -4./3, -2./3, 0.};
+const double BETA4[4] = {-2., 5./3, -2./3, 1.};
+
+// number of evaluations of f of a step of the method of each order
+const unsigned int EVALUATIONS[4] = {1, 1, 2, 2};
+
+}
+
+SDESolver::SDESolver() : AbstractExplicitSolver(), g_diffusion(nullptr), dg_diffusion(nullptr), seed(0), path(0) {
+    /**
+    Constructor of an SDE solver instance, with the Euler-Maruyama method, the seed 0 and the path 0.
+    */
+    SetB();
+    SDESolver::SetOrder(1);
+}
+
+SDESolver::SDESolver(const double h, const double t0, const double t1, const double y0,
+                     double (*f)(double, double), double (*g)(double, double), const unsigned int s)
+    : AbstractExplicitSolver(h, t0, t1, y0, f, s), g_diffusion(g), dg_diffusion(nullptr), seed(0), path(0) {
+    /**
+    Constructor of an SDE solver instance, where each parameter are defined from outside the class, with the seed 0
+     and the path 0.
+    */
+    SetB();
+    SDESolver::SetOrder(s);
+}
+
+SDESolver::~SDESolver() = default;
+
+void SDESolver::SetOrder(unsigned int order) {
+/*!
+ * \param order: method, between 1 and 4, see the class
+*/
+    try {
+        if (order < 1 || order > 4) {
+            throw SetOrderException("The order of the SDE solver should be between 1 and 4.");
+        }
+    } catch (SetOrderException &error) {
+        Report(error, "The order is set to 1.");
+        order = 1;
+    }
+    AbstractOdeSolver::SetOrder(order);
+}
+
+void SDESolver::SetB() {
+    /**
+   * Set the weights of the evaluations of f of each method. The order 3/2 methods evaluate f at the beginning of
+     the step and at 3/4 of it.
+   *
+   */
+    b[0][0] = 1.;
+    b[1][0] = 1.;
+    for (int i = 2; i < 4; i++) {
+        b[i][0] = 1./3;
+        b[i][1] = 2./3;
+    }
+}
+
+double SDESolver::dDiffusion(const double y, const double t, const double g_y) const {
+    /*! Derivative of g with respect to y, used by the Milstein method
+    * \param y: value
+    * \param t: time
+    * \param g_y: evaluation of g(y,t)
+    * \return dg/dy(y,t) if it is set, a forward difference of g otherwise
+    */
+    if (dg_diffusion != nullptr) {
+        return dg_diffusion(y, t);
+    }
+    const double delta = std::sqrt(std::numeric_limits<double>::epsilon())*(1 + std::abs(y));
+    return (g_diffusion(y + delta, t) - g_y)/delta;
+}
+
+void SDESolver::Increments(const uint64_t path, const uint64_t step, const double h, double &dW, double &dZ) const {
+    /*! Random numbers of a step, which only depend on the seed, the path and the step
+    * \param path: index of the path
+    * \param step: index of the step, from 0
+    * \param h: step size
+    * \param dW: receives the increment of the Wiener process, normal with variance h
+    * \param dZ: receives a normal number of variance h independent of dW, giving I_(1,0) = h/2 (dW + dZ/sqrt(3))
+    */
+    Philox4x32(seed).Normal(step, path, dW, dZ);
+    const double sqrt_h = std::sqrt(h);
+    dW *= sqrt_h;
+    dZ *= sqrt_h;
+}
+
+double SDESolver::Step(const double y, const double t, const double h, const double dW, const double dZ) const {
+    /*! Step of the method of the current order. The evaluations of f are not counted, so that several threads can
+    * call it.
+    * \param y: value at time t
+    * \param t: time
+    * \param h: step size
+    * \param dW: increment of the Wiener process
+    * \param dZ: normal number of variance h independent of dW, used by the order 3/2 methods
+    * \return The value at time t+h
+    */
+    const double f_y = EvaluateRightHandSide(y, t);
+    switch (GetOrder()) {
+        case 1:
+            return y + h*f_y + Diffusion(y, t)*dW;
+        case 2: {
+            const double g_y = Diffusion(y, t);
+            return y + h*f_y + g_y*dW + 0.5*g_y*dDiffusion(y, t, g_y)*(dW*dW - h);
+        }
+        case 3: {
+            // SRA1: the diffusion is evaluated at t+h and t, I_(1,0)/h = (dW + dZ/sqrt(3))/2
+            const double I10 = 0.5*(dW + dZ/std::sqrt(3.));
+            const double g_end = Diffusion(y, t + h);
+            const double g_start = Diffusion(y, t);
+            const double f_2 = EvaluateRightHandSide(y + 0.75*h*f_y + 1.5*g_end*I10, t + 0.75*h);
+            return y + h*(b[2][0]*f_y + b[2][1]*f_2) + g_end*dW + (g_start - g_end)*I10;
+        }
+        default: {
+            // SRIW1: I_(1,1)/sqrt(h), I_(1,0)/h and I_(1,1,1)/h
+            const double sqrt_h = std::sqrt(h);
+            const double I11 = (dW*dW - h)/(2*sqrt_h);
+            const double I10 = 0.5*(dW + dZ/std::sqrt(3.));
+            const double I111 = (dW*dW*dW - 3*h*dW)/(6*h);
+            double g[4];
+            g[0] = Diffusion(y, t);
+            g[1] = Diffusion(y + 0.25*h*f_y + 0.5*sqrt_h*g[0], t + 0.25*h);
+            g[2] = Diffusion(y + h*f_y - sqrt_h*g[0], t + h);
+            g[3] = Diffusion(y + 0.25*h*f_y + sqrt_h*(-5*g[0] + 3*g[1] + 0.5*g[2]), t + 0.25*h);
+            const double f_2 = EvaluateRightHandSide(y + 0.75*h*f_y + 1.5*g[0]*I10, t + 0.75*h);
+            double noise = 0.;
+            for (int i = 0; i < 4; i++) {
+                noise += (BETA1[i]*dW + BETA2[i]*I11 + BETA3[i]*I10 + BETA4[i]*I111)*g[i];
+            }
+            return y + h*(b[3][0]*f_y + b[3][1]*f_2) + noise;
+        }
+    }
+}
+
+void SDESolver::Solve(AbstractOutputSink &sink) {
+    /*!
+    * Path of index GetPath() of the SDE in the form dY = f(Y,t)dt + g(Y,t)dW.
+    * \param sink: sink receiving the numerical solution at each time t
+    */
+    double y = GetInitialValue();
+    const double t0 = GetInitialTime();
+    const double h = GetStepSize();
+    const unsigned long n = GetNumberOfSteps();
+    sink.Reserve(n + 1);
+    Output(sink, t0, y);
+    double dW;
+    double dZ;
+    for (unsigned long i = 0; i < n; ++i) {
+        // same times as SolveEnsemble, so that the path is the same
+        Increments(path, i, h, dW, dZ);
+        y = Step(y, t0 + i*h, h, dW, dZ);
+        //pass the values to the sink
+        Output(sink, t0 + (i + 1)*h, y);
+    }
+    result.rhsEvaluations += EVALUATIONS[GetOrder()-1]*n;
+}
+
+std::vector<double> SDESolver::SolveEnsemble(const unsigned long paths, unsigned int threads) {
+    /*! Final values of the paths 0, ..., paths-1. Each thread computes a range of paths, by blocks of LANES paths
+    * advanced together: the increments of a block are generated by one loop over the lanes with no dependency between
+    * them, the generator having no state. The values do not depend on the number of threads.
+    * \param paths: number of paths
+    * \param threads: number of threads, 1 by default
+    * \return The value at the final time of each path
+    */
+    result = SolverResult();
+    threads = std::max(1u, threads);
+    const double h = GetStepSize();
+    const double t0 = GetInitialTime();
+    const unsigned long n = GetNumberOfSteps();
+    std::vector<double> values(paths, GetInitialValue());
+    auto compute = [&](unsigned long first, unsigned long last) {
+        double dW[LANES];
+        double dZ[LANES];
+        for (unsigned long block = first; block < last; block += LANES) {
+            const unsigned int lanes = static_cast<unsigned int>(std::min<unsigned long>(LANES, last - block));
+            double *y = &values[block];
+            for (unsigned long i = 0; i < n; ++i) {
+                for (unsigned int l = 0; l < lanes; l++) {
+                    Increments(block + l, i, h, dW[l], dZ[l]);
+                }
+                const double t = t0 + i*h;
+                for (unsigned int l = 0; l < lanes; l++) {
+                    y[l] = Step(y[l], t, h, dW[l], dZ[l]);
+                }
+            }
+        }
+    };
+    // the ranges of the threads are made of whole blocks
+    const unsigned long blocks = (paths + LANES - 1)/LANES;
+    std::vector<std::thread> workers;
+    for (unsigned int w = 1; w < threads; w++) {
+        const unsigned long first = std::min(paths, blocks*w/threads*LANES);
+        const unsigned long last = std::min(paths, blocks*(w + 1)/threads*LANES);
+        workers.emplace_back(compute, first, last);
+    }
+    compute(0, std::min(paths, blocks/threads*LANES));
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    result.rhsEvaluations = EVALUATIONS[GetOrder()-1]*n*paths;
+    for (double value : values) {
+        if (!std::isfinite(value) && result.nonFiniteValues++ == 0) {
+            result.status = SolverStatus::NonFinite;
+        }
+    }
+    return values;
+}
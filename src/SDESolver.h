@@ -0,0 +1,58 @@
+#ifndef PCSC_PROJECT_SDESOLVER_H
+#define PCSC_PROJECT_SDESOLVER_H
+
+#include "AbstractExplicitSolver.h"
+#include "Philox.h"
+#include <cstdint>
+#include <vector>
+
+/** Daughter of Abstract Explicit Solver class.
+ * The SDE solver solves the Itô stochastic differential equation with a scalar Wiener process W
+     * \f$ dY = f(Y,t) dt + g(Y,t) dW, \quad Y(t_0) = y_0 \f$
+     * with fixed steps. The order selects the method: <br>
+     * order = 1: Euler-Maruyama (strong order 1/2) <br>
+     * order = 2: Milstein, which uses dg/dy, given with SetdDiffusion or a finite difference (strong order 1) <br>
+     * order = 3: Rößler's SRA1, for an additive noise g(t) only (strong order 3/2) <br>
+     * order = 4: Rößler's SRIW1 (strong order 3/2) <br>
+     * The increments \f$ \Delta W \f$ of the Wiener process, and \f$ \Delta Z \f$ giving the iterated integral
+     * \f$ I_{(1,0)} \f$ of the order 3/2 methods, are normal numbers generated by a counter-based generator
+     * (Philox4x32) from the seed, the index of the path and the index of the step. A path is therefore reproduced
+     * exactly from its index, whatever the other paths and the thread which computes it. <br>
+     * SolveEquation computes the path set with SetPath. SolveEnsemble computes the final values of many paths on
+     * several threads, by blocks of paths whose random numbers are generated together; f and g must then be safe to
+     * call concurrently.
+     */
+class SDESolver : public AbstractExplicitSolver {
+public:
+    SDESolver();
+    SDESolver(double h, double t0, double t1, double y0, double (*f)(double y, double t),
+              double (*g)(double y, double t), unsigned int s);
+    ~SDESolver() override;
+    void SetOrder(unsigned int order) override;
+
+    void SetDiffusion(double (*g)(double y, double t)) { g_diffusion = g; }
+    void SetdDiffusion(double (*dg)(double y, double t)) { dg_diffusion = dg; }
+    void SetSeed(uint64_t seed) { this->seed = seed; }
+    void SetPath(uint64_t path) { this->path = path; }
+    uint64_t GetSeed() const { return seed; }
+    uint64_t GetPath() const { return path; }
+
+    double Diffusion(double y, double t) const { return g_diffusion(y, t); }
+    double dDiffusion(double y, double t, double g_y) const;
+    void Increments(uint64_t path, uint64_t step, double h, double &dW, double &dZ) const;
+    double Step(double y, double t, double h, double dW, double dZ) const;
+    std::vector<double> SolveEnsemble(unsigned long paths, unsigned int threads = 1);
+
+private:
+    double (*g_diffusion)(double y, double t);
+    double (*dg_diffusion)(double y, double t);
+    uint64_t seed;
+    uint64_t path;
+
+protected:
+    void Solve(AbstractOutputSink &sink) override;
+    void SetB() override;
+};
+
+
+#endif //PCSC_PROJECT_SDESOLVER_H
@@ -0,0 +1,39 @@
+#ifndef PCSC_PROJECT_SOLVERRESULT_H
+#define PCSC_PROJECT_SOLVERRESULT_H
+
+/** Outcome of a call to AbstractOdeSolver::SolveEquation. Success unless a problem was detected while stepping.*/
+enum class SolverStatus {
+    Success,
+    /** the Newton method of an implicit solver reached its maximum number of iterations at some steps, or the one of
+     * the algebraic equation of a differential-algebraic equation at some evaluations*/
+    NewtonNotConverged,
+    /** the solution became infinite or NaN*/
+    NonFinite,
+    /** the adaptive step size became too small, the integration was stopped before the final time*/
+    StepSizeTooSmall
+};
+
+/** Status and counters of a call to AbstractOdeSolver::SolveEquation. <br>
+ * The problems detected while stepping are only counted, so that the time loops contain no exception and no output:
+ * they are reported once to the diagnostic sink of the solver when the integration ends.
+ */
+struct SolverResult {
+    SolverStatus status = SolverStatus::Success;
+    /** number of evaluations of the right hand side*/
+    unsigned long rhsEvaluations = 0;
+    /** number of accepted and rejected steps of an adaptive solver*/
+    unsigned long acceptedSteps = 0;
+    unsigned long rejectedSteps = 0;
+    /** number of steps at which the Newton method did not converge*/
+    unsigned long newtonFailures = 0;
+    /** number of evaluations of the right hand side at which the algebraic equation of a differential-algebraic
+     * equation could not be solved*/
+    unsigned long algebraicFailures = 0;
+    /** number of records whose value is infinite or NaN*/
+    unsigned long nonFiniteValues = 0;
+    /** time of the first record whose value is infinite or NaN*/
+    double firstNonFiniteTime = 0.;
+};
+
+
+#endif //PCSC_PROJECT_SOLVERRESULT_H
@@ -0,0 +1,86 @@
+#ifndef PCSC_PROJECT_SPSCRINGBUFFER_H
+#define PCSC_PROJECT_SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/** Lock-free ring buffer for exactly one producer thread and one consumer thread.
+ * The capacity is rounded up to a power of two, so that the position in the buffer is obtained with a mask.
+ * The producer only writes the tail and the consumer only writes the head: each side publishes its progress with a
+ * release store and reads the other side with an acquire load, no lock and no read-modify-write is needed. <br>
+ * Each side also keeps a cached copy of the other index, so that the shared cache line is only read when the buffer
+ * looks full (producer) or empty (consumer).
+ */
+template<typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(size_t capacity)
+        : capacity(RoundUp(capacity)), mask(RoundUp(capacity) - 1), buffer(new T[RoundUp(capacity)]) {}
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    bool TryPush(const T &value) {
+        /*! Called by the producer only.
+        * \param value: element appended to the buffer
+        * \return false if the buffer is full, in which case nothing is written
+        */
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - cachedHead == capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (tail - cachedHead == capacity) {
+                return false;
+            }
+        }
+        buffer[tail & mask] = value;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T &value) {
+        /*! Called by the consumer only.
+        * \param value: oldest element of the buffer, removed from it
+        * \return false if the buffer is empty, in which case value is left unchanged
+        */
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (head == cachedTail) {
+                return false;
+            }
+        }
+        value = buffer[head & mask];
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Number of elements in the buffer. Exact when called by one of the two threads while the other one is idle,
+     * an estimate otherwise.*/
+    size_t Size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    size_t GetCapacity() const { return capacity; }
+
+private:
+    static size_t RoundUp(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<T[]> buffer;
+    // the indices only grow, the position in the buffer is index & mask
+    alignas(64) std::atomic<size_t> head{0}; // written by the consumer
+    size_t cachedTail = 0;                  // consumer's copy of tail
+    alignas(64) std::atomic<size_t> tail{0}; // written by the producer
+    size_t cachedHead = 0;                  // producer's copy of head
+};
+
+
+#endif //PCSC_PROJECT_SPSCRINGBUFFER_H
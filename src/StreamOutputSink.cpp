@@ -0,0 +1,15 @@
+#include "StreamOutputSink.h"
+
+StreamOutputSink::StreamOutputSink(std::ostream &stream) : stream(stream) {}
+
+void StreamOutputSink::Write(double t, double y) {
+    /*! Write the record on one line of the stream
+    * \param t: time
+    * \param y: numerical solution at time t
+    */
+    stream << t << " " << y << "\n";
+}
+
+void StreamOutputSink::Flush() {
+    stream.flush();
+}
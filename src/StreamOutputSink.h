@@ -0,0 +1,21 @@
+#ifndef PCSC_PROJECT_STREAMOUTPUTSINK_H
+#define PCSC_PROJECT_STREAMOUTPUTSINK_H
+
+#include "AbstractOutputSink.h"
+#include <ostream>
+
+/** Daughter of AbstractOutputSink. Writes each record as a line "t y" to an output stream, which is the text format
+ * read by the tests and produced by main_solver.
+ */
+class StreamOutputSink : public AbstractOutputSink {
+public:
+    explicit StreamOutputSink(std::ostream &stream);
+    void Write(double t, double y) override;
+    void Flush() override;
+
+private:
+    std::ostream &stream;
+};
+
+
+#endif //PCSC_PROJECT_STREAMOUTPUTSINK_H
@@ -0,0 +1,18 @@
+#include "Trajectory.h"
+
+Trajectory::Trajectory() {}
+
+void Trajectory::Reserve(unsigned long records) {
+    /*! Reserve the memory of the records about to be written, so that Write never reallocates
+    * \param records: number of records that are about to be written
+    */
+    times.reserve(times.size() + records);
+    values.reserve(values.size() + records);
+}
+
+void Trajectory::Clear() {
+    /*! Remove all the records, keeping the memory for the next solution
+    */
+    times.clear();
+    values.clear();
+}
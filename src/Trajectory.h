@@ -0,0 +1,45 @@
+#ifndef PCSC_PROJECT_TRAJECTORY_H
+#define PCSC_PROJECT_TRAJECTORY_H
+
+#include "AbstractOutputSink.h"
+#include <cstddef>
+#include <vector>
+
+/** Numerical solution kept in memory, returned by AbstractOdeSolver::SolveEquation(). <br>
+ * The times and the values are stored in two separate contiguous arrays (structure of arrays), which are reserved
+ * once from the number of steps announced by the solver. A Trajectory is moved, not copied, when it is returned.
+ * GetTimeData and GetValueData give the raw arrays of Size elements, e.g. to pass them to analysis code without
+ * any copy. <br>
+ * Trajectory is also a sink: a solver can fill an existing trajectory with SolveEquation(AbstractOutputSink &).
+ */
+class Trajectory : public AbstractOutputSink {
+public:
+    Trajectory();
+    Trajectory(Trajectory &&other) noexcept = default;
+    Trajectory &operator=(Trajectory &&other) noexcept = default;
+    Trajectory(const Trajectory &other) = default;
+    Trajectory &operator=(const Trajectory &other) = default;
+
+    void Write(double t, double y) override {
+        times.push_back(t);
+        values.push_back(y);
+    }
+    void Reserve(unsigned long records) override;
+    void Clear();
+
+    size_t Size() const { return times.size(); }
+    bool Empty() const { return times.empty(); }
+    const std::vector<double> &GetTimes() const { return times; }
+    const std::vector<double> &GetValues() const { return values; }
+    const double *GetTimeData() const { return times.data(); }
+    const double *GetValueData() const { return values.data(); }
+    double GetTime(size_t i) const { return times[i]; }
+    double GetValue(size_t i) const { return values[i]; }
+
+private:
+    std::vector<double> times;
+    std::vector<double> values;
+};
+
+
+#endif //PCSC_PROJECT_TRAJECTORY_H
@@ -0,0 +1,110 @@
+#include "WorkPrecision.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+WorkPrecision::WorkPrecision(double (*sol)(double t))
+    /**
+    * Constructor of the class.
+    * \param sol: exact solution of the problem solved by the measured solvers
+    */
+    : sol(sol) {}
+
+WorkPrecisionPoint WorkPrecision::Measure(AbstractOdeSolver &solver) const {
+    /*! Run the solver once and measure its error and its cost
+    * \param solver: solver, with all its parameters set
+    * \return The step size, the error, the wall time and the number of evaluations of the run
+    */
+    WorkPrecisionPoint point;
+    point.h = solver.GetStepSize();
+    const auto start = std::chrono::steady_clock::now();
+    Trajectory trajectory = solver.SolveEquation();
+    const auto end = std::chrono::steady_clock::now();
+    point.seconds = std::chrono::duration<double>(end - start).count();
+    point.evaluations = solver.GetResult().rhsEvaluations;
+    point.records = trajectory.Size();
+    for (size_t i = 0; i < trajectory.Size(); i++) {
+        const double error = std::abs(trajectory.GetValue(i) - sol(trajectory.GetTime(i)));
+        // a non-finite value is an infinite error
+        point.error = std::isfinite(error) ? std::max(point.error, error) : INFINITY;
+    }
+    return point;
+}
+
+std::vector<WorkPrecisionPoint> WorkPrecision::SweepStepSize(AbstractOdeSolver &solver,
+                                                             const std::vector<double> &steps) const {
+    /*! Measure the solver for each step size
+    * \param solver: solver, with all its parameters but the step size set
+    * \param steps: step sizes
+    * \return One point for each step size
+    */
+    std::vector<WorkPrecisionPoint> points;
+    for (double h : steps) {
+        solver.SetStepSize(h);
+        points.push_back(Measure(solver));
+    }
+    return points;
+}
+
+std::vector<WorkPrecisionPoint> WorkPrecision::SweepTolerance(AbstractOdeSolver &solver,
+                                                              const std::vector<double> &tolerances,
+                                                              void (*setTolerance)(AbstractOdeSolver &, double))
+                                                              const {
+    /*! Measure an adaptive solver for each tolerance
+    * \param solver: solver, with all its parameters but the tolerance set
+    * \param tolerances: tolerances
+    * \param setTolerance: function setting the tolerance of the solver
+    * \return One point for each tolerance
+    */
+    std::vector<WorkPrecisionPoint> points;
+    for (double tol : tolerances) {
+        setTolerance(solver, tol);
+        points.push_back(Measure(solver));
+        points.back().tolerance = tol;
+    }
+    return points;
+}
+
+double WorkPrecision::ObservedOrder(const std::vector<WorkPrecisionPoint> &points, double noise) {
+    /*! Least squares fit of log(error) = p log(h) + c
+    * \param points: points of a sweep of the step size
+    * \param noise: errors below this value are dominated by round-off and are not used, as well as the errors
+    * bigger than 1, where the solver is not in its asymptotic regime (or unstable)
+    * \return The observed order p, NAN if less than two points can be used
+    */
+    double sum_x = 0., sum_y = 0., sum_xx = 0., sum_xy = 0.;
+    int n = 0;
+    for (const WorkPrecisionPoint &point : points) {
+        if (point.error > noise && point.error < 1. && point.h > 0.) {
+            const double x = std::log(point.h);
+            const double y = std::log(point.error);
+            sum_x += x;
+            sum_y += y;
+            sum_xx += x*x;
+            sum_xy += x*y;
+            n++;
+        }
+    }
+    const double denominator = n*sum_xx - sum_x*sum_x;
+    if (n < 2 || denominator <= 0.) {
+        return NAN;
+    }
+    return (n*sum_xy - sum_x*sum_y)/denominator;
+}
+
+void WorkPrecision::WriteTable(std::ostream &stream, const std::string &label,
+                               const std::vector<WorkPrecisionPoint> &points) {
+    /*! Write one line per point: label, h, tolerance, error, time in seconds, evaluations and records
+    * \param stream: output stream
+    * \param label: first column of each line, e.g. the problem, the solver and its order
+    * \param points: points of a sweep
+    */
+    const std::ios::fmtflags flags = stream.flags();
+    for (const WorkPrecisionPoint &point : points) {
+        stream << std::left << std::setw(24) << label << std::right << std::scientific << std::setprecision(4)
+               << std::setw(13) << point.h << std::setw(13) << point.tolerance << std::setw(13) << point.error
+               << std::setw(13) << point.seconds << std::setw(12) << point.evaluations << std::setw(10)
+               << point.records << "\n";
+    }
+    stream.flags(flags);
+}
@@ -0,0 +1,46 @@
+#ifndef PCSC_PROJECT_WORKPRECISION_H
+#define PCSC_PROJECT_WORKPRECISION_H
+
+#include "AbstractOdeSolver.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Accuracy and cost of one run of a solver.*/
+struct WorkPrecisionPoint {
+    double h = 0.;
+    /** tolerance of an adaptive solver, 0 for a fixed step size*/
+    double tolerance = 0.;
+    /** maximum over all the records of the absolute error with respect to the exact solution*/
+    double error = 0.;
+    double seconds = 0.;
+    unsigned long evaluations = 0;
+    unsigned long records = 0;
+};
+
+/** Measures how the accuracy of a solver trades against its cost, on a problem whose exact solution is known. <br>
+ * Measure runs the solver once, with its current parameters, and compares each record with the exact solution.
+ * SweepStepSize and SweepTolerance repeat the measure for several step sizes or tolerances, and ObservedOrder fits
+ * the slope p of log(error) = p log(h) + c, which is the empirical convergence order of the solver. The cost is the
+ * number of evaluations of the right hand side counted in the result of the solver, which does not depend on the
+ * machine.
+ */
+class WorkPrecision {
+public:
+    explicit WorkPrecision(double (*sol)(double t));
+
+    WorkPrecisionPoint Measure(AbstractOdeSolver &solver) const;
+    std::vector<WorkPrecisionPoint> SweepStepSize(AbstractOdeSolver &solver, const std::vector<double> &steps) const;
+    std::vector<WorkPrecisionPoint> SweepTolerance(AbstractOdeSolver &solver, const std::vector<double> &tolerances,
+                                                   void (*setTolerance)(AbstractOdeSolver &solver, double tol)) const;
+
+    static double ObservedOrder(const std::vector<WorkPrecisionPoint> &points, double noise = 1e-11);
+    static void WriteTable(std::ostream &stream, const std::string &label,
+                           const std::vector<WorkPrecisionPoint> &points);
+
+private:
+    double (*sol)(double t);
+};
+
+
+#endif //PCSC_PROJECT_WORKPRECISION_H
@@ -2,66 +2,94 @@
 #include "AdamsBashforthSolver.h"
 #include "RKSolver.h"
 #include "AdamsMoultonSolver.h"
+#include "ETDSolver.h"
+#include "LowStorageRKSolver.h"
+#include "ExtrapolationSolver.h"
+#include "AutoSolver.h"
+#include "RosenbrockSolver.h"
 #include "Exception.hpp"
 #include "FileNotOpenException.hpp"
 #include "UncoherentValueException.h"
 #include "SetOrderException.h"
 #include "WrongArgumentsException.h"
 #include "UnsetChoiceException.h"
+#include "ManifestException.h"
+#include "JobManifest.h"
+#include "ProblemLibrary.h"
+#include "Expression.h"
+#include "ExpressionException.h"
+#include "StreamOutputSink.h"
+#include "AsyncOutputSink.h"
+#include "MappedOutputSink.h"
+#include "CompressedOutputSink.h"
 
 #include <iostream>
 #include <sstream>
+#include <map>
 #include <cmath>
 
-int CHOICE;
-double fRhs(double y,double t){
-    try{
-        if (CHOICE==1) {
-            return 1 + t;
-        } else if (CHOICE==2) {
-            return -100*y;
-        } else if(CHOICE==3){
-            return sin(t)*cos(t);
-        } else {
-            throw UnsetChoiceException("The choice was not set, therefore fRhs could not be called");
-        }
-    } catch (UnsetChoiceException &error) {
-        error.PrintDebug();
-        std::cout << "Choice is set to 1." << std::endl;
-        CHOICE = 1;
-        return 1 + t;
+/** Right hand side chosen by the user, given to the solver as the context of fRhs, dfRhs and nRhs, so that
+ * several solvers can use different right hand sides at the same time. */
+struct RightHandSideChoice {
+    int choice = 0;
+    // problem of the ProblemLibrary (choices 1, 2, 3 and 5), set by new_solver for the choices 1, 2 and 3
+    const TestProblem *problem = nullptr;
+    // right hand side given by the user as an expression (choice = 4) and its derivative with respect to y
+    Expression expression;
+    Expression derivative;
+    bool expression_set = false;
+};
+double fRhs(double y, double t, void *context) {
+    // the choice is checked by new_solver
+    const RightHandSideChoice &rhs = *static_cast<const RightHandSideChoice *>(context);
+    if (rhs.choice == 4) {
+        return rhs.expression.Evaluate(y, t);
     }
+    return rhs.problem->f(y, t);
 }
-double dfRhs(double y, double t) {
-    try {
-        if (CHOICE == 1) {
-            return 0;
-        } else if (CHOICE == 2) {
-            return -100;
-        } else if (CHOICE == 3) {
-            return 0;
-        } else {
-            throw UnsetChoiceException("The choice was not set, therefore dfRhs could not be called");
-        }
-    } catch (UnsetChoiceException &error) {
-        error.PrintDebug();
-        std::cout << "Choice is set to 1." << std::endl;
-        CHOICE = 1;
-        return 0;
+double dfRhs(double y, double t, void *context) {
+    const RightHandSideChoice &rhs = *static_cast<const RightHandSideChoice *>(context);
+    if (rhs.choice == 4) {
+        return rhs.derivative.Evaluate(y, t);
     }
+    return rhs.problem->df(y, t);
+}
+double lRhs(const RightHandSideChoice &rhs) {
+    // linear coefficient L of the right hand side f(y,t) = L*y + N(y,t), used by the ETD solver.
+    if (rhs.choice == 4) {
+        // the linear part of an expression is only known when the expression is linear in y
+        return rhs.derivative.IsConstant() ? rhs.derivative.Evaluate(0, 0) : 0;
+    }
+    return rhs.problem->linearPart;
+}
+double nRhs(double y, double t, void *context) {
+    // nonlinear part N(y,t) = f(y,t) - L*y of the right hand side, used by the ETD solver.
+    return fRhs(y, t, context) - lRhs(*static_cast<const RightHandSideChoice *>(context))*y;
 }
 
 void check_type_solver(std::string &type_solver);
 void check_step_size(double &h);
 void check_time_interval(double &t0, double &t1);
 void check_order(unsigned int &order);
-void check_choice(int &choice);
-void enter_data(AbstractOdeSolver* &pSolver);
+void check_choice(RightHandSideChoice &rhs);
+void set_expression(RightHandSideChoice &rhs, const std::string &text, const std::map<std::string, double> &parameters);
+void enter_expression(RightHandSideChoice &rhs);
+void enter_problem(RightHandSideChoice &rhs);
+void print_choices();
+void enter_data(AbstractOdeSolver* &pSolver, RightHandSideChoice &rhs);
+AbstractOdeSolver* new_solver(const std::string &type_solver, RightHandSideChoice &rhs);
+int run_manifest(const std::string &filename);
 void set_data(AbstractOdeSolver* &pSolver, std::string &type_solver, double &h, double &t0, double &t1, double &y0,
-              unsigned int &order, int &choice);
+              unsigned int &order, RightHandSideChoice &rhs);
 
 int main(int argc, char **argv) {
+    if (argc == 3 && std::string(argv[1]) == "--manifest") {
+        // manifest mode: the jobs are read from a file and the user is never prompted.
+        return run_manifest(argv[2]);
+    }
     AbstractOdeSolver *pSolver;
+    // must live as long as the solver, which calls the right hand side with it
+    RightHandSideChoice rhs;
     try {
         if (argc == 8){
             // the right number of arguments was given by the user.
@@ -71,7 +99,6 @@ int main(int argc, char **argv) {
             double t1;
             double y0;
             unsigned int order;
-            int choice;
 
             for(int i=0; i<8; i++) {
                 std::stringstream arg(argv[i]);
@@ -95,25 +122,43 @@ int main(int argc, char **argv) {
                         arg >> order;
                         break;
                     case 7:
-                        arg >> choice;
+                        arg >> rhs.choice;
+                        if (arg.fail() || !arg.eof()) {
+                            rhs.problem = ProblemLibrary::Find(argv[i]);
+                            if (rhs.problem != nullptr) {
+                                // the function is a problem of the library given by its name, e.g. "logistic"
+                                rhs.choice = 5;
+                                arg.clear();
+                                break;
+                            }
+                            // the function is given as an expression of y and t, e.g. "-100*y + sin(t)"
+                            try {
+                                set_expression(rhs, argv[i], {});
+                                rhs.choice = 4;
+                            } catch (ExpressionException &error) {
+                                error.PrintDebug();
+                                rhs.choice = 0;
+                            }
+                            arg.clear();
+                        }
                         break;
                 }
                 if(arg.fail()){
                     throw Exception("CORRUPTED_ARGUMENT", "Argument " + std::to_string(i) + " failed.");
                 }
             }
-            set_data(pSolver, type_solver, h, t0, t1, y0, order, choice);
+            set_data(pSolver, type_solver, h, t0, t1, y0, order, rhs);
 
         } else if(argc == 1){
             // no argument was given by the user. Therefore he/she must be give them in enter_data.
-            enter_data(pSolver);
+            enter_data(pSolver, rhs);
         } else {
             throw WrongArgumentsException("Wrong number of arguments was entered.");
         }
     } catch (WrongArgumentsException &error) {
         error.PrintDebug();
         std::cout << "You have entered " << argc << " argument(s). Please fill the right arguments now." << std::endl;
-        enter_data(pSolver);
+        enter_data(pSolver, rhs);
     }
 
     std::string filename_solver("solution_file.dat");
@@ -121,7 +166,11 @@ int main(int argc, char **argv) {
     SolveFile.open(filename_solver, std::ios::out);
     try {
         if (SolveFile.is_open()) {
-            pSolver->SolveEquation(SolveFile);
+            // the file is written by another thread while the solver runs
+            StreamOutputSink file_sink(SolveFile);
+            AsyncOutputSink sink(file_sink);
+            pSolver->SolveEquation(sink);
+            sink.Close();
             SolveFile.close();
         } else {
             throw FileNotOpenException("File can't be opened.");
@@ -141,15 +190,22 @@ void check_type_solver(std::string &type_solver){
      * For Adams-Moulton: "AM"
      * For Adams-Bashforth: "AB"
      * For Runge-Kutta: "RK"
+     * For low-storage Runge-Kutta: "LSRK"
+     * For exponential time-differencing: "ETD"
+     * For Gragg-Bulirsch-Stoer extrapolation: "GBS"
+     * For Rosenbrock: "ROS"
+     * For the automatic choice of the method: "auto"
     */
     try{
-        if(!((type_solver == "AM") || (type_solver == "AB") || (type_solver == "RK"))) {
+        if(!((type_solver == "AM") || (type_solver == "AB") || (type_solver == "RK") || (type_solver == "ETD")
+             || (type_solver == "GBS") || (type_solver == "LSRK") || (type_solver == "ROS")
+             || (type_solver == "auto"))) {
             throw WrongArgumentsException("Wrong string was entered as argument.");
         }
     } catch (WrongArgumentsException &error) {
         error.PrintDebug();
         std::cout << "Please enter the right string." << std::endl;
-        std::cout << "First, choose which type of solver you would like : \n 'AM' : Adams-Moulton \n 'AB' : Adams-Bashforth \n 'RK' : Runge-Kutta: ";
+        std::cout << "First, choose which type of solver you would like : \n 'AM' : Adams-Moulton \n 'AB' : Adams-Bashforth \n 'RK' : Runge-Kutta \n 'LSRK' : low-storage Runge-Kutta \n 'ETD' : Exponential time-differencing \n 'GBS' : Gragg-Bulirsch-Stoer extrapolation \n 'ROS' : Rosenbrock \n 'auto' : automatic choice of the method from the stiffness: ";
         std::cin >> type_solver;
         check_type_solver(type_solver);
     }
@@ -237,42 +293,107 @@ void check_order(unsigned int &order){
     }
 }
 
-void check_choice(int &choice){
+void check_choice(RightHandSideChoice &rhs){
     /*!
      * Check if the given choice is coherent.
-    * \param choice : choice of the function. It should be 1, 2 or 3.
+    * \param rhs : right hand side, whose choice should be 1, 2, 3, 4 or 5.
     */
+    int &choice = rhs.choice;
     try {
-        if (!(choice == 1 || choice == 2 || choice == 3)){
-            throw UncoherentValueException("Choice must be either 1, 2, or 3.");
+        if (choice < 1 || choice > 5){
+            throw UncoherentValueException("Choice must be either 1, 2, 3, 4 or 5.");
         }
     } catch (UncoherentValueException &error) {
         error.PrintDebug();
-        std::cout<< "Please enter the function you want among these functions:" <<std::endl;
-        std::cout <<"1: f(y,t) = 1+t" <<std::endl;
-        std::cout<<"2: f(y,t) = -100*y" <<std::endl;
-        std::cout<<"3: f(y,t) = sin(t)*cos(t)" <<std::endl;
-        std::cout<<"You choose function number:";
+        print_choices();
         std::cin>>choice;
-        check_choice(choice);
+        check_choice(rhs);
+    }
+    if (choice == 4 && !rhs.expression_set) {
+        enter_expression(rhs);
+    }
+    if (choice == 5 && rhs.problem == nullptr) {
+        enter_problem(rhs);
     }
 }
 
-void enter_data(AbstractOdeSolver *&pSolver) {
+void print_choices() {
+    /*!
+     * Print the functions the user can choose.
+    */
+    std::cout<< "Please enter the function you want among these functions:" <<std::endl;
+    std::cout <<"1: f(y,t) = 1+t" <<std::endl;
+    std::cout<<"2: f(y,t) = -100*y" <<std::endl;
+    std::cout<<"3: f(y,t) = sin(t)*cos(t)" <<std::endl;
+    std::cout<<"4: f(y,t) given as an expression of y and t" <<std::endl;
+    std::cout<<"5: a standard problem of the library, given by its name" <<std::endl;
+    std::cout<<"You choose function number:";
+}
+
+void set_expression(RightHandSideChoice &rhs, const std::string &text, const std::map<std::string, double> &parameters) {
+    /*!
+     * Compile the expression of the right hand side and its derivative with respect to y.
+    * \param rhs: right hand side receiving the expression
+     * \param text: expression of y, t and the parameters
+     * \param parameters: names and values of the parameters
+    */
+    rhs.expression = Expression(text, parameters);
+    rhs.derivative = rhs.expression.Derivative("y");
+    rhs.expression_set = true;
+}
+
+void enter_expression(RightHandSideChoice &rhs) {
+    /*!
+     * Let the user enter the right hand side as an expression.
+    * \param rhs: right hand side receiving the expression
+    */
+    std::string text;
+    std::cout << "Enter f(y,t) as an expression of y and t, e.g. -100*y + sin(t): ";
+    std::cin >> std::ws;
+    std::getline(std::cin, text);
+    try {
+        set_expression(rhs, text, {});
+    } catch (ExpressionException &error) {
+        error.PrintDebug();
+        enter_expression(rhs);
+    }
+}
+
+void enter_problem(RightHandSideChoice &rhs) {
+    /*!
+     * Let the user choose a problem of the library by its name.
+    * \param rhs: right hand side receiving the problem
+    */
+    std::cout << "The problems of the library are:" << std::endl;
+    for (const TestProblem &problem : ProblemLibrary::GetProblems()) {
+        std::cout << " '" << problem.name << "' : " << problem.description << ", y(" << problem.t0 << ") = "
+                  << problem.y0 << std::endl;
+    }
+    std::string name;
+    std::cout << "Your problem: ";
+    std::cin >> name;
+    rhs.problem = ProblemLibrary::Find(name);
+    if (rhs.problem == nullptr) {
+        std::cout << "No problem is called " << name << "." << std::endl;
+        enter_problem(rhs);
+    }
+}
+
+void enter_data(AbstractOdeSolver *&pSolver, RightHandSideChoice &rhs) {
     /*!
      * Let the user enter the arguments of the solver.
     * \param pSolver: Abstract ODE solver pointer.
+     * \param rhs: right hand side chosen by the user, which must live as long as the solver.
     */
     double h;
     double t0;
     double t1;
     double y0;
     unsigned int order;
-    int choice;
     std::string type_solver;
     std::cout << "\n                  Welcome to \n ~Abstract ODE Solver : the new generation~ \n   ---- By S. Lunven & A.-A. Mauron ---- \n" << std::endl;
 
-    std::cout << "First, choose which type of solver you would like : \n 'AM' : Adams-Moulton \n 'AB' : Adams-Bashforth \n 'RK' : Runge-Kutta: " << std::endl;
+    std::cout << "First, choose which type of solver you would like : \n 'AM' : Adams-Moulton \n 'AB' : Adams-Bashforth \n 'RK' : Runge-Kutta \n 'LSRK' : low-storage Runge-Kutta \n 'ETD' : Exponential time-differencing \n 'GBS' : Gragg-Bulirsch-Stoer extrapolation \n 'ROS' : Rosenbrock \n 'auto' : automatic choice of the method from the stiffness: " << std::endl;
     std::cout << "Your solver: ";
     std::cin >> type_solver;
     check_type_solver(type_solver);
@@ -289,18 +410,14 @@ void enter_data(AbstractOdeSolver *&pSolver) {
     std::cout << "Enter the order of the method: ";
     std::cin >> order;
     check_order(order);
-    std::cout<< "Please enter the function you want among these functions:" <<std::endl;
-    std::cout <<"1: f(y,t) = 1+t" <<std::endl;
-    std::cout<<"2: f(y,t) = -100*y" <<std::endl;
-    std::cout<<"3: f(y,t) = sin(t)*cos(t)" <<std::endl;
-    std::cout<<"You choose function number:";
-    std::cin>>choice;
-    check_choice(choice);
-    set_data(pSolver, type_solver, h, t0, t1, y0, order, choice);
+    print_choices();
+    std::cin>>rhs.choice;
+    check_choice(rhs);
+    set_data(pSolver, type_solver, h, t0, t1, y0, order, rhs);
 }
 
 void set_data(AbstractOdeSolver* &pSolver, std::string &type_solver, double &h, double &t0, double &t1, double &y0,
-              unsigned int &order, int &choice) {
+              unsigned int &order, RightHandSideChoice &rhs) {
     /*!
      * Check if the arguments are coherent. Then set the solver with them.
     * \param pSolver: Abstract ODE solver pointer.
@@ -310,7 +427,7 @@ void set_data(AbstractOdeSolver* &pSolver, std::string &type_solver, double &h,
      * \param t1: final time
      * \param y0: initial value
      * \param order: order of the method
-     * \param choice: choice of the right hand side function.
+     * \param rhs: right hand side function, which must live as long as the solver.
     */
     std::cout << "You have entered the following arguments  ";
     std::cout << "\ntype solver: " << type_solver;
@@ -319,28 +436,173 @@ void set_data(AbstractOdeSolver* &pSolver, std::string &type_solver, double &h,
     std::cout << "\nt1 = " << t1;
     std::cout << "\ny0 = " << y0;
     std::cout << "\norder: " << order;
-    std::cout << "\nchoice: " << choice << std::endl;
+    std::cout << "\nchoice: " << rhs.choice << std::endl;
     check_type_solver(type_solver);
+    check_step_size(h);
+    check_time_interval(t0, t1);
+    check_order(order);
+    check_choice(rhs);
+
+    pSolver = new_solver(type_solver, rhs);
+    pSolver->SetStepSize(h);
+    pSolver->SetTimeInterval(t0, t1);
+    pSolver->SetInitialValue(y0);
+    pSolver->SetOrder(order);
+}
+
+AbstractOdeSolver* new_solver(const std::string &type_solver, RightHandSideChoice &rhs) {
+    /*!
+     * Create a solver of the given type with its right hand side, without checking the arguments.
+     * \param type_solver: string indicating the type of the solver, assumed to be coherent.
+     * \param rhs: right hand side function, given as context to the solver: it must live as long as the solver.
+     * \return pointer to the new solver, to be deleted by the caller.
+    */
+    try {
+        if (rhs.choice < 1 || rhs.choice > 5 || (rhs.choice == 4 && !rhs.expression_set)
+            || (rhs.choice == 5 && rhs.problem == nullptr)) {
+            throw UnsetChoiceException("The choice was not set, therefore the right hand side could not be set");
+        }
+    } catch (UnsetChoiceException &error) {
+        error.PrintDebug();
+        std::cout << "Choice is set to 1." << std::endl;
+        rhs.choice = 1;
+    }
+    if (rhs.choice <= 3) {
+        // the functions 1, 2 and 3 are the first problems of the library
+        rhs.problem = &ProblemLibrary::GetProblems()[rhs.choice - 1];
+    }
+    AbstractOdeSolver* pSolver = nullptr;
     if(type_solver == "AM"){
         AdamsMoultonSolver* pSolverTemp = new AdamsMoultonSolver;
-        pSolverTemp->SetdRightHandSide(dfRhs);
+        pSolverTemp->SetdRightHandSide(dfRhs, &rhs);
         pSolver = pSolverTemp;
     } else if(type_solver == "AB"){
         pSolver = new AdamsBashforthSolver;
     } else if(type_solver == "RK"){
         pSolver = new RKSolver;
+    } else if(type_solver == "LSRK"){
+        pSolver = new LowStorageRKSolver;
+    } else if(type_solver == "ETD"){
+        // the ETD solver integrates the linear part exactly, its right hand side is the nonlinear part only.
+        ETDSolver* pSolverTemp = new ETDSolver;
+        pSolverTemp->SetLinearPart(lRhs(rhs));
+        pSolverTemp->SetRightHandSide(nRhs, &rhs);
+        return pSolverTemp;
+    } else if(type_solver == "GBS"){
+        pSolver = new ExtrapolationSolver;
+    } else if(type_solver == "ROS"){
+        // the Jacobian of each step is df
+        RosenbrockSolver* pSolverTemp = new RosenbrockSolver;
+        pSolverTemp->SetdRightHandSide(dfRhs, &rhs);
+        pSolver = pSolverTemp;
+    } else if(type_solver == "auto"){
+        // the step size is the largest one, the stiffness is estimated with df
+        AutoSolver* pSolverTemp = new AutoSolver;
+        pSolverTemp->SetdRightHandSide(dfRhs, &rhs);
+        pSolver = pSolverTemp;
     } else {
         std::cerr << "No solver corresponds to type_solver." << std::endl;
+        return nullptr;
     }
-    check_step_size(h);
-    check_time_interval(t0, t1);
-    check_order(order);
-    check_choice(choice);
+    pSolver->SetRightHandSide(fRhs, &rhs);
+    return pSolver;
+}
 
-    pSolver->SetStepSize(h);
-    pSolver->SetTimeInterval(t0, t1);
-    pSolver->SetInitialValue(y0);
-    pSolver->SetRightHandSide(fRhs);
-    pSolver->SetOrder(order);
-    CHOICE = choice;
+int run_manifest(const std::string &filename) {
+    /*!
+     * Run all the jobs of a manifest one after the other. The whole manifest is validated before the first job is
+     * run, and the user is never prompted.
+     * \param filename: name of the manifest file.
+     * \return 0 if all the jobs were run, 1 otherwise.
+    */
+    std::vector<Job> jobs;
+    try {
+        jobs = JobManifest(filename).GetJobs();
+    } catch (ManifestException &error) {
+        error.PrintDebug();
+        return 1;
+    }
+    int status = 0;
+    for (const Job &job : jobs) {
+        RightHandSideChoice rhs;
+        rhs.choice = job.choice;
+        if (job.choice == 4) {
+            // the expression was already checked when the manifest was read
+            set_expression(rhs, job.rhs, job.parameters);
+        } else if (job.choice == 5) {
+            // the name was already checked when the manifest was read
+            rhs.problem = ProblemLibrary::Find(job.problem);
+        }
+        AbstractOdeSolver* pSolver = new_solver(job.type_solver, rhs);
+        pSolver->SetStepSize(job.h);
+        pSolver->SetTimeInterval(job.t0, job.t1);
+        pSolver->SetInitialValue(job.y0);
+        pSolver->SetOrder(job.order);
+        if(job.type_solver == "GBS"){
+            ExtrapolationSolver* pSolverTemp = static_cast<ExtrapolationSolver*>(pSolver);
+            pSolverTemp->SetTolerance(job.tolerance);
+            pSolverTemp->SetNumberOfThreads(job.threads);
+        } else if(job.type_solver == "ROS"){
+            static_cast<RosenbrockSolver*>(pSolver)->SetTolerance(job.tolerance);
+        } else if(job.type_solver == "auto" && job.tolerance > 0){
+            static_cast<AutoSolver*>(pSolver)->SetTolerance(job.tolerance);
+        }
+
+        if (job.format == "binary") {
+            // the solver writes straight into the mapped file, no writer thread is needed
+            try {
+                MappedOutputSink sink(job.output);
+                pSolver->SolveEquation(sink);
+                sink.Close();
+                std::cout << "The solution is stored in " + job.output << std::endl;
+            } catch (FileNotOpenException &error) {
+                error.PrintDebug();
+                status = 1;
+            }
+            delete pSolver;
+            continue;
+        } else if (job.format == "compressed") {
+            // the blocks are compressed and written by a worker thread
+            try {
+                CompressedOutputSink sink(job.output, job.quantum);
+                pSolver->SolveEquation(sink);
+                sink.Close();
+                std::cout << "The solution is stored in " + job.output << std::endl;
+            } catch (FileNotOpenException &error) {
+                error.PrintDebug();
+                status = 1;
+            }
+            delete pSolver;
+            continue;
+        }
+        std::fstream SolveFile;
+        SolveFile.open(job.output, std::ios::out);
+        try {
+            if (SolveFile.is_open()) {
+                Backpressure policy = Backpressure::Block;
+                if (job.backpressure == "decimate") {
+                    policy = Backpressure::Decimate;
+                } else if (job.backpressure == "grow") {
+                    policy = Backpressure::Grow;
+                }
+                StreamOutputSink file_sink(SolveFile);
+                AsyncOutputSink sink(file_sink, 1 << 14, policy);
+                pSolver->SolveEquation(sink);
+                sink.Close();
+                if (sink.GetNumberOfDroppedRecords() > 0) {
+                    std::cout << sink.GetNumberOfDroppedRecords() << " records were dropped to keep up with the "
+                              << "solver." << std::endl;
+                }
+                SolveFile.close();
+                std::cout << "The solution is stored in " + job.output << std::endl;
+            } else {
+                throw FileNotOpenException("File " + job.output + " can't be opened.");
+            }
+        } catch (FileNotOpenException &error) {
+            error.PrintDebug();
+            status = 1;
+        }
+        delete pSolver;
+    }
+    return status;
 }
\ No newline at end of file
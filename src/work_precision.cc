@@ -0,0 +1,192 @@
+#include "AbstractOdeSolver.hpp"
+#include "AdamsBashforthSolver.h"
+#include "AdamsMoultonSolver.h"
+#include "RKSolver.h"
+#include "ETDSolver.h"
+#include "LowStorageRKSolver.h"
+#include "ExtrapolationSolver.h"
+#include "RosenbrockSolver.h"
+#include "ProblemLibrary.h"
+#include "WorkPrecision.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Work-precision benchmark: sweeps the step size of every solver and order (and the tolerance of the adaptive
+// extrapolation solver) on problems with known exact solutions, and writes the error, the wall time and the number
+// of evaluations of the right hand side of each run, as well as the observed convergence order of each method.
+//   ./work_precision [--problem name] [--solver type] [--target error] [--output file]
+
+struct Problem {
+    const TestProblem *problem;
+    // step sizes 2^-k, k = first_k, ..., last_k: the number of steps is exact
+    int first_k;
+    int last_k;
+};
+
+struct Method {
+    std::string type;
+    unsigned int order_min;
+    unsigned int order_max;
+};
+
+unsigned int nominal_order(const std::string &type, unsigned int order) {
+    // order of convergence of each solver for a given order parameter
+    if (type == "AM") {
+        return order + 1;
+    } else if (type == "GBS") {
+        return 2*order;
+    }
+    return order;
+}
+
+std::unique_ptr<AbstractOdeSolver> new_solver(const std::string &type, const Problem &problem) {
+    std::unique_ptr<AbstractOdeSolver> solver;
+    if (type == "AB") {
+        solver.reset(new AdamsBashforthSolver);
+    } else if (type == "AM") {
+        auto *implicit_solver = new AdamsMoultonSolver;
+        implicit_solver->SetdRightHandSide(problem.problem->df);
+        solver.reset(implicit_solver);
+    } else if (type == "RK") {
+        solver.reset(new RKSolver);
+    } else if (type == "LSRK") {
+        solver.reset(new LowStorageRKSolver);
+    } else if (type == "ETD") {
+        auto *etd_solver = new ETDSolver;
+        etd_solver->SetLinearPart(problem.problem->linearPart);
+        // the right hand side of the ETD solver is the nonlinear part of the problem
+        etd_solver->SetRightHandSide(problem.problem->nonlinearPart);
+        solver.reset(etd_solver);
+    } else if (type == "ROS") {
+        auto *rosenbrock_solver = new RosenbrockSolver;
+        rosenbrock_solver->SetdRightHandSide(problem.problem->df);
+        solver.reset(rosenbrock_solver);
+    } else {
+        solver.reset(new ExtrapolationSolver);
+    }
+    if (type != "ETD") {
+        solver->SetRightHandSide(problem.problem->f);
+    }
+    solver->SetTimeInterval(problem.problem->t0, problem.problem->t1);
+    solver->SetInitialValue(problem.problem->y0);
+    return solver;
+}
+
+void set_tolerance(AbstractOdeSolver &solver, double tol) {
+    static_cast<ExtrapolationSolver &>(solver).SetTolerance(tol);
+}
+
+int main(int argc, char *argv[]) {
+    std::string only_problem;
+    std::string only_solver;
+    std::string output;
+    double target = 1e-6;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string option(argv[i]);
+        if (option == "--problem") {
+            only_problem = argv[i+1];
+        } else if (option == "--solver") {
+            only_solver = argv[i+1];
+        } else if (option == "--target") {
+            target = std::atof(argv[i+1]);
+        } else if (option == "--output") {
+            output = argv[i+1];
+        } else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "Usage: " << argv[0] << " [--problem name] [--solver type] [--target error] [--output file]"
+                  << std::endl;
+        return 1;
+    }
+
+    // all the problems of the library, the stiff ones with smaller steps so that the explicit solvers are stable
+    std::vector<Problem> problems;
+    for (const TestProblem &problem : ProblemLibrary::GetProblems()) {
+        if (problem.stiff) {
+            problems.push_back({&problem, 7, 13});
+        } else {
+            problems.push_back({&problem, 3, 9});
+        }
+    }
+    const std::vector<Method> methods = {
+            {"AB", 1, max_order}, {"AM", 0, max_order-1}, {"RK", 1, 4}, {"LSRK", 1, 4}, {"ETD", 1, 4},
+            {"ROS", 1, 4}, {"GBS", 1, max_extrapolation_stages},
+    };
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            std::cerr << "File " << output << " can't be opened." << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &table = output.empty() ? std::cout : file;
+    table << "# label                         h    tolerance        error      seconds evaluations   records\n";
+
+    std::stringstream summary;
+    summary << "# problem        method  nominal  observed  evaluations for error <= " << target << "\n";
+    for (const Problem &problem : problems) {
+        if (!only_problem.empty() && problem.problem->name != only_problem) {
+            continue;
+        }
+        WorkPrecision work_precision(problem.problem->solution);
+        std::vector<double> steps;
+        for (int k = problem.first_k; k <= problem.last_k; k++) {
+            steps.push_back(std::ldexp(1., -k));
+        }
+        for (const Method &method : methods) {
+            if (!only_solver.empty() && method.type != only_solver) {
+                continue;
+            }
+            for (unsigned int order = method.order_min; order <= method.order_max; order++) {
+                std::unique_ptr<AbstractOdeSolver> solver = new_solver(method.type, problem);
+                solver->SetOrder(order);
+                const std::string label = problem.problem->name + "/" + method.type + std::to_string(order);
+                std::vector<WorkPrecisionPoint> points = work_precision.SweepStepSize(*solver, steps);
+                WorkPrecision::WriteTable(table, label, points);
+
+                unsigned long cheapest = 0;
+                for (const WorkPrecisionPoint &point : points) {
+                    if (point.error <= target && (cheapest == 0 || point.evaluations < cheapest)) {
+                        cheapest = point.evaluations;
+                    }
+                }
+                summary << std::left << std::setw(16) << problem.problem->name << std::setw(8)
+                        << method.type + std::to_string(order) << std::right << std::setw(7)
+                        << nominal_order(method.type, order) << std::setw(10) << std::fixed << std::setprecision(2)
+                        << WorkPrecision::ObservedOrder(points) << std::setw(13);
+                if (cheapest > 0) {
+                    summary << cheapest << "\n";
+                } else {
+                    summary << "-" << "\n";
+                }
+
+                if (method.type == "GBS") {
+                    // adaptive step size: the error is driven by the tolerance
+                    solver->SetStepSize(steps.front());
+                    std::vector<double> tolerances;
+                    for (int e = 3; e <= 12; e++) {
+                        tolerances.push_back(std::pow(10., -e));
+                    }
+                    points = work_precision.SweepTolerance(*solver, tolerances, set_tolerance);
+                    WorkPrecision::WriteTable(table, label + "/adaptive", points);
+                    set_tolerance(*solver, 0.);
+                }
+            }
+        }
+    }
+    std::cout << summary.str();
+    return 0;
+}
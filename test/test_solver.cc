@@ -7,7 +7,43 @@
 #include "../src/AdamsMoultonSolver.h"
 #include "../src/AdamsBashforthSolver.h"
 #include "../src/RKSolver.h"
+#include "../src/LowStorageRKSolver.h"
+#include "../src/ETDSolver.h"
+#include "../src/ExtrapolationSolver.h"
 #include "../src/FileNotOpenException.hpp"
+#include "../src/JobManifest.h"
+#include "../src/ManifestException.h"
+#include "../src/Expression.h"
+#include "../src/ExpressionException.h"
+#include "../src/StreamOutputSink.h"
+#include "../src/AsyncOutputSink.h"
+#include "../src/SpscRingBuffer.h"
+#include "../src/MappedOutputSink.h"
+#include "../src/Trajectory.h"
+#include "../src/CompressedOutputSink.h"
+#include "../src/WorkPrecision.h"
+#include "../src/DiagnosticLog.h"
+#include "../src/ForwardSensitivity.h"
+#include "../src/RKAdjoint.h"
+#include "../src/PIStepSizeController.h"
+#include "../src/PIDStepSizeController.h"
+#include "../src/AdamsCoefficients.h"
+#include "../src/LinearCombination.h"
+#include "../src/MethodOfLines.h"
+#include "../src/ProblemLibrary.h"
+#include "../src/AutoSolver.h"
+#include "../src/RosenbrockSolver.h"
+#include "../src/DelayHistory.h"
+#include "../src/DDESolver.h"
+#include "../src/Philox.h"
+#include "../src/SDESolver.h"
+#include "../src/RKNSolver.h"
+#include "../src/UncoherentValueException.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <chrono>
+#include <thread>
 
 const double TOL = 1e-5;
 
@@ -52,83 +88,48 @@ void Test_results(AbstractOdeSolver *solver, std::string filename_solver, std::s
     }
 }
 
-void Test_final_results(AbstractOdeSolver *solver, std::string filename_solver, double (*sol)(double t), const double tol = TOL){
-    // check that the last line of result is the same as the one given by the solution function.
-    std::fstream SolveFile;
-    SolveFile.open(filename_solver, std::ios::out);
-    if (SolveFile.is_open()) {
-        solver->SolveEquation(SolveFile);
-        SolveFile.close();
-    } else {
-        throw FileNotOpenException("File can't be opened.");
-    }
-
-    // check that the second to last line correspond between the solve data and the solution given by Euler Forward
-    SolveFile.open(filename_solver, std::ios::in);
-    if (!SolveFile.is_open()) {
-        throw FileNotOpenException("File can't be opened.");
-    }
-
-    while(SolveFile.is_open()) {
-        // store the line and previous lines of the files
-        std::string solve_line;
-        std::string solve_line_prev;
+void Test_final_results(AbstractOdeSolver *solver, double (*sol)(double t), const double tol = TOL){
+    // check that the last record of the result is the same as the one given by the solution function.
+    Trajectory trajectory = solver->SolveEquation();
+    ASSERT_GT(trajectory.Size(), 0u);
 
-        do {
-            solve_line_prev = solve_line;
-        } while (std::getline(SolveFile, solve_line));
+    double final_time = solver->GetFinalTime();
+    double y_sol = sol(final_time);
 
-        //only check that the last line is similar.
-        std::stringstream ss(solve_line_prev);
-        double t;
-        ss >> t;
-        double y;
-        ss >> y;
-
-        double final_time = solver->GetFinalTime();
-        double y_sol = sol(final_time);
-
-        EXPECT_NEAR(y, y_sol, tol);
-        EXPECT_NEAR(t, final_time, tol);
-
-        SolveFile.close();
-    }
+    EXPECT_NEAR(trajectory.GetValues().back(), y_sol, tol);
+    EXPECT_NEAR(trajectory.GetTimes().back(), final_time, tol);
 }
 
-void Test_function(AbstractOdeSolver *solver, std::string filename_solver, double (*fRhs)(double y, double t),
-                   double (*sol)(double t), const double tol = TOL){
+void Test_function(AbstractOdeSolver *solver, double (*fRhs)(double y, double t), double (*sol)(double t),
+                   const double tol = TOL){
     solver->SetRightHandSide(fRhs);
-    Test_final_results(solver, filename_solver, sol, tol);
+    Test_final_results(solver, sol, tol);
 }
 
-void Test_orders(AbstractExplicitSolver *solver, int order_min, int order_max, std::string prefix_filename_solver,
-                 double tol=TOL){
+void Test_orders(AbstractExplicitSolver *solver, int order_min, int order_max, double tol=TOL){
     for(int order=order_min; order<=order_max; order++){
         solver->SetOrder(order);
-        std::string filename_solver = prefix_filename_solver + "order" + std::to_string(order);
         solver->SetInitialValue(0.);
-        Test_function(solver, filename_solver + "_fRhs1", fRhs1, sol1, tol);
+        Test_function(solver, fRhs1, sol1, tol);
         solver->SetInitialValue(0.8);
-        Test_function(solver, filename_solver + "_fRhs2", fRhs2, sol2, tol);
+        Test_function(solver, fRhs2, sol2, tol);
         solver->SetInitialValue(0.);
-        Test_function(solver, filename_solver + "_fRhs3", fRhs3, sol3, tol);
+        Test_function(solver, fRhs3, sol3, tol);
     }
 }
 
-void Test_orders(AbstractImplicitSolver *solver, int order_min, int order_max, std::string prefix_filename_solver,
-                 double tol=TOL){
+void Test_orders(AbstractImplicitSolver *solver, int order_min, int order_max, double tol=TOL){
     for(int order=order_min; order<=order_max; order++){
         solver->SetOrder(order);
-        std::string filename_solver = prefix_filename_solver + "order" + std::to_string(order);
         solver->SetInitialValue(0.);
         solver->SetdRightHandSide(dfRhs1);
-        Test_function(solver, filename_solver + "_fRhs1", fRhs1, sol1, tol);
+        Test_function(solver, fRhs1, sol1, tol);
         solver->SetInitialValue(0.8);
         solver->SetdRightHandSide(dfRhs2);
-        Test_function(solver, filename_solver + "_fRhs2", fRhs2, sol2, tol);
+        Test_function(solver, fRhs2, sol2, tol);
         solver->SetInitialValue(0.);
         solver->SetdRightHandSide(dfRhs3);
-        Test_function(solver, filename_solver + "_fRhs3", fRhs3, sol3, tol);
+        Test_function(solver, fRhs3, sol3, tol);
     }
 }
 
@@ -213,8 +214,7 @@ TEST(AdamsMoultonSolver_test, EulerBackward_fRhs1) {
     double y0 = 0.;
     unsigned int s = 0;
     AdamsMoultonSolver solver(h, t0, t1, y0, fRhs1, dfRhs1, s);
-    std::string filename_solver("test_AM_fRhs1_s1.dat");
-    Test_final_results(&solver, filename_solver, sol1, 0.011);
+    Test_final_results(&solver, sol1, 0.011);
 }
 
 TEST(AdamsMoultonSolver_test, EulerBackward_fRhs2) {
@@ -224,9 +224,8 @@ TEST(AdamsMoultonSolver_test, EulerBackward_fRhs2) {
     double y0 = 0.8;
     unsigned int s = 0;
     AdamsMoultonSolver solver(h, t0, t1, y0, fRhs2,dfRhs2, s);
-    std::string filename_solver("test_AM_fRhs2_s1.dat");
 
-    Test_final_results(&solver, filename_solver, sol2, 0.01);
+    Test_final_results(&solver, sol2, 0.01);
 }
 
 TEST(AdamsMoultonSolver_test, EulerBackward_fRhs3) {
@@ -236,8 +235,7 @@ TEST(AdamsMoultonSolver_test, EulerBackward_fRhs3) {
     double y0 = 0.;
     unsigned int s = 0;
     AdamsMoultonSolver solver(h, t0, t1, y0, fRhs3,dfRhs3, s);
-    std::string filename_solver("test_AM_fRhs3_s1.dat");
-    Test_final_results(&solver, filename_solver, sol3, 0.01);
+    Test_final_results(&solver, sol3, 0.01);
 }
 
 
@@ -250,8 +248,7 @@ TEST(AdamsMoultonSolver_test, orders_and_fRhs){
     solver->SetTimeInterval(t0, t1);
     int order_min = 1;
     int order_max = 4;
-    std::string prefix_filename_solver("test_AM_");
-    Test_orders(solver, order_min, order_max, prefix_filename_solver);
+    Test_orders(solver, order_min, order_max);
     delete solver;
 }
 
@@ -311,7 +308,8 @@ TEST(AdamsBashforthSolver_test, B_sum_order1) {
         for(int i=0; i<order; i++){
             sum += solver.GetB(order-1,i);
         }
-        EXPECT_DOUBLE_EQ(1., sum);
+        // the coefficients of the high orders are large and of alternating signs
+        EXPECT_NEAR(1., sum, 1e-14);
     }
 }
 
@@ -334,7 +332,7 @@ TEST(AdamsBashforthSolver_test, ProductWithB) {
             ones[i]=1;
         }
         double sum = solver.ProductWithB(ones, order);
-        EXPECT_DOUBLE_EQ(1., sum);
+        EXPECT_NEAR(1., sum, 1e-14);
     }
 }
 
@@ -347,8 +345,7 @@ TEST(AdamsBashforthSolver_test, orders_and_fRhs){
     solver->SetTimeInterval(t0, t1);
     int order_min = 2;
     int order_max = 5;
-    std::string prefix_filename_solver("test_AB_");
-    Test_orders(solver, order_min, order_max, prefix_filename_solver);
+    Test_orders(solver, order_min, order_max);
     delete solver;
 }
 
@@ -359,12 +356,7 @@ TEST(AdamsBashforthSolver_test, EulerForward_fRhs1) {
     double y0 = 0.;
     unsigned int s = 1;
     AdamsBashforthSolver solver(h, t0, t1, y0, fRhs1, s);
-    std::string filename_solver("test_AB_fRhs1_s1.dat");
-    try {
-        Test_final_results(&solver, filename_solver, sol1, 0.2);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    Test_final_results(&solver, sol1, 0.2);
 }
 
 TEST(AdamsBashforthSolver_test, EulerForward_fRhs2) {
@@ -374,12 +366,7 @@ TEST(AdamsBashforthSolver_test, EulerForward_fRhs2) {
     double y0 = 0.8;
     unsigned int s = 1;
     AdamsBashforthSolver solver(h, t0, t1, y0, fRhs2, s);
-    std::string filename_solver("test_AB_fRhs2_s1.dat");
-    try{
-        Test_final_results(&solver, filename_solver, sol2, 0.1);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    Test_final_results(&solver, sol2, 0.1);
 }
 
 TEST(AdamsBashforthSolver_test, EulerForward_fRhs3) {
@@ -389,12 +376,7 @@ TEST(AdamsBashforthSolver_test, EulerForward_fRhs3) {
     double y0 = 0.;
     unsigned int s = 1;
     AdamsBashforthSolver solver(h, t0, t1, y0, fRhs3, s);
-    std::string filename_solver("test_AB_fRhs3_s1.dat");
-    try{
-        Test_final_results(&solver, filename_solver, sol3, 0.1);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    Test_final_results(&solver, sol3, 0.1);
 }
 
 
@@ -450,7 +432,7 @@ TEST(RKSolver_test, second_Constructor) {
 TEST(RKSolver_test, B_sum_order) {
     // check that the coefficient of b sum to 1 for each order
     RKSolver solver;
-    for(int order=1; order<max_order; order++){
+    for(int order=1; order<=max_rk_order; order++){
         double sum(0);
         for(int i=0; i<order; i++){
             sum += solver.GetB(order-1,i);
@@ -462,7 +444,7 @@ TEST(RKSolver_test, B_sum_order) {
 TEST(RKSolver_test, sum_of_A_is_C) {
     RKSolver solver;
     // loop over the orders
-    for(int i=1; i<max_order; i++){
+    for(int i=1; i<=max_rk_order; i++){
         solver.SetOrder(i);
         // loop over the rows of the A matrix
         for(int j=0; j<i; j++){
@@ -479,10 +461,10 @@ TEST(RKSolver_test, sum_of_A_is_C) {
 
 TEST(RKSolver_test, ProductWithA) {
     RKSolver solver;
-    double ones[max_order];
-    std::fill(ones, ones+max_order, 1.);
+    double ones[max_rk_order];
+    std::fill(ones, ones+max_rk_order, 1.);
     // loop over the orders
-    for(int i=1; i<max_order; i++){
+    for(int i=1; i<=max_rk_order; i++){
         solver.SetOrder(i);
         // loop over the rows of the A matrix
         for(int j=0; j<i; j++){
@@ -500,12 +482,7 @@ TEST(RKSolver_test, EulerForward_fRhs1) {
     double y0 = 0.;
     unsigned int s = 1;
     RKSolver solver(h, t0, t1, y0, fRhs1, s);
-    std::string filename_solver("test_RK_fRhs1_s1.dat");
-    try {
-        Test_final_results(&solver, filename_solver, sol1, 0.1);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    Test_final_results(&solver, sol1, 0.1);
 }
 
 TEST(RKSolver_test, EulerForward_fRhs2) {
@@ -515,12 +492,7 @@ TEST(RKSolver_test, EulerForward_fRhs2) {
     double y0 = 0.8;
     unsigned int s = 1;
     RKSolver solver(h, t0, t1, y0, fRhs2, s);
-    std::string filename_solver("test_RK_s1.dat");
-    try{
-        Test_final_results(&solver, filename_solver, sol2, 0.1);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    Test_final_results(&solver, sol2, 0.1);
 }
 
 TEST(RKSolver_test, EulerForward_fRhs3) {
@@ -530,12 +502,7 @@ TEST(RKSolver_test, EulerForward_fRhs3) {
     double y0 = 0.;
     unsigned int s = 1;
     RKSolver solver(h, t0, t1, y0, fRhs3, s);
-    std::string filename_solver("test_RK_fRhs3_s1.dat");
-    try {
-        Test_final_results(&solver, filename_solver, sol3, 0.1);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    Test_final_results(&solver, sol3, 0.1);
 }
 
 //compare the Euler Forward methods given by RK solver and AdamsBashforth.
@@ -551,21 +518,10 @@ TEST(RKSolver_test, EulerForward_compared_to_Adamsbashforth_fRhs1) {
     std::string filename_AB("test_AB_fRhs1_s1.dat");
     std::fstream File_AB;
     File_AB.open(filename_AB, std::ios::out);
-    try {
-            if (File_AB.is_open()) {
-                solver_AB.SolveEquation(File_AB);
-                File_AB.close();
-            } else {
-            throw FileNotOpenException("File cannot be opened.");
-        }
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
-    try {
-        Test_results(&solver_RK, filename_RK, filename_AB);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    ASSERT_TRUE(File_AB.is_open());
+    solver_AB.SolveEquation(File_AB);
+    File_AB.close();
+    Test_results(&solver_RK, filename_RK, filename_AB);
 }
 
 TEST(RKSolver_test, EulerForward_compared_to_Adamsbashforth_fRhs2) {
@@ -580,21 +536,10 @@ TEST(RKSolver_test, EulerForward_compared_to_Adamsbashforth_fRhs2) {
     std::string filename_AB("test_AB_fRhs2_s1.dat");
     std::fstream File_AB;
     File_AB.open(filename_AB, std::ios::out);
-    try {
-        if (File_AB.is_open()) {
-            solver_AB.SolveEquation(File_AB);
-            File_AB.close();
-        } else {
-            throw FileNotOpenException("File cannot be opened.");
-        }
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
-    try {
-        Test_results(&solver_RK, filename_RK, filename_AB);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
-    }
+    ASSERT_TRUE(File_AB.is_open());
+    solver_AB.SolveEquation(File_AB);
+    File_AB.close();
+    Test_results(&solver_RK, filename_RK, filename_AB);
 }
 
 TEST(RKSolver_test, EulerForward_compared_to_Adamsbashforth_fRhs3) {
@@ -609,33 +554,1813 @@ TEST(RKSolver_test, EulerForward_compared_to_Adamsbashforth_fRhs3) {
     std::string filename_AB("test_AB_fRhs3_s1.dat");
     std::fstream File_AB;
     File_AB.open(filename_AB, std::ios::out);
-    try {
-        if (File_AB.is_open()) {
-            solver_AB.SolveEquation(File_AB);
-            File_AB.close();
-        } else {
-            throw FileNotOpenException("File cannot be opened.");
+    ASSERT_TRUE(File_AB.is_open());
+    solver_AB.SolveEquation(File_AB);
+    File_AB.close();
+    Test_results(&solver_RK, filename_RK, filename_AB);
+}
+
+TEST(RKSolver_test, orders_and_fRhs){
+    double h = 0.001;
+    double t0 = 0.0;
+    double t1 = 100.0;
+    AbstractExplicitSolver* solver = new RKSolver;
+    solver->SetStepSize(h);
+    solver->SetTimeInterval(t0, t1);
+    int order_min = 2;
+    int order_max = 4;
+    Test_orders(solver, order_min, order_max);
+    delete solver;
+}
+
+
+// LOW-STORAGE RUNGE-KUTTA SOLVER:
+TEST(LowStorageRKSolver_test, GetOrder) {
+    LowStorageRKSolver solver;
+    const unsigned int stages[4] = {1, 2, 3, 5};
+    for (unsigned int s = 1; s <= max_rk_order; s++) {
+        solver.SetOrder(s);
+        EXPECT_EQ(s, solver.GetOrder());
+        EXPECT_EQ(stages[s-1], solver.GetStages());
+    }
+    DiagnosticLog log;
+    solver.SetDiagnosticSink(&log);
+    solver.SetOrder(5);
+    EXPECT_EQ(max_rk_order, solver.GetOrder());
+    EXPECT_EQ(1u, log.Size());
+}
+
+TEST(LowStorageRKSolver_test, EulerForward_compared_to_RK) {
+    // with one stage, the 2N form is the Forward Euler method
+    LowStorageRKSolver solver_LSRK(0.01, 0., 10., 0.5, fRhs3, 1);
+    RKSolver solver_RK(0.01, 0., 10., 0.5, fRhs3, 1);
+    Trajectory trajectory_LSRK = solver_LSRK.SolveEquation();
+    Trajectory trajectory_RK = solver_RK.SolveEquation();
+    ASSERT_EQ(trajectory_RK.Size(), trajectory_LSRK.Size());
+    for (size_t i = 0; i < trajectory_RK.Size(); i++) {
+        EXPECT_DOUBLE_EQ(trajectory_RK.GetValue(i), trajectory_LSRK.GetValue(i));
+    }
+}
+
+TEST(LowStorageRKSolver_test, orders_and_fRhs){
+    double h = 0.001;
+    double t0 = 0.0;
+    double t1 = 100.0;
+    AbstractExplicitSolver* solver = new LowStorageRKSolver;
+    solver->SetStepSize(h);
+    solver->SetTimeInterval(t0, t1);
+    int order_min = 2;
+    int order_max = 4;
+    Test_orders(solver, order_min, order_max);
+    delete solver;
+}
+
+// EXPONENTIAL TIME-DIFFERENCING SOLVER:
+double fRhsZero(double y, double t) { return 0; }
+
+TEST(ETDSolver_test, GetOrder) {
+    ETDSolver solver;
+    unsigned int s=4;
+    solver.SetOrder(s);
+    EXPECT_EQ(s, solver.GetOrder());
+}
+
+TEST(ETDSolver_test, B_sum_order) {
+    // check that the coefficient of b sum to 1 for each order
+    ETDSolver solver;
+    for(int order=1; order<=4; order++){
+        double sum(0);
+        for(int i=0; i<order; i++){
+            sum += solver.GetB(order-1,i);
         }
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
+        EXPECT_DOUBLE_EQ(1., sum);
     }
-    try {
-        Test_results(&solver_RK, filename_RK, filename_AB);
-    } catch (FileNotOpenException &error) {
-        error.PrintDebug();
+}
+
+TEST(ETDSolver_test, Phi) {
+    // check the series and the closed forms of phi_k on both sides of the switching point |z| = 1
+    for(double z : {-1e-8, 0.3, -0.999, 1.001, -2.5, 7.}){
+        EXPECT_NEAR(ETDSolver::Phi(0, z), exp(z), 1e-12*exp(z));
+        if(std::abs(z) > 1e-4){
+            EXPECT_NEAR(ETDSolver::Phi(1, z), (exp(z) - 1)/z, 1e-12);
+            EXPECT_NEAR(ETDSolver::Phi(2, z), (exp(z) - 1 - z)/(z*z), 1e-12);
+        }
     }
+    EXPECT_DOUBLE_EQ(1./6, ETDSolver::Phi(3, 0.));
+    EXPECT_DOUBLE_EQ(0.01, ETDSolver::Phi(1, -100.));
 }
 
-TEST(RKSolver_test, orders_and_fRhs){
+TEST(ETDSolver_test, linear_part_exact) {
+    // the linear part is integrated exactly: y' = -100*y is solved with a step size of 0.1
+    double h = 0.1;
+    double t0 = 0.0;
+    double t1 = 1.0;
+    double y0 = 0.8;
+    for(unsigned int s=1; s<=4; s++){
+        ETDSolver solver(h, t0, t1, y0, -100., fRhsZero, s);
+        Test_final_results(&solver, sol2, 1e-10);
+    }
+}
+
+TEST(ETDSolver_test, Euler_compared_to_RK_fRhs3) {
+    // for L = 0, ETD1 is the Forward Euler method
     double h = 0.001;
     double t0 = 0.0;
     double t1 = 100.0;
-    AbstractExplicitSolver* solver = new RKSolver;
+    double y0 = 0.;
+    unsigned int s = 1;
+    ETDSolver solver_ETD(h, t0, t1, y0, 0., fRhs3, s);
+    RKSolver solver_RK(h, t0, t1, y0, fRhs3, s);
+    std::string filename_ETD("test_ETD_fRhs3_s1.dat");
+    std::string filename_RK("test_RK_fRhs3_s1_ETD.dat");
+    std::fstream File_RK;
+    File_RK.open(filename_RK, std::ios::out);
+    ASSERT_TRUE(File_RK.is_open());
+    solver_RK.SolveEquation(File_RK);
+    File_RK.close();
+    Test_results(&solver_ETD, filename_ETD, filename_RK);
+}
+
+TEST(ETDSolver_test, orders_and_fRhs){
+    double h = 0.001;
+    double t0 = 0.0;
+    double t1 = 100.0;
+    AbstractExplicitSolver* solver = new ETDSolver;
+    solver->SetStepSize(h);
+    solver->SetTimeInterval(t0, t1);
+    int order_min = 2;
+    int order_max = 4;
+    Test_orders(solver, order_min, order_max);
+    delete solver;
+}
+
+
+// EXTRAPOLATION SOLVER:
+TEST(ExtrapolationSolver_test, GetOrder) {
+    ExtrapolationSolver solver;
+    unsigned int s=3;
+    solver.SetOrder(s);
+    EXPECT_EQ(s, solver.GetOrder());
+    // above 9 stages, the round-off errors dominate: the number of stages is reduced
+    DiagnosticLog log;
+    solver.SetDiagnosticSink(&log);
+    solver.SetOrder(12);
+    EXPECT_EQ(max_extrapolation_stages, solver.GetOrder());
+    EXPECT_EQ(1u, log.Size());
+}
+
+TEST(ExtrapolationSolver_test, B_sum_order) {
+    // check that the extrapolation weights sum to 1 for each number of stages
+    ExtrapolationSolver solver;
+    for(int order=1; order<=max_order; order++){
+        double sum(0);
+        for(int i=0; i<order; i++){
+            sum += solver.GetB(order-1,i);
+        }
+        EXPECT_NEAR(1., sum, 1e-12);
+    }
+}
+
+TEST(ExtrapolationSolver_test, Midpoint_compared_to_RK_fRhs3) {
+    // with one stage, the macro step is made of 2 sub-steps of the leapfrog scheme, which is the explicit midpoint
+    // method of the Runge Kutta solver.
+    double h = 0.001;
+    double t0 = 0.0;
+    double t1 = 100.0;
+    double y0 = 0.;
+    ExtrapolationSolver solver_GBS(h, t0, t1, y0, fRhs3, 1);
+    RKSolver solver_RK(h, t0, t1, y0, fRhs3, 2);
+    std::string filename_GBS("test_GBS_fRhs3_s1.dat");
+    std::string filename_RK("test_RK_fRhs3_s2_GBS.dat");
+    std::fstream File_RK;
+    File_RK.open(filename_RK, std::ios::out);
+    ASSERT_TRUE(File_RK.is_open());
+    solver_RK.SolveEquation(File_RK);
+    File_RK.close();
+    Test_results(&solver_GBS, filename_GBS, filename_RK);
+}
+
+TEST(ExtrapolationSolver_test, orders_and_fRhs){
+    double h = 0.01;
+    double t0 = 0.0;
+    double t1 = 100.0;
+    AbstractExplicitSolver* solver = new ExtrapolationSolver;
     solver->SetStepSize(h);
     solver->SetTimeInterval(t0, t1);
     int order_min = 2;
     int order_max = 4;
-    std::string prefix_filename_solver("test_RK_");
-    Test_orders(solver, order_min, order_max, prefix_filename_solver);
+    Test_orders(solver, order_min, order_max);
     delete solver;
 }
+
+TEST(ExtrapolationSolver_test, adaptive_fRhs2) {
+    // large initial step size on the stiff-ish right hand side: the step size control must keep the error small
+    double h = 0.1;
+    double t0 = 0.0;
+    double t1 = 1.0;
+    double y0 = 0.8;
+    unsigned int s = 5;
+    ExtrapolationSolver solver(h, t0, t1, y0, fRhs2, s);
+    solver.SetTolerance(1e-10);
+    Test_final_results(&solver, sol2, 1e-8);
+}
+
+TEST(ExtrapolationSolver_test, adaptive_fRhs3) {
+    double h = 0.01;
+    double t0 = 0.0;
+    double t1 = 100.0;
+    double y0 = 0.;
+    unsigned int s = 5;
+    ExtrapolationSolver solver(h, t0, t1, y0, fRhs3, s);
+    solver.SetTolerance(1e-10);
+    Test_final_results(&solver, sol3, 1e-6);
+}
+
+TEST(ExtrapolationSolver_test, threads_give_same_result) {
+    // the sub-sequences are independent: the result does not depend on the number of threads
+    double h = 0.01;
+    double t0 = 0.0;
+    double t1 = 10.0;
+    double y0 = 0.;
+    unsigned int s = 5;
+    ExtrapolationSolver solver(h, t0, t1, y0, fRhs3, s);
+    solver.SetTolerance(1e-8);
+    std::stringstream stream_serial;
+    solver.SolveEquation(stream_serial);
+    solver.SetNumberOfThreads(3);
+    std::stringstream stream_parallel;
+    solver.SolveEquation(stream_parallel);
+    EXPECT_EQ(stream_serial.str(), stream_parallel.str());
+}
+
+TEST(ExtrapolationSolver_test, copy_uses_its_own_controller) {
+    // the default controller is resolved at use time: a copy still works once the original solver is destroyed
+    auto *original = new ExtrapolationSolver(0.01, 0., 10., 0., fRhs3, 5);
+    original->SetTolerance(1e-8);
+    ExtrapolationSolver copy(*original);
+    EXPECT_NE(original->GetStepSizeController(), copy.GetStepSizeController());
+    std::stringstream stream_original;
+    original->SolveEquation(stream_original);
+    delete original;
+    std::stringstream stream_copy;
+    copy.SolveEquation(stream_copy);
+    EXPECT_EQ(stream_original.str(), stream_copy.str());
+}
+
+
+// JOB MANIFEST:
+TEST(JobManifest_test, Read) {
+    std::stringstream stream("# two jobs\n"
+                             "[job]\n"
+                             "solver = RK\n h = 0.001\nt0 = 0\nt1 = 100\ny0 = 1\norder = 3\nchoice = 2\n"
+                             "output = rk.dat\n"
+                             "\n"
+                             "[job]\n"
+                             "solver=GBS\nh=0.01\nt0=0\nt1=1\ny0=0.8\norder=5\nchoice=2\noutput=gbs.dat\n"
+                             "tolerance = 1e-8\nthreads = 2\n");
+    JobManifest manifest;
+    manifest.Read(stream);
+    ASSERT_EQ(2u, manifest.GetJobs().size());
+    const Job &job = manifest.GetJobs()[0];
+    EXPECT_EQ("RK", job.type_solver);
+    EXPECT_DOUBLE_EQ(0.001, job.h);
+    EXPECT_DOUBLE_EQ(100., job.t1);
+    EXPECT_EQ(3u, job.order);
+    EXPECT_EQ(2, job.choice);
+    EXPECT_EQ("rk.dat", job.output);
+    EXPECT_EQ("text", job.format);
+    EXPECT_DOUBLE_EQ(1e-8, manifest.GetJobs()[1].tolerance);
+    EXPECT_EQ(2u, manifest.GetJobs()[1].threads);
+
+    std::stringstream problem_stream("[job]\nsolver = AM\nh = 0.01\nt0 = 0\nt1 = 1\ny0 = 0\norder = 2\n"
+                                     "problem = prothero_robinson\noutput = am.dat\n");
+    JobManifest problem_manifest;
+    problem_manifest.Read(problem_stream);
+    ASSERT_EQ(1u, problem_manifest.GetJobs().size());
+    EXPECT_EQ(5, problem_manifest.GetJobs()[0].choice);
+    EXPECT_EQ("prothero_robinson", problem_manifest.GetJobs()[0].problem);
+}
+
+TEST(JobManifest_test, invalid_manifests) {
+    // each manifest is rejected without prompting
+    const std::string job = "[job]\nsolver = RK\nh = 0.001\nt0 = 0\nt1 = 1\ny0 = 1\nchoice = 2\noutput = a.dat\n";
+    const std::vector<std::string> manifests = {
+            job,                                    // missing order
+            job + "order = 5\n",                    // order too big for RK
+            job + "order = 2x\n",                   // not a number
+            job + "order = 2\norder = 3\n",         // duplicated key
+            job + "order = 2\ncolour = red\n",      // unknown key
+            job + "order = 2\nthreads = -1\n",      // negative number of threads
+            "h = 0.1\n" + job + "order = 2\n",      // key outside of a job
+            job + "order = 2\n" + job + "order = 2\n", // same output file twice
+            job + "order = 2\nproblem = logistic\n",   // choice and problem
+            "[job]\nsolver = RK\nh = 0.001\nt0 = 0\nt1 = 1\ny0 = 1\norder = 2\nproblem = lorenz\noutput = a.dat\n",
+    };
+    for (const std::string &content : manifests) {
+        std::stringstream stream(content);
+        JobManifest manifest;
+        EXPECT_THROW(manifest.Read(stream), ManifestException);
+    }
+    // the message lists the accepted forms of the right hand side
+    std::stringstream stream("[job]\nsolver = RK\nh = 0.001\nt0 = 0\nt1 = 1\ny0 = 1\norder = 2\nchoice = 7\n"
+                             "output = a.dat\n");
+    try {
+        JobManifest().Read(stream);
+        ADD_FAILURE() << "choice = 7 was accepted";
+    } catch (ManifestException &error) {
+        EXPECT_NE(std::string::npos, error.GetProblem().find("rhs or a problem key")) << error.GetProblem();
+    }
+}
+
+
+// EXPRESSION:
+TEST(Expression_test, Evaluate) {
+    const double y = 0.7;
+    const double t = 1.3;
+    EXPECT_DOUBLE_EQ(1 + t, Expression("1+t").Evaluate(y, t));
+    EXPECT_DOUBLE_EQ(-100*y, Expression("-100*y").Evaluate(y, t));
+    EXPECT_DOUBLE_EQ(sin(t)*cos(t), Expression("sin(t)*cos(t)").Evaluate(y, t));
+    EXPECT_DOUBLE_EQ(pow(2, pow(3, 2)), Expression("2^3^2").Evaluate(y, t));
+    EXPECT_DOUBLE_EQ(-pow(y, 2), Expression("-y^2").Evaluate(y, t));
+    EXPECT_DOUBLE_EQ(1 - t/(y - 3) + exp(-y*t), Expression(" 1 - t / (y - 3) + exp(-y * t)").Evaluate(y, t));
+    EXPECT_DOUBLE_EQ(sqrt(abs(y - t)) + tanh(y) + atan(t), Expression("sqrt(abs(y-t))+tanh(y)+atan(t)").Evaluate(y, t));
+}
+
+TEST(Expression_test, constant_folding) {
+    // 2*3 + 1 is folded to 7 and stored in the instruction: one load of y and one addition
+    Expression expression("2*3 + y + 1*0");
+    EXPECT_EQ(2u, expression.GetNumberOfInstructions());
+    EXPECT_DOUBLE_EQ(6.5, expression.Evaluate(0.5, 0.));
+    EXPECT_TRUE(Expression("cos(0) + 2^2").IsConstant());
+    // identical sub-expressions are computed once
+    Expression shared("sin(t)*y + sin(t)");
+    EXPECT_EQ(5u, shared.GetNumberOfInstructions());
+}
+
+TEST(Expression_test, Derivative) {
+    const double y = 0.7;
+    const double t = 1.3;
+    Expression expression("-100*y + y^3*sin(t) + exp(2*y)/t");
+    EXPECT_DOUBLE_EQ(-100 + 3*pow(y, 2)*sin(t) + 2*exp(2*y)/t, expression.Derivative("y").Evaluate(y, t));
+    EXPECT_NEAR(pow(y, 3)*cos(t) - exp(2*y)/(t*t), expression.Derivative("t").Evaluate(y, t), 1e-12);
+    // the derivative of a linear function is constant
+    Expression linear("-100*y + sin(t)");
+    EXPECT_TRUE(linear.Derivative().IsConstant());
+    EXPECT_DOUBLE_EQ(-100., linear.Derivative().Evaluate(0., 0.));
+    // the derivative of abs is the sign, finite at 0
+    Expression absolute("-abs(y) - 2*abs(t)");
+    EXPECT_EQ(-1., absolute.Derivative("y").Evaluate(0.5, 0.));
+    EXPECT_EQ(1., absolute.Derivative("y").Evaluate(-0.5, 0.));
+    EXPECT_EQ(0., absolute.Derivative("y").Evaluate(0., 0.));
+    EXPECT_EQ(0., absolute.Derivative("t").Evaluate(1., 0.));
+}
+
+TEST(Expression_test, Parameters) {
+    Expression expression("-k*y + c", {{"k", 2.}, {"c", 1.}});
+    EXPECT_DOUBLE_EQ(-2*0.5 + 1, expression.Evaluate(0.5, 0.));
+    expression.SetParameter("k", 3.);
+    EXPECT_DOUBLE_EQ(-3*0.5 + 1, expression.Evaluate(0.5, 0.));
+    EXPECT_DOUBLE_EQ(-0.5, expression.Derivative("k").Evaluate(0.5, 0.));
+    EXPECT_THROW(expression.SetParameter("m", 1.), ExpressionException);
+}
+
+TEST(Expression_test, invalid_expressions) {
+    for (std::string text : {"", "1+", "sin(y", "foo(y)", "2*z", "y)", "3 y"}) {
+        EXPECT_THROW(Expression expression(text), ExpressionException);
+    }
+}
+
+Expression EXPRESSION_TEST("-100*y");
+Expression dEXPRESSION_TEST = EXPRESSION_TEST.Derivative();
+double fExpression(double y, double t) { return EXPRESSION_TEST.Evaluate(y, t); }
+double dfExpression(double y, double t) { return dEXPRESSION_TEST.Evaluate(y, t); }
+
+TEST(Expression_test, AdamsMoulton_compared_to_fRhs2) {
+    // the expression gives the same results as the compiled right hand side
+    double h = 0.001;
+    double t0 = 0.0;
+    double t1 = 10.0;
+    double y0 = 0.8;
+    unsigned int s = 2;
+    AdamsMoultonSolver solver_expression(h, t0, t1, y0, fExpression, dfExpression, s);
+    AdamsMoultonSolver solver_compiled(h, t0, t1, y0, fRhs2, dfRhs2, s);
+    std::stringstream stream_expression;
+    std::stringstream stream_compiled;
+    solver_expression.SolveEquation(stream_expression);
+    solver_compiled.SolveEquation(stream_compiled);
+    EXPECT_EQ(stream_compiled.str(), stream_expression.str());
+}
+
+
+// OUTPUT:
+TEST(SpscRingBuffer_test, PushPop) {
+    SpscRingBuffer<int> ring(5);
+    EXPECT_EQ(8u, ring.GetCapacity());
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ring.TryPush(i));
+    }
+    EXPECT_FALSE(ring.TryPush(8));
+    int value;
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ring.TryPop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+TEST(SpscRingBuffer_test, two_threads) {
+    // every element crosses from the producer to the consumer, in order
+    const long n = 100000;
+    SpscRingBuffer<long> ring(64);
+    std::thread producer([&ring, n] {
+        for (long i = 0; i < n; i++) {
+            while (!ring.TryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    long expected = 0;
+    long value;
+    while (expected < n) {
+        if (ring.TryPop(value)) {
+            ASSERT_EQ(expected, value);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+// sink storing the records, optionally slow
+class RecordingSink : public AbstractOutputSink {
+public:
+    explicit RecordingSink(int delay = 0) : delay(delay) {}
+    void Write(double t, double y) override {
+        if (delay > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delay));
+        }
+        records.emplace_back(t, y);
+    }
+    std::vector<std::pair<double, double>> records;
+private:
+    int delay;
+};
+
+TEST(AsyncOutputSink_test, same_output_as_stream) {
+    // with Block and Grow, the asynchronous file is identical to the synchronous one, also with a tiny buffer
+    RKSolver solver(0.001, 0., 10., 1., fRhs3, 4);
+    std::stringstream direct;
+    solver.SolveEquation(direct);
+    for (Backpressure policy : {Backpressure::Block, Backpressure::Grow}) {
+        for (size_t capacity : {2, 1 << 14}) {
+            std::stringstream stream;
+            StreamOutputSink stream_sink(stream);
+            RecordingSink tap;
+            AsyncOutputSink sink(stream_sink, capacity, policy, &tap);
+            solver.SolveEquation(sink);
+            sink.Flush();
+            EXPECT_EQ(direct.str(), stream.str());
+            EXPECT_EQ(10001u, tap.records.size());
+            EXPECT_EQ(0u, sink.GetNumberOfDroppedRecords());
+        }
+    }
+}
+
+TEST(AsyncOutputSink_test, Decimate) {
+    // a slow writer gets fewer records, but always the first and the last ones
+    RKSolver solver(0.001, 0., 10., 1., fRhs3, 4);
+    RecordingSink slow(20);
+    {
+        AsyncOutputSink sink(slow, 8, Backpressure::Decimate);
+        solver.SolveEquation(sink);
+        sink.Close();
+        EXPECT_GT(sink.GetNumberOfDroppedRecords(), 0u);
+        EXPECT_EQ(10001u, slow.records.size() + sink.GetNumberOfDroppedRecords());
+    }
+    EXPECT_DOUBLE_EQ(0., slow.records.front().first);
+    EXPECT_NEAR(10., slow.records.back().first, 1e-9);
+    EXPECT_NEAR(sol3(10.) + 1., slow.records.back().second, TOL);
+    for (size_t i = 1; i < slow.records.size(); i++) {
+        EXPECT_LT(slow.records[i-1].first, slow.records[i].first);
+    }
+}
+
+std::vector<double> Read_binary(const std::string &filename, uint64_t &number_of_records) {
+    // read a file written by MappedOutputSink, return t0, y0, t1, y1, ...
+    std::ifstream file(filename, std::ios::binary);
+    char magic[8];
+    file.read(magic, 8);
+    EXPECT_EQ(0, std::memcmp(magic, MappedOutputSink::magic, 8));
+    file.read(reinterpret_cast<char *>(&number_of_records), sizeof(number_of_records));
+    std::vector<double> records(2*number_of_records);
+    file.read(reinterpret_cast<char *>(records.data()), records.size()*sizeof(double));
+    EXPECT_TRUE(file.good());
+    EXPECT_EQ(EOF, file.peek());
+    return records;
+}
+
+TEST(MappedOutputSink_test, same_records_as_stream) {
+    // the binary file holds the same records as the text file, at full precision
+    AdamsBashforthSolver solver(0.001, 0., 2., 1., fRhs3, 3);
+    RecordingSink expected;
+    solver.SolveEquation(expected);
+    {
+        MappedOutputSink sink("test_mapped.bin");
+        solver.SolveEquation(sink);
+        EXPECT_EQ(solver.GetNumberOfSteps() + 1, sink.GetNumberOfRecords());
+    }
+    uint64_t number_of_records;
+    std::vector<double> records = Read_binary("test_mapped.bin", number_of_records);
+    ASSERT_EQ(expected.records.size(), number_of_records);
+    for (size_t i = 0; i < expected.records.size(); i++) {
+        EXPECT_EQ(expected.records[i].first, records[2*i]);
+        EXPECT_EQ(expected.records[i].second, records[2*i+1]);
+    }
+}
+
+TEST(MappedOutputSink_test, adaptive_solver) {
+    // without a known number of steps, the mapping grows and is truncated to the records written
+    ExtrapolationSolver solver(0.1, 0., 10., 1., fRhs3, 4);
+    solver.SetTolerance(1e-8);
+    RecordingSink expected;
+    solver.SolveEquation(expected);
+    MappedOutputSink sink("test_mapped_adaptive.bin");
+    solver.SolveEquation(sink);
+    for (int i = 0; i < 5000; i++) {
+        sink.Write(10. + i, 0.);
+    }
+    sink.Close();
+    uint64_t number_of_records;
+    std::vector<double> records = Read_binary("test_mapped_adaptive.bin", number_of_records);
+    ASSERT_EQ(expected.records.size() + 5000, number_of_records);
+    EXPECT_EQ(expected.records.back().second, records[2*expected.records.size() - 1]);
+    EXPECT_EQ(10. + 4999, records[2*number_of_records - 2]);
+}
+
+TEST(Trajectory_test, same_records_as_stream) {
+    // the trajectory holds the records of the text output, at full precision
+    RKSolver solver(0.01, 0., 10., 0.8, fRhs2, 4);
+    Trajectory trajectory = solver.SolveEquation();
+    ASSERT_EQ(solver.GetNumberOfSteps() + 1, trajectory.Size());
+    std::stringstream stream;
+    solver.SolveEquation(stream);
+    for (size_t i = 0; i < trajectory.Size(); i++) {
+        double t, y;
+        stream >> t >> y;
+        EXPECT_NEAR(t, trajectory.GetTime(i), 1e-5*std::max(1., std::abs(t)));
+        EXPECT_NEAR(y, trajectory.GetValue(i), 1e-5*std::abs(y));
+    }
+}
+
+TEST(Trajectory_test, reserve_and_move) {
+    // the storage is reserved once and moved without copy
+    AdamsBashforthSolver solver(0.001, 0., 1., 0., fRhs1, 2);
+    Trajectory trajectory;
+    solver.SolveEquation(trajectory);
+    const double *times = trajectory.GetTimeData();
+    const double *values = trajectory.GetValueData();
+    EXPECT_EQ(trajectory.Size(), trajectory.GetTimes().capacity());
+    Trajectory moved(std::move(trajectory));
+    EXPECT_EQ(times, moved.GetTimeData());
+    EXPECT_EQ(values, moved.GetValueData());
+    // only the first step, computed with Euler forward, is not exact
+    EXPECT_NEAR(sol1(1.), moved.GetValues().back(), 0.001*0.001);
+}
+
+TEST(CompressedOutputSink_test, lossless) {
+    // the records are read back exactly, the times of a fixed step size solver are not stored
+    RKSolver solver(1e-4, 0., 10., 0., fRhs3, 4);
+    Trajectory expected = solver.SolveEquation();
+    {
+        CompressedOutputSink sink("test_compressed.bin");
+        solver.SolveEquation(sink);
+    }
+    Trajectory trajectory = CompressedOutputSink::Read("test_compressed.bin");
+    ASSERT_EQ(expected.Size(), trajectory.Size());
+    EXPECT_TRUE(expected.GetTimes() == trajectory.GetTimes());
+    EXPECT_TRUE(expected.GetValues() == trajectory.GetValues());
+    std::ifstream file("test_compressed.bin", std::ios::binary | std::ios::ate);
+    EXPECT_LT(file.tellg(), 8*expected.Size());
+}
+
+TEST(CompressedOutputSink_test, quantum) {
+    // the error is bounded by half the quantum, and the file is much smaller than the text output
+    const double quantum = 1e-9;
+    RKSolver solver(1e-4, 0., 10., 0., fRhs3, 4);
+    Trajectory expected = solver.SolveEquation();
+    {
+        CompressedOutputSink sink("test_compressed_quantum.bin", quantum);
+        solver.SolveEquation(sink);
+    }
+    Trajectory trajectory = CompressedOutputSink::Read("test_compressed_quantum.bin");
+    ASSERT_EQ(expected.Size(), trajectory.Size());
+    for (size_t i = 0; i < trajectory.Size(); i++) {
+        EXPECT_EQ(expected.GetTime(i), trajectory.GetTime(i));
+        EXPECT_NEAR(expected.GetValue(i), trajectory.GetValue(i), 0.5*quantum*(1 + 1e-6));
+    }
+    std::stringstream text;
+    solver.SolveEquation(text);
+    std::ifstream file("test_compressed_quantum.bin", std::ios::binary | std::ios::ate);
+    EXPECT_LT(10*static_cast<size_t>(file.tellg()), text.str().size());
+}
+
+TEST(CompressedOutputSink_test, adaptive_solver) {
+    // the times of an adaptive solver are compressed without loss, like the values
+    ExtrapolationSolver solver(0.1, 0., 10., 1., fRhs3, 4);
+    solver.SetTolerance(1e-10);
+    Trajectory expected = solver.SolveEquation();
+    {
+        CompressedOutputSink sink("test_compressed_adaptive.bin", 0., 7);
+        solver.SolveEquation(sink);
+    }
+    Trajectory trajectory = CompressedOutputSink::Read("test_compressed_adaptive.bin");
+    EXPECT_TRUE(expected.GetTimes() == trajectory.GetTimes());
+    EXPECT_TRUE(expected.GetValues() == trajectory.GetValues());
+}
+
+
+// WORK-PRECISION:
+double fRhs4(double y, double t) { return y*cos(t); }
+double dfRhs4(double y, double t) { return cos(t); }
+double sol4(double t) { return exp(sin(t)); }
+
+void Test_observed_order(AbstractOdeSolver *solver, double order, const double tol = 0.3) {
+    // the error decreases like h^order
+    solver->SetTimeInterval(0., 10.);
+    solver->SetInitialValue(sol4(0.));
+    WorkPrecision work_precision(sol4);
+    std::vector<WorkPrecisionPoint> points = work_precision.SweepStepSize(*solver, {1./8, 1./16, 1./32, 1./64, 1./128});
+    EXPECT_NEAR(order, WorkPrecision::ObservedOrder(points), tol) << "order " << solver->GetOrder();
+}
+
+TEST(WorkPrecision_test, observed_orders) {
+    for (unsigned int s = 1; s <= 4; s++) {
+        RKSolver solver_RK(0.1, 0., 10., 1., fRhs4, s);
+        Test_observed_order(&solver_RK, s);
+        ETDSolver solver_ETD(0.1, 0., 10., 1., 0., fRhs4, s);
+        Test_observed_order(&solver_ETD, s);
+        LowStorageRKSolver solver_LSRK(0.1, 0., 10., 1., fRhs4, s);
+        Test_observed_order(&solver_LSRK, s);
+    }
+    // the higher orders are checked by AdamsCoefficients_test
+    for (unsigned int s = 1; s <= 5; s++) {
+        AdamsBashforthSolver solver_AB(0.1, 0., 10., 1., fRhs4, s);
+        Test_observed_order(&solver_AB, s);
+        // Adams-Moulton of order s converges with order s+1
+        AdamsMoultonSolver solver_AM(0.1, 0., 10., 1., fRhs4, dfRhs4, s-1);
+        Test_observed_order(&solver_AM, s);
+    }
+    // the extrapolation solver with k stages has order 2k, higher orders reach round-off too quickly
+    for (unsigned int s = 1; s <= 2; s++) {
+        ExtrapolationSolver solver_GBS(0.1, 0., 10., 1., fRhs4, s);
+        Test_observed_order(&solver_GBS, 2*s);
+    }
+}
+
+TEST(WorkPrecision_test, evaluations) {
+    // the cost is the number of evaluations counted by the solver, also by the worker threads of the extrapolation
+    WorkPrecision work_precision(sol4);
+    RKSolver solver_RK(0.1, 0., 10., 1., fRhs4, 4);
+    EXPECT_EQ(4*100u, work_precision.Measure(solver_RK).evaluations);
+    ExtrapolationSolver solver_GBS(0.1, 0., 10., 1., fRhs4, 3);
+    solver_GBS.SetNumberOfThreads(3);
+    const WorkPrecisionPoint point = work_precision.Measure(solver_GBS);
+    EXPECT_EQ(solver_GBS.GetResult().rhsEvaluations, point.evaluations);
+    EXPECT_GT(point.evaluations, 3*100u);
+}
+
+TEST(WorkPrecision_test, ObservedOrder) {
+    // exact slope, points dominated by round-off or unstable are left out
+    std::vector<WorkPrecisionPoint> points(5);
+    for (int i = 0; i < 5; i++) {
+        points[i].h = std::ldexp(1., -i);
+        points[i].error = 1e-3*std::pow(points[i].h, 3);
+    }
+    points[0].error = INFINITY;
+    points[4].error = 1e-14;
+    EXPECT_NEAR(3., WorkPrecision::ObservedOrder(points), 1e-12);
+    EXPECT_TRUE(std::isnan(WorkPrecision::ObservedOrder({points[0], points[1]})));
+}
+
+TEST(Reentrancy_test, solvers_on_threads) {
+    // each solver has its own expression as context, the results do not depend on the other threads
+    const std::vector<std::string> texts = {"-k*y", "-k*y + sin(t)", "k*cos(t)", "y*cos(t)"};
+    std::vector<Expression> expressions;
+    std::vector<Expression> derivatives;
+    for (unsigned int i = 0; i < texts.size(); i++) {
+        expressions.emplace_back(texts[i], std::map<std::string, double>{{"k", 1. + i}});
+        derivatives.push_back(expressions.back().Derivative("y"));
+    }
+    auto solve = [&](unsigned int i, DiagnosticLog &log) {
+        AdamsMoultonSolver solver;
+        solver.SetDiagnosticSink(&log);
+        solver.SetStepSize(1e-3);
+        solver.SetTimeInterval(0., 2.);
+        solver.SetInitialValue(1.);
+        solver.SetOrder(2);
+        solver.SetRightHandSide(Expression::RightHandSide, &expressions[i]);
+        solver.SetdRightHandSide(Expression::RightHandSide, &derivatives[i]);
+        return solver.SolveEquation();
+    };
+    std::vector<DiagnosticLog> logs(texts.size());
+    std::vector<Trajectory> sequential;
+    for (unsigned int i = 0; i < texts.size(); i++) {
+        sequential.push_back(solve(i, logs[i]));
+    }
+    std::vector<Trajectory> concurrent(texts.size());
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < texts.size(); i++) {
+        threads.emplace_back([&, i]() { concurrent[i] = solve(i, logs[i]); });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (unsigned int i = 0; i < texts.size(); i++) {
+        EXPECT_EQ(sequential[i].GetValues(), concurrent[i].GetValues()) << texts[i];
+        EXPECT_EQ(0u, logs[i].Size());
+    }
+    EXPECT_NEAR(exp(sin(2.)), concurrent[3].GetValues().back(), 1e-6);
+}
+
+TEST(Reentrancy_test, diagnostics_not_printed) {
+    // the problems are kept in the log, nothing is written on the console
+    DiagnosticLog log;
+    RKSolver solver;
+    solver.SetDiagnosticSink(&log);
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    solver.SetStepSize(-0.1);
+    solver.SetTimeInterval(2., 1.);
+    solver.SetOrder(7);
+    EXPECT_EQ("", testing::internal::GetCapturedStdout());
+    EXPECT_EQ("", testing::internal::GetCapturedStderr());
+    ASSERT_EQ(3u, log.Size());
+    const std::vector<Diagnostic> diagnostics = log.GetDiagnostics();
+    EXPECT_EQ("The step size is set to |h| = 0.1", diagnostics[0].action);
+    EXPECT_EQ("t1 and t0 are switched.", diagnostics[1].action);
+    EXPECT_DOUBLE_EQ(0.1, solver.GetStepSize());
+    EXPECT_DOUBLE_EQ(1., solver.GetInitialTime());
+}
+
+TEST(SolverResult_test, counters) {
+    // s evaluations per step for the Runge-Kutta solver of order s
+    RKSolver solver_RK(0.1, 0., 10., 1., fRhs4, 4);
+    Trajectory trajectory;
+    SolverResult result = solver_RK.SolveEquation(trajectory);
+    EXPECT_EQ(SolverStatus::Success, result.status);
+    EXPECT_EQ(4*solver_RK.GetNumberOfSteps(), result.rhsEvaluations);
+    EXPECT_EQ(0u, result.nonFiniteValues);
+    // the evaluations made on the worker threads are counted
+    ExtrapolationSolver solver_GBS(0.1, 0., 10., 1., fRhs4, 4);
+    solver_GBS.SolveEquation();
+    const unsigned long evaluations = solver_GBS.GetResult().rhsEvaluations;
+    solver_GBS.SetNumberOfThreads(3);
+    solver_GBS.SolveEquation();
+    EXPECT_EQ(evaluations, solver_GBS.GetResult().rhsEvaluations);
+    EXPECT_EQ(solver_GBS.GetNumberOfSteps()*(1 + 1 + 3 + 5 + 7), evaluations);
+}
+
+double fRhsBlowUp(double y, double t) { return y*y; }
+double dfRhsWrong(double y, double t) { return 1e4; }
+
+TEST(SolverResult_test, anomalies_reported_once) {
+    // y' = y^2, y(0) = 1 blows up at t = 1
+    DiagnosticLog log;
+    RKSolver solver_RK(1e-2, 0., 2., 1., fRhsBlowUp, 4);
+    solver_RK.SetDiagnosticSink(&log);
+    solver_RK.SolveEquation();
+    SolverResult result = solver_RK.GetResult();
+    EXPECT_EQ(SolverStatus::NonFinite, result.status);
+    EXPECT_GT(result.nonFiniteValues, 0u);
+    EXPECT_GT(result.firstNonFiniteTime, 1.);
+    EXPECT_LE(result.firstNonFiniteTime, 2.);
+    EXPECT_EQ(1u, log.Size());
+
+    // a wrong derivative prevents the Newton method from converging at every step
+    log.Clear();
+    AdamsMoultonSolver solver_AM(0.1, 0., 1., 1., fRhs1, dfRhsWrong, 0);
+    solver_AM.SetDiagnosticSink(&log);
+    solver_AM.SolveEquation();
+    result = solver_AM.GetResult();
+    EXPECT_EQ(SolverStatus::NewtonNotConverged, result.status);
+    EXPECT_EQ(solver_AM.GetNumberOfSteps(), result.newtonFailures);
+    ASSERT_EQ(1u, log.Size());
+    EXPECT_EQ("MAX_IT", log.GetDiagnostics()[0].tag);
+}
+
+double logistic(double r, double y0, double t) { return 1/(1 + (1/y0 - 1)*exp(-r*t)); }
+
+void Test_sensitivities(AbstractOdeSolver *solver, double tol) {
+    // y' = r y (1 - y): the sensitivities with respect to r and y0 are compared with the derivatives of the exact
+    // solution
+    const double r = 1.5;
+    const double y0 = 0.2;
+    Expression f("r*y*(1 - y)", {{"r", r}});
+    ForwardSensitivity sensitivity = ForwardSensitivity::FromExpression(f, {"r"});
+    ASSERT_EQ(2u, sensitivity.Size());
+    solver->SetRightHandSide(Expression::RightHandSide, &f);
+    solver->SetTimeInterval(0., 2.);
+    solver->SetInitialValue(y0);
+    solver->SetSensitivity(&sensitivity);
+    ASSERT_EQ(&sensitivity, solver->GetSensitivity());
+    Trajectory trajectory = solver->SolveEquation();
+    ASSERT_EQ(trajectory.Size(), sensitivity.GetNumberOfRecords());
+    const double eps = 1e-6;
+    for (size_t i = 0; i < trajectory.Size(); i += 50) {
+        const double t = trajectory.GetTime(i);
+        const double dr = (logistic(r + eps, y0, t) - logistic(r - eps, y0, t))/(2*eps);
+        const double dy0 = (logistic(r, y0 + eps, t) - logistic(r, y0 - eps, t))/(2*eps);
+        EXPECT_NEAR(dr, sensitivity.GetSensitivity(0, i), tol) << "order " << solver->GetOrder() << ", t = " << t;
+        EXPECT_NEAR(dy0, sensitivity.GetSensitivity(1, i), tol) << "order " << solver->GetOrder() << ", t = " << t;
+    }
+    EXPECT_NEAR((logistic(r + eps, y0, 2.) - logistic(r - eps, y0, 2.))/(2*eps), sensitivity.GetSensitivity(0), tol);
+}
+
+TEST(ForwardSensitivity_test, logistic) {
+    for (unsigned int s = 1; s <= 4; s++) {
+        RKSolver solver_RK(1e-2, 0., 2., 0.2, fRhs1, s);
+        Test_sensitivities(&solver_RK, s == 1 ? 3e-2 : 1e-4);
+        LowStorageRKSolver solver_LSRK(1e-2, 0., 2., 0.2, fRhs1, s);
+        Test_sensitivities(&solver_LSRK, s == 1 ? 3e-2 : 1e-4);
+    }
+    for (unsigned int s = 2; s <= max_order; s++) {
+        AdamsBashforthSolver solver_AB(1e-2, 0., 2., 0.2, fRhs1, s);
+        Test_sensitivities(&solver_AB, 1e-4);
+    }
+    Expression df("r*(1 - 2*y)", {{"r", 1.5}});
+    for (unsigned int s = 1; s < max_order; s++) {
+        AdamsMoultonSolver solver_AM(1e-2, 0., 2., 0.2, fRhs1, dfRhs1, s);
+        solver_AM.SetdRightHandSide(Expression::RightHandSide, &df);
+        Test_sensitivities(&solver_AM, 1e-4);
+    }
+}
+
+double dfdyDecay(double y, double t, void *k) { return -*static_cast<double *>(k); }
+double dfdkDecay(double y, double t, void *k) { return -y; }
+
+TEST(ForwardSensitivity_test, user_jacobian) {
+    // y' = -k y: dy/dk = -t y0 exp(-k t) and dy/dy0 = exp(-k t)
+    double k = 2.;
+    ForwardSensitivity sensitivity;
+    sensitivity.SetJacobian(dfdyDecay, &k);
+    sensitivity.AddInitialValue();
+    sensitivity.AddParameter(dfdkDecay, &k);
+    RKSolver solver(1e-3, 0., 1., 3., fRhs2, 4);
+    solver.SetRightHandSide([](double y, double t, void *k) { return -*static_cast<double *>(k)*y; }, &k);
+    solver.SetSensitivity(&sensitivity);
+    solver.SolveEquation();
+    EXPECT_NEAR(exp(-2.), sensitivity.GetSensitivity(0), 1e-10);
+    EXPECT_NEAR(-3*exp(-2.), sensitivity.GetSensitivity(1), 1e-10);
+
+    // the solvers which can not compute the sensitivities report it when they are configured
+    DiagnosticLog log;
+    ETDSolver solver_ETD;
+    solver_ETD.SetDiagnosticSink(&log);
+    solver_ETD.SetSensitivity(&sensitivity);
+    EXPECT_EQ(nullptr, solver_ETD.GetSensitivity());
+    ForwardSensitivity no_jacobian;
+    no_jacobian.AddInitialValue();
+    solver.SetDiagnosticSink(&log);
+    solver.SetSensitivity(&no_jacobian);
+    EXPECT_EQ(nullptr, solver.GetSensitivity());
+    EXPECT_EQ(2u, log.Size());
+}
+
+double dgSquare(double y, void *context) { return 2*y; }
+
+TEST(RKAdjoint_test, same_gradient_as_forward_sensitivities) {
+    // the discrete adjoint and the forward sensitivities are both exact derivatives of the numerical solution
+    Expression f("r*y*(1 - y) + a*sin(t)", {{"r", 1.5}, {"a", 0.1}});
+    ForwardSensitivity sensitivity = ForwardSensitivity::FromExpression(f, {"r", "a"});
+    for (unsigned int s = 1; s <= 4; s++) {
+        RKSolver solver(1e-2, 0., 2., 0.2, fRhs1, s);
+        solver.SetRightHandSide(Expression::RightHandSide, &f);
+        solver.SetSensitivity(&sensitivity);
+        const double y1 = solver.SolveEquation().GetValues().back();
+        solver.SetSensitivity(nullptr);
+
+        // 200 steps with 3 checkpoints: each step is computed at most 9 times
+        RKAdjoint adjoint(solver, sensitivity, 3);
+        std::vector<double> gradient = adjoint.Gradient();
+        ASSERT_EQ(3u, gradient.size());
+        EXPECT_NEAR(y1, adjoint.GetFinalValue(), 1e-12);
+        for (unsigned int k = 0; k < 3; k++) {
+            EXPECT_NEAR(sensitivity.GetSensitivity(k), gradient[k], 1e-12) << "order " << s << ", parameter " << k;
+        }
+        EXPECT_LE(adjoint.GetNumberOfCheckpointsUsed(), 3u);
+        EXPECT_LE(adjoint.GetNumberOfForwardSteps(), 9*solver.GetNumberOfSteps());
+
+        // J = y(t1)^2, with enough checkpoints to store every step
+        RKAdjoint adjoint_all(solver, sensitivity, 200);
+        gradient = adjoint_all.Gradient(dgSquare);
+        EXPECT_NEAR(2*y1*sensitivity.GetSensitivity(0), gradient[0], 1e-12);
+        EXPECT_NEAR(2*y1*sensitivity.GetSensitivity(2), gradient[2], 1e-12);
+        EXPECT_LE(adjoint_all.GetNumberOfForwardSteps(), 2*solver.GetNumberOfSteps());
+    }
+}
+
+TEST(RKAdjoint_test, Binomial) {
+    EXPECT_EQ(1u, RKAdjoint::Binomial(0, 7));
+    EXPECT_EQ(220u, RKAdjoint::Binomial(3, 9));
+    EXPECT_EQ(RKAdjoint::Binomial(9, 3), RKAdjoint::Binomial(3, 9));
+    EXPECT_EQ(ULONG_MAX, RKAdjoint::Binomial(200, 200));
+}
+
+TEST(StepSizeController_test, factors) {
+    IStepSizeController controller_I;
+    EXPECT_DOUBLE_EQ(0.9*std::pow(0.5, -1./4), controller_I.Factor(0.5, 4));
+    EXPECT_DOUBLE_EQ(5., controller_I.Factor(0., 4));
+    EXPECT_DOUBLE_EQ(0.2, controller_I.Factor(1e6, 4));
+    // no increase after a rejected step, until a step is accepted
+    controller_I.Reject();
+    EXPECT_DOUBLE_EQ(1., controller_I.Factor(1e-3, 4));
+    controller_I.Accept(1e-3);
+    EXPECT_DOUBLE_EQ(5., controller_I.Factor(1e-3, 4));
+
+    // the PI controller uses the error of the previous accepted step
+    PIStepSizeController controller_PI;
+    EXPECT_DOUBLE_EQ(0.9*std::pow(0.5, -0.7/4), controller_PI.Factor(0.5, 4));
+    controller_PI.Accept(0.8);
+    EXPECT_DOUBLE_EQ(0.9*std::pow(0.5, -0.7/4)*std::pow(0.8, 0.4/4), controller_PI.Factor(0.5, 4));
+    controller_PI.Reset();
+    EXPECT_DOUBLE_EQ(0.9*std::pow(0.5, -0.7/4), controller_PI.Factor(0.5, 4));
+
+    // the PID controller with beta2 = beta3 = 0 is the I controller
+    PIDStepSizeController controller_PID(1., 0., 0.);
+    controller_PID.Accept(0.3);
+    EXPECT_DOUBLE_EQ(controller_I.Factor(0.5, 4), controller_PID.Factor(0.5, 4));
+}
+
+TEST(StepSizeController_test, InitialStepSize) {
+    // the step size decreases with the tolerance as tol^(1/(p+1)), and with the stiffness
+    RKSolver solver(1e-3, 0., 10., 1., fRhs4, 4);
+    const double h_4 = solver.InitialStepSize(1e-4, 4);
+    const double h_9 = solver.InitialStepSize(1e-9, 4);
+    EXPECT_GT(h_4, 1e-3);
+    EXPECT_LT(h_4, 1.);
+    EXPECT_NEAR(std::pow(1e5, 1./5), h_4/h_9, 1e-6);
+    RKSolver stiff_solver(1e-3, 0., 10., 1., fRhs2, 4);
+    EXPECT_LT(stiff_solver.InitialStepSize(1e-4, 4), h_4/5);
+    EXPECT_EQ(4u, solver.GetResult().rhsEvaluations);
+}
+
+TEST(StepSizeController_test, extrapolation_with_controllers) {
+    // every controller gives the solution within the tolerance, starting from the automatic initial step size
+    IStepSizeController controller_I;
+    PIStepSizeController controller_PI;
+    PIDStepSizeController controller_PID;
+    AbstractStepSizeController *controllers[] = {nullptr, &controller_I, &controller_PI, &controller_PID};
+    for (AbstractStepSizeController *controller : controllers) {
+        ExtrapolationSolver solver(1., 0., 10., sol4(0.), fRhs4, 4);
+        solver.SetTolerance(1e-8);
+        solver.SetStepSizeController(controller);
+        solver.SetAutomaticInitialStep(true);
+        Trajectory trajectory = solver.SolveEquation();
+        const SolverResult &result = solver.GetResult();
+        EXPECT_EQ(trajectory.Size(), result.acceptedSteps + 1);
+        EXPECT_LT(result.rejectedSteps, result.acceptedSteps);
+        EXPECT_DOUBLE_EQ(10., trajectory.GetTimes().back());
+        for (size_t i = 0; i < trajectory.Size(); i++) {
+            EXPECT_NEAR(sol4(trajectory.GetTime(i)), trajectory.GetValue(i), 1e-6);
+        }
+    }
+}
+
+// ADAMS COEFFICIENTS:
+TEST(AdamsCoefficients_test, exact_values) {
+    const AdamsCoefficients &coefficients = AdamsCoefficients::Get();
+    // Adams-Bashforth of order 5 and Adams-Moulton of order 5, from the oldest value of f to the newest
+    const long long bashforth[5] = {251, -1274, 2616, -2774, 1901};
+    const long long moulton[5] = {-19, 106, -264, 646, 251};
+    for (unsigned int j = 0; j < 5; j++) {
+        EXPECT_EQ(Rational(bashforth[j], 720), coefficients.Bashforth(5, j));
+        EXPECT_EQ(Rational(moulton[j], 720), coefficients.Moulton(4, j));
+    }
+    EXPECT_EQ(Rational(4527766399, 958003200), coefficients.Bashforth(12, 11));
+    EXPECT_EQ(Rational(-4777223, 17418240), coefficients.Bashforth(12, 0));
+    EXPECT_EQ(Rational(4777223, 17418240), coefficients.Moulton(11, 11));
+}
+
+TEST(AdamsCoefficients_test, sum_to_one) {
+    // exactly, and up to round-off for the coefficients of the solvers
+    const AdamsCoefficients &coefficients = AdamsCoefficients::Get();
+    AdamsBashforthSolver solver_AB;
+    AdamsMoultonSolver solver_AM;
+    for (unsigned int s = 1; s <= max_order; s++) {
+        Rational sum_AB, sum_AM;
+        for (unsigned int j = 0; j < s; j++) {
+            sum_AB += coefficients.Bashforth(s, j);
+            sum_AM += coefficients.Moulton(s-1, j);
+            EXPECT_DOUBLE_EQ(coefficients.Bashforth(s, j).ToDouble(), solver_AB.GetB(s-1, j));
+            EXPECT_DOUBLE_EQ(coefficients.Moulton(s-1, j).ToDouble(), solver_AM.GetB(s-1, j+1));
+        }
+        EXPECT_EQ(Rational(1), sum_AB) << "order " << s;
+        EXPECT_EQ(Rational(1), sum_AM) << "order " << s;
+    }
+}
+
+TEST(AdamsCoefficients_test, observed_orders_up_to_max_order) {
+    // the stability interval of the Adams-Bashforth methods shrinks quickly with the order: they are checked on a
+    // right hand side which does not depend on y, with larger steps to stay above the round-off
+    for (unsigned int s = 6; s <= max_order; s++) {
+        AdamsBashforthSolver solver_AB(0.1, 0., 10., 0., fRhs3, s);
+        WorkPrecision work_precision_AB(sol3);
+        std::vector<WorkPrecisionPoint> points = work_precision_AB.SweepStepSize(solver_AB,
+                                                                                 {1./2, 1./4, 1./8, 1./16, 1./32});
+        EXPECT_NEAR(s, WorkPrecision::ObservedOrder(points), 0.5) << "order " << s;
+
+        AdamsMoultonSolver solver_AM(0.1, 0., 10., 1., fRhs4, dfRhs4, s-1);
+        WorkPrecision work_precision_AM(sol4);
+        points = work_precision_AM.SweepStepSize(solver_AM, {1./4, 1./8, 1./16, 1./32, 1./64});
+        EXPECT_NEAR(s, WorkPrecision::ObservedOrder(points), 0.5) << "order " << s;
+    }
+}
+
+TEST(AdamsCoefficients_test, starting_values_keep_high_orders) {
+    // the number of Runge-Kutta sub-steps of the starting values depends on the problem: with f depending on y, and
+    // on the stiff decay whose steps are small for stability, the starting values do not limit the order
+    const TestProblem *exp_sin = ProblemLibrary::Find("exp_sin");
+    for (unsigned int s = 6; s <= 8; s++) {
+        AdamsBashforthSolver solver(0.1, exp_sin->t0, exp_sin->t1, exp_sin->y0, exp_sin->f, s);
+        std::vector<WorkPrecisionPoint> points = WorkPrecision(exp_sin->solution).SweepStepSize(
+                solver, {1./16, 1./32, 1./64, 1./128});
+        EXPECT_NEAR(s, WorkPrecision::ObservedOrder(points), 0.5) << "order " << s;
+    }
+    const TestProblem *stiff_decay = ProblemLibrary::Find("stiff_decay");
+    AdamsBashforthSolver solver(0.1, stiff_decay->t0, stiff_decay->t1, stiff_decay->y0, stiff_decay->f, 6);
+    std::vector<WorkPrecisionPoint> points = WorkPrecision(stiff_decay->solution).SweepStepSize(
+            solver, {std::ldexp(1., -10), std::ldexp(1., -11), std::ldexp(1., -12), std::ldexp(1., -13)});
+    EXPECT_NEAR(6., WorkPrecision::ObservedOrder(points, 1e-14), 0.5);
+}
+
+// LINEAR COMBINATION KERNELS:
+TEST(LinearCombination_test, kernels_agree) {
+    // every kernel supported by the processor against the portable loop, with lengths which are not multiples of
+    // the width of the vectors, and in place
+    const InstructionSet initial = LinearCombination::GetInstructionSet();
+    EXPECT_TRUE(LinearCombination::IsSupported(initial));
+    const size_t n_max = 37;
+    const unsigned int m_max = 6;
+    std::vector<double> y(n_max), k_values(m_max*n_max), c(m_max);
+    const double *k[m_max];
+    for (unsigned int j = 0; j < m_max; j++) {
+        c[j] = std::cos(3.*j + 1);
+        k[j] = &k_values[j*n_max];
+        for (size_t i = 0; i < n_max; i++) {
+            k_values[j*n_max + i] = std::sin(0.7*i + j);
+        }
+    }
+    for (size_t i = 0; i < n_max; i++) {
+        y[i] = 1. + 0.1*i;
+    }
+    for (InstructionSet set : {InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2,
+                               InstructionSet::AVX512}) {
+        if (!LinearCombination::IsSupported(set)) {
+            continue;
+        }
+        LinearCombination::SetInstructionSet(set);
+        EXPECT_EQ(set, LinearCombination::GetInstructionSet());
+        for (size_t n : {0, 1, 3, 8, 17, 37}) {
+            for (unsigned int m = 0; m <= m_max; m++) {
+                std::vector<double> result(n), in_place(y.begin(), y.begin() + n);
+                LinearCombination::Compute(n, y.data(), 0.25, m, c.data(), k, result.data());
+                LinearCombination::Compute(n, in_place.data(), 0.25, m, c.data(), k, in_place.data());
+                for (size_t i = 0; i < n; i++) {
+                    double sum = 0.;
+                    for (unsigned int j = 0; j < m; j++) {
+                        sum += c[j]*k[j][i];
+                    }
+                    EXPECT_NEAR(y[i] + 0.25*sum, result[i], 1e-14) << LinearCombination::GetName(set);
+                    EXPECT_EQ(result[i], in_place[i]) << LinearCombination::GetName(set);
+                }
+            }
+        }
+    }
+    LinearCombination::SetInstructionSet(initial);
+}
+
+TEST(LinearCombination_test, same_sensitivities_with_each_kernel) {
+    // the Runge-Kutta solver combines the stages of the sensitivities with the kernels
+    const InstructionSet initial = LinearCombination::GetInstructionSet();
+    Expression f("r*y*(1 - y) + a*sin(t) + b*y", {{"r", 1.5}, {"a", 0.2}, {"b", -0.1}});
+    ForwardSensitivity sensitivity = ForwardSensitivity::FromExpression(f, {"r", "a", "b"});
+    RKSolver solver(1e-2, 0., 2., 0.2, fRhs1, 4);
+    solver.SetRightHandSide(Expression::RightHandSide, &f);
+    solver.SetSensitivity(&sensitivity);
+    LinearCombination::SetInstructionSet(InstructionSet::Scalar);
+    solver.SolveEquation();
+    std::vector<double> reference;
+    for (unsigned int p = 0; p < sensitivity.Size(); p++) {
+        reference.push_back(sensitivity.GetSensitivity(p));
+    }
+    LinearCombination::SetInstructionSet(initial);
+    solver.SolveEquation();
+    for (unsigned int p = 0; p < sensitivity.Size(); p++) {
+        EXPECT_NEAR(reference[p], sensitivity.GetSensitivity(p), 1e-12);
+    }
+}
+
+// METHOD OF LINES:
+std::vector<double> Jacobian_product(const MethodOfLines &system, const std::vector<double> &u,
+                                     const std::vector<double> &v) {
+    // product of the Jacobian at u, in the sparsity pattern, with v
+    const SparsityPattern &sparsity = system.GetSparsity();
+    std::vector<double> values(sparsity.columns.size());
+    system.Jacobian(u.data(), 0., values.data());
+    std::vector<double> product(system.Size(), 0.);
+    for (size_t k = 0; k < system.Size(); k++) {
+        EXPECT_TRUE(std::is_sorted(sparsity.columns.begin() + sparsity.rowStart[k],
+                                   sparsity.columns.begin() + sparsity.rowStart[k+1]));
+        for (size_t e = sparsity.rowStart[k]; e < sparsity.rowStart[k+1]; e++) {
+            product[k] += values[e]*v[sparsity.columns[e]];
+        }
+    }
+    return product;
+}
+
+TEST(MethodOfLines_test, heat_eigenmodes) {
+    // sin(pi x) and cos(2 pi x) cos(2 pi y) are eigenvectors of the discrete Laplacians
+    const double pi = std::acos(-1.);
+    MethodOfLines heat_1D = MethodOfLines::Heat1D(99, 1., 0.5);
+    std::vector<double> u(heat_1D.Size()), du(heat_1D.Size());
+    for (size_t k = 0; k < u.size(); k++) {
+        u[k] = std::sin(pi*heat_1D.GetX(k));
+    }
+    heat_1D.RightHandSide(u.data(), 0., du.data());
+    const double dx = heat_1D.GetDx();
+    const double lambda_1D = -0.5*4/(dx*dx)*std::pow(std::sin(pi*dx/2), 2);
+    for (size_t k = 0; k < u.size(); k++) {
+        EXPECT_NEAR(lambda_1D*u[k], du[k], 1e-10);
+    }
+
+    MethodOfLines heat_2D = MethodOfLines::Heat2D(40, 30, 1., 1., 2., Boundary::Periodic);
+    u.resize(heat_2D.Size());
+    du.resize(heat_2D.Size());
+    std::vector<double> du_tiles(heat_2D.Size());
+    for (size_t k = 0; k < u.size(); k++) {
+        u[k] = std::cos(2*pi*heat_2D.GetX(k))*std::cos(2*pi*heat_2D.GetY(k));
+    }
+    heat_2D.RightHandSide(u.data(), 0., du.data());
+    // tiles narrower than the rows give the same values
+    heat_2D.SetBlockSize(7);
+    heat_2D.RightHandSide(u.data(), 0., du_tiles.data());
+    const double h_x = heat_2D.GetDx(), h_y = heat_2D.GetDy();
+    const double lambda_2D = -2.*(4/(h_x*h_x)*std::pow(std::sin(pi*h_x), 2) + 4/(h_y*h_y)*std::pow(std::sin(pi*h_y), 2));
+    for (size_t k = 0; k < u.size(); k++) {
+        EXPECT_NEAR(lambda_2D*u[k], du[k], 1e-9);
+        EXPECT_EQ(du[k], du_tiles[k]);
+    }
+}
+
+TEST(MethodOfLines_test, advection_conserves_mass) {
+    // with periodic conditions, the upwind scheme conserves the sum of the unknowns and a constant is steady
+    for (double velocity : {1.5, -0.5}) {
+        MethodOfLines advection = MethodOfLines::Advection1D(50, 2., velocity);
+        std::vector<double> u(advection.Size()), du(advection.Size());
+        for (size_t k = 0; k < u.size(); k++) {
+            u[k] = std::exp(-std::pow(advection.GetX(k) - 1., 2));
+        }
+        advection.RightHandSide(u.data(), 0., du.data());
+        double sum = 0.;
+        for (double value : du) {
+            sum += value;
+        }
+        EXPECT_NEAR(0., sum, 1e-12);
+        std::fill(u.begin(), u.end(), 3.);
+        advection.RightHandSide(u.data(), 0., du.data());
+        for (double value : du) {
+            EXPECT_NEAR(0., value, 1e-12);
+        }
+    }
+}
+
+double reaction_cubic(double u, double t, void *) { return u - u*u*u; }
+double dreaction_cubic(double u, double t, void *) { return 1 - 3*u*u; }
+
+TEST(MethodOfLines_test, Jacobian) {
+    // the Jacobian in the sparsity pattern matches the right hand side (exactly for the linear problems, with
+    // central differences for the reaction), also on grids small enough for periodic neighbours to coincide
+    std::vector<MethodOfLines> systems = {
+            MethodOfLines::Heat2D(6, 5, 1., 2., 0.3),
+            MethodOfLines::Heat2D(2, 3, 1., 1., 1., Boundary::Periodic),
+            MethodOfLines::Advection1D(9, 1., -2.),
+            MethodOfLines::ReactionDiffusion1D(1, 1., 1., reaction_cubic, dreaction_cubic, nullptr),
+            MethodOfLines::ReactionDiffusion2D(8, 7, 1., 1., 0.1, reaction_cubic, dreaction_cubic, nullptr,
+                                               Boundary::Periodic),
+    };
+    for (const MethodOfLines &system : systems) {
+        const size_t size = system.Size();
+        EXPECT_EQ(size + 1, system.GetSparsity().rowStart.size());
+        std::vector<double> u(size), v(size), u_plus(size), u_minus(size), f_plus(size), f_minus(size);
+        for (size_t k = 0; k < size; k++) {
+            u[k] = std::sin(1. + k);
+            v[k] = std::cos(2.*k);
+        }
+        const double eps = 1e-6;
+        for (size_t k = 0; k < size; k++) {
+            u_plus[k] = u[k] + eps*v[k];
+            u_minus[k] = u[k] - eps*v[k];
+        }
+        system.RightHandSide(u_plus.data(), 0., f_plus.data());
+        system.RightHandSide(u_minus.data(), 0., f_minus.data());
+        std::vector<double> product = Jacobian_product(system, u, v);
+        for (size_t k = 0; k < size; k++) {
+            EXPECT_NEAR((f_plus[k] - f_minus[k])/(2*eps), product[k], 1e-6);
+        }
+    }
+    EXPECT_THROW(MethodOfLines::Heat1D(0, 1., 1.), UncoherentValueException);
+}
+
+
+// PROBLEM LIBRARY:
+TEST(ProblemLibrary_test, Find) {
+    // the functions 1, 2 and 3 of main_solver come first, and each problem is found by its name
+    const std::vector<TestProblem> &problems = ProblemLibrary::GetProblems();
+    ASSERT_LE(3u, problems.size());
+    EXPECT_EQ("polynomial", problems[0].name);
+    EXPECT_EQ("stiff_decay", problems[1].name);
+    EXPECT_EQ("trigonometric", problems[2].name);
+    for (const TestProblem &problem : problems) {
+        EXPECT_EQ(&problem, ProblemLibrary::Find(problem.name));
+    }
+    EXPECT_EQ(nullptr, ProblemLibrary::Find("lorenz"));
+}
+
+TEST(ProblemLibrary_test, exact_solutions_and_derivatives) {
+    // y0 = y(t0), the exact solution satisfies the equation, df is the derivative of f and f = L*y + N
+    const double eps = 1e-6;
+    for (const TestProblem &problem : ProblemLibrary::GetProblems()) {
+        SCOPED_TRACE(problem.name);
+        EXPECT_NEAR(problem.y0, problem.solution(problem.t0), 1e-14);
+        for (int i = 0; i <= 10; i++) {
+            const double t = problem.t0 + i*(problem.t1 - problem.t0)/10;
+            const double y = problem.solution(t);
+            const double scale = 1 + std::abs(problem.f(y, t));
+            const double dsol = (problem.solution(t + eps) - problem.solution(t - eps))/(2*eps);
+            EXPECT_NEAR(dsol, problem.f(y, t), 1e-5*scale);
+            const double dfdy = (problem.f(y + eps, t) - problem.f(y - eps, t))/(2*eps);
+            EXPECT_NEAR(dfdy, problem.df(y, t), 1e-5*(1 + std::abs(dfdy)));
+            EXPECT_NEAR(problem.f(y, t), problem.linearPart*y + problem.nonlinearPart(y, t), 1e-12*scale);
+        }
+    }
+}
+
+TEST(ProblemLibrary_test, solved_by_each_solver) {
+    // the problems are solved with the step size needed by the explicit solvers on the stiff ones
+    for (const TestProblem &problem : ProblemLibrary::GetProblems()) {
+        SCOPED_TRACE(problem.name);
+        const double h = problem.stiff ? 1e-4 : 1e-3;
+        std::vector<std::unique_ptr<AbstractOdeSolver>> solvers;
+        solvers.emplace_back(new RKSolver);
+        solvers.emplace_back(new AdamsBashforthSolver);
+        AdamsMoultonSolver *implicit_solver = new AdamsMoultonSolver;
+        implicit_solver->SetdRightHandSide(problem.df);
+        solvers.emplace_back(implicit_solver);
+        for (std::unique_ptr<AbstractOdeSolver> &solver : solvers) {
+            solver->SetStepSize(h);
+            solver->SetTimeInterval(problem.t0, problem.t1);
+            solver->SetInitialValue(problem.y0);
+            solver->SetOrder(3);
+            solver->SetRightHandSide(problem.f);
+            const Trajectory trajectory = solver->SolveEquation();
+            EXPECT_NEAR(problem.solution(trajectory.GetTimes().back()), trajectory.GetValues().back(),
+                        1e-6*(1 + std::abs(trajectory.GetValues().back())));
+        }
+    }
+}
+
+
+// AUTOMATIC SOLVER:
+double max_error(const Trajectory &trajectory, double (*solution)(double)) {
+    double error = 0.;
+    for (size_t i = 0; i < trajectory.GetTimes().size(); i++) {
+        error = std::max(error, std::abs(trajectory.GetValues()[i] - solution(trajectory.GetTimes()[i])));
+    }
+    return error;
+}
+
+TEST(AutoSolver_test, EstimateEigenvalue) {
+    // the finite difference estimate of df/dy matches df, which is used when it is set
+    const TestProblem &problem = *ProblemLibrary::Find("logistic");
+    AutoSolver solver;
+    solver.SetRightHandSide(problem.f);
+    for (double y : {-1., 0.2, 0.5, 3.}) {
+        EXPECT_NEAR(problem.df(y, 0.), solver.EstimateEigenvalue(y, 0., problem.f(y, 0.)), 1e-6);
+    }
+    solver.SetdRightHandSide(problem.df);
+    EXPECT_DOUBLE_EQ(problem.df(0.2, 0.), solver.EstimateEigenvalue(0.2, 0., 0.));
+}
+
+TEST(AutoSolver_test, implicit_when_stiff) {
+    // on the Prothero-Robinson problem, the implicit methods are chosen with steps much bigger than the stability
+    // limit of the explicit ones, with or without df
+    const TestProblem &problem = *ProblemLibrary::Find("prothero_robinson");
+    for (bool with_df : {false, true}) {
+        AutoSolver solver;
+        solver.SetStepSize(0.1);
+        solver.SetTimeInterval(problem.t0, problem.t1);
+        solver.SetInitialValue(problem.y0);
+        solver.SetRightHandSide(problem.f);
+        if (with_df) {
+            solver.SetdRightHandSide(problem.df);
+        }
+        const Trajectory trajectory = solver.SolveEquation();
+        EXPECT_EQ(SolverStatus::Success, solver.GetResult().status);
+        EXPECT_LT(max_error(trajectory, problem.solution), 1e-6);
+        ASSERT_FALSE(solver.GetChoices().empty());
+        for (const AutoSolverChoice &choice : solver.GetChoices()) {
+            EXPECT_NEAR(problem.linearPart, choice.eigenvalue, 1e-3*std::abs(problem.linearPart));
+            EXPECT_TRUE(choice.implicit);
+            EXPECT_GT(choice.stepSize, 5*2.7853/std::abs(problem.linearPart));
+        }
+        // the classic Runge-Kutta method needs at least 4*360 evaluations to be stable
+        EXPECT_LT(solver.GetResult().rhsEvaluations, 4*360u);
+    }
+}
+
+TEST(AutoSolver_test, explicit_when_not_stiff) {
+    // on the non-stiff problems, an explicit method is chosen and the error follows the tolerance
+    for (const std::string name : {"trigonometric", "exp_sin", "logistic"}) {
+        const TestProblem &problem = *ProblemLibrary::Find(name);
+        AutoSolver solver;
+        solver.SetStepSize(0.1);
+        solver.SetTimeInterval(problem.t0, problem.t1);
+        solver.SetInitialValue(problem.y0);
+        solver.SetRightHandSide(problem.f);
+        solver.SetdRightHandSide(problem.df);
+        double previous_error = 1.;
+        for (double tol : {1e-4, 1e-6, 1e-8}) {
+            solver.SetTolerance(tol);
+            const Trajectory trajectory = solver.SolveEquation();
+            for (const AutoSolverChoice &choice : solver.GetChoices()) {
+                EXPECT_FALSE(choice.implicit) << name;
+            }
+            const double error = max_error(trajectory, problem.solution);
+            EXPECT_LT(error, 1e3*tol) << name;
+            EXPECT_LE(error, previous_error) << name;
+            previous_error = error;
+        }
+    }
+}
+
+TEST(AutoSolver_test, switch_after_transient) {
+    // y' = -100 y: the fast transient needs small steps anyway, an explicit method is used, then an implicit method
+    // with big steps once the solution is smooth
+    const TestProblem &problem = *ProblemLibrary::Find("stiff_decay");
+    AutoSolver solver;
+    solver.SetStepSize(0.1);
+    solver.SetTimeInterval(problem.t0, problem.t1);
+    solver.SetInitialValue(problem.y0);
+    solver.SetRightHandSide(problem.f);
+    solver.SetdRightHandSide(problem.df);
+    const Trajectory trajectory = solver.SolveEquation();
+    EXPECT_LT(max_error(trajectory, problem.solution), 1e-6);
+    EXPECT_DOUBLE_EQ(problem.t1, trajectory.GetTimes().back());
+    ASSERT_LE(2u, solver.GetChoices().size());
+    EXPECT_FALSE(solver.GetChoices().front().implicit);
+    EXPECT_TRUE(solver.GetChoices().back().implicit);
+}
+
+TEST(RosenbrockSolver_test, observed_orders) {
+    // with df, and with the finite difference Jacobian. ROS2 converges faster than h^2 for the bigger steps.
+    for (unsigned int s = 1; s <= 4; s++) {
+        const double tol = s == 2 ? 0.5 : 0.3;
+        RosenbrockSolver solver(0.1, 0., 10., 1., fRhs4, dfRhs4, s);
+        Test_observed_order(&solver, s, tol);
+        RosenbrockSolver solver_fd(0.1, 0., 10., 1., fRhs4, nullptr, s);
+        Test_observed_order(&solver_fd, s, tol);
+    }
+}
+
+TEST(RosenbrockSolver_test, time_dependent_orders) {
+    // f depends on t only: the order is limited by the finite difference of df/dt, not by the Jacobian. The error
+    // of RODAS4 reaches the round-off below h = 1/64.
+    const TestProblem &problem = *ProblemLibrary::Find("trigonometric");
+    for (unsigned int s = 1; s <= 4; s++) {
+        RosenbrockSolver solver(0.1, problem.t0, problem.t1, problem.y0, problem.f, problem.df, s);
+        std::vector<WorkPrecisionPoint> points = WorkPrecision(problem.solution).SweepStepSize(
+                solver, {1./8, 1./16, 1./32, 1./64});
+        EXPECT_GT(WorkPrecision::ObservedOrder(points), s - 0.3) << "order " << s;
+    }
+}
+
+TEST(RosenbrockSolver_test, stiff_with_large_steps) {
+    // Prothero-Robinson with h = 0.1, 100 times the stability limit of the explicit methods: the methods are
+    // L-stable and the error decreases with the order
+    const TestProblem &problem = *ProblemLibrary::Find("prothero_robinson");
+    double previous_error = 1.;
+    for (unsigned int s = 1; s <= 4; s++) {
+        RosenbrockSolver solver(0.1, problem.t0, problem.t1, problem.y0, problem.f, problem.df, s);
+        const double error = max_error(solver.SolveEquation(), problem.solution);
+        EXPECT_LT(error, 0.1) << "order " << s;
+        EXPECT_LT(error, previous_error) << "order " << s;
+        previous_error = error;
+    }
+    EXPECT_LT(previous_error, 1e-5);
+}
+
+TEST(RosenbrockSolver_test, adaptive) {
+    // the error follows the tolerance. The local error is estimated with a method of lower order, whose error
+    // may be small by chance where the error of the method is not: the global error is only within 1e3*tol.
+    for (unsigned int s = 2; s <= 4; s++) {
+        RosenbrockSolver solver(0.1, 0., 10., 1., fRhs4, dfRhs4, s);
+        double previous_error = 1.;
+        for (double tol : {1e-3, 1e-5, 1e-7}) {
+            solver.SetTolerance(tol);
+            const Trajectory trajectory = solver.SolveEquation();
+            EXPECT_EQ(SolverStatus::Success, solver.GetResult().status);
+            EXPECT_DOUBLE_EQ(10., trajectory.GetTimes().back());
+            const double error = max_error(trajectory, sol4);
+            EXPECT_LT(error, 1e3*tol) << "order " << s;
+            EXPECT_LT(error, previous_error) << "order " << s;
+            previous_error = error;
+        }
+    }
+    // the stiff problem is solved with few steps
+    const TestProblem &problem = *ProblemLibrary::Find("prothero_robinson");
+    RosenbrockSolver solver(0.1, problem.t0, problem.t1, problem.y0, problem.f, problem.df, 4);
+    solver.SetTolerance(1e-6);
+    EXPECT_LT(max_error(solver.SolveEquation(), problem.solution), 1e-5);
+    EXPECT_LT(solver.GetResult().acceptedSteps + solver.GetResult().rejectedSteps, 100u);
+}
+
+TEST(RosenbrockSolver_test, copy_uses_its_own_controller) {
+    // the default controller is resolved at use time: a copy still works once the original solver is destroyed
+    auto *original = new RosenbrockSolver(0.1, 0., 10., 1., fRhs4, dfRhs4, 4);
+    original->SetTolerance(1e-6);
+    RosenbrockSolver copy(*original);
+    EXPECT_NE(original->GetStepSizeController(), copy.GetStepSizeController());
+    std::stringstream stream_original;
+    original->SolveEquation(stream_original);
+    delete original;
+    std::stringstream stream_copy;
+    copy.SolveEquation(stream_copy);
+    EXPECT_EQ(stream_original.str(), stream_copy.str());
+}
+
+TEST(RosenbrockSolver_test, no_iteration) {
+    // one evaluation of f per new stage, f(y,t) and two for df/dt, the stages of ROS3 sharing an evaluation; one
+    // more for the finite difference Jacobian
+    const unsigned int evaluations[] = {1, 4, 4, 8};
+    const unsigned int stages[] = {1, 2, 3, 6};
+    for (unsigned int s = 1; s <= 4; s++) {
+        RosenbrockSolver solver(0.1, 0., 10., 1., fRhs4, dfRhs4, s);
+        EXPECT_EQ(stages[s-1], solver.GetNumberOfStages());
+        solver.SolveEquation();
+        EXPECT_EQ(evaluations[s-1]*solver.GetNumberOfSteps(), solver.GetResult().rhsEvaluations);
+        RosenbrockSolver solver_fd(0.1, 0., 10., 1., fRhs4, nullptr, s);
+        solver_fd.SolveEquation();
+        EXPECT_EQ((evaluations[s-1] + 1)*solver_fd.GetNumberOfSteps(), solver_fd.GetResult().rhsEvaluations);
+    }
+}
+
+// DELAY DIFFERENTIAL EQUATIONS:
+// y'(t) = -y(t-1) with y = 1 before 0: a polynomial of degree k on [k-1, k], whose derivative of order k jumps at k-1
+double fDelay(double y, double y_delayed, double t) { return -y_delayed; }
+double solDelay(double t) {
+    double y = 0.;
+    double factorial = 1.;
+    for (int k = 0; t - k + 1 > 0; k++) {
+        factorial *= k > 0 ? k : 1;
+        y += std::pow(-1., k)*std::pow(t - k + 1, k)/factorial;
+    }
+    return y;
+}
+// y = sin(t), with a feedback and a delayed feedback: y'(t) = cos(t) + sin(t) - y(t) + sin(t-1) - y(t-1)
+double fDelaySin(double y, double y_delayed, double t) { return cos(t) + sin(t) - y + sin(t - 1) - y_delayed; }
+double solDelaySin(double t) { return sin(t); }
+
+TEST(DelayHistory_test, hermite_and_wraparound) {
+    // the cubic Hermite interpolant is exact for a cubic, and only the last records are kept
+    auto cubic = [](double t) { return t*t*t - 2*t + 1; };
+    DelayHistory history(4);
+    for (int i = 0; i < 10; i++) {
+        history.Push(0.5*i, cubic(0.5*i), 3*0.25*i*i - 2);
+    }
+    EXPECT_EQ(4u, history.Size());
+    EXPECT_EQ(4u, history.GetCapacity());
+    EXPECT_DOUBLE_EQ(3., history.GetOldestTime());
+    EXPECT_DOUBLE_EQ(4.5, history.GetNewestTime());
+    for (double t : {3., 3.1, 3.5, 3.77, 4.2, 4.5}) {
+        EXPECT_NEAR(cubic(t), history.Evaluate(t), 1e-12) << t;
+    }
+    history.Reset(3);
+    EXPECT_EQ(0u, history.Size());
+    EXPECT_EQ(3u, history.GetCapacity());
+}
+
+TEST(DDESolver_test, observed_orders) {
+    // the delayed values are interpolated with an error small enough for each order
+    WorkPrecision work_precision(solDelaySin);
+    for (unsigned int s = 1; s <= 4; s++) {
+        DDESolver solver(0.1, 0., 10., 0., fDelaySin, 1., s);
+        solver.SetHistory(solDelaySin);
+        std::vector<WorkPrecisionPoint> points = work_precision.SweepStepSize(solver,
+                                                                              {1./8, 1./16, 1./32, 1./64, 1./128});
+        EXPECT_NEAR(s, WorkPrecision::ObservedOrder(points), 0.3) << "order " << s;
+    }
+}
+
+TEST(DDESolver_test, breakpoints) {
+    // the breakpoints are points of the grid even if h does not divide the delay, so that the order is kept
+    DDESolver solver(0.3, 0., 5., 1., fDelay, 1., 4);
+    const std::vector<double> breakpoints = solver.GetBreakpoints();
+    EXPECT_EQ(std::vector<double>({1., 2., 3., 4.}), breakpoints);
+    const Trajectory trajectory = solver.SolveEquation();
+    for (double breakpoint : breakpoints) {
+        EXPECT_NE(trajectory.GetTimes().end(),
+                  std::find(trajectory.GetTimes().begin(), trajectory.GetTimes().end(), breakpoint)) << breakpoint;
+    }
+    EXPECT_DOUBLE_EQ(5., trajectory.GetTimes().back());
+    for (size_t i = 1; i < trajectory.Size(); i++) {
+        EXPECT_LE(trajectory.GetTime(i) - trajectory.GetTime(i-1), 0.3 + 1e-12);
+    }
+    WorkPrecision work_precision(solDelay);
+    std::vector<WorkPrecisionPoint> points = work_precision.SweepStepSize(solver, {0.3, 0.15, 0.075, 0.0375, 0.01875});
+    EXPECT_NEAR(4., WorkPrecision::ObservedOrder(points), 0.3);
+    EXPECT_LT(points.back().error, 1e-9);
+    // only the breakpoints before t1 which matter for the order of the method
+    solver.SetOrder(2);
+    EXPECT_EQ(std::vector<double>({1., 2.}), solver.GetBreakpoints());
+    solver.SetTimeInterval(0., 1.5);
+    EXPECT_EQ(std::vector<double>({1.}), solver.GetBreakpoints());
+}
+
+TEST(DDESolver_test, bounded_history) {
+    // the capacity of the history depends on the delay and the step size, not on the length of the integration,
+    // and one evaluation per stage is made, plus the derivative at the end
+    DDESolver solver(0.1, 0., 5., 1., fDelay, 1., 4);
+    solver.SolveEquation();
+    const size_t capacity = solver.GetHistory().GetCapacity();
+    EXPECT_EQ(4*50 + 1, solver.GetResult().rhsEvaluations);
+    solver.SetTimeInterval(0., 500.);
+    solver.SolveEquation();
+    EXPECT_EQ(capacity, solver.GetHistory().GetCapacity());
+    EXPECT_EQ(capacity, solver.GetHistory().Size());
+    EXPECT_LT(capacity, 30u);
+    EXPECT_EQ(4*5000 + 1, solver.GetResult().rhsEvaluations);
+    // steps longer than the delay are shortened to the delay
+    solver.SetStepSize(2.5);
+    solver.SetTimeInterval(0., 5.);
+    const Trajectory trajectory = solver.SolveEquation();
+    EXPECT_EQ(6u, trajectory.Size());
+    EXPECT_NEAR(solDelay(5.), trajectory.GetValues().back(), 1e-2);
+}
+
+TEST(DDESolver_test, copy_uses_its_own_history) {
+    // the delayed values of a copy, or of an assigned solver, are interpolated in its own history: it still works
+    // once the original solver is destroyed
+    auto *original = new DDESolver(0.1, 0., 5., 1., fDelay, 1., 4);
+    const std::vector<double> expected = original->SolveEquation().GetValues();
+    DDESolver copy(*original);
+    DDESolver assigned;
+    assigned = *original;
+    delete original;
+    EXPECT_EQ(expected, copy.SolveEquation().GetValues());
+    EXPECT_EQ(expected, assigned.SolveEquation().GetValues());
+}
+
+// STOCHASTIC DIFFERENTIAL EQUATIONS:
+// geometric Brownian motion dY = 1.5 Y dt + 0.8 Y dW, Y(t) = exp((1.5 - 0.8^2/2) t + 0.8 W(t))
+double fGBM(double y, double t) { return 1.5*y; }
+double gGBM(double y, double t) { return 0.8*y; }
+// Ornstein-Uhlenbeck dY = -2 Y dt + 0.5 dW: additive noise
+double fOU(double y, double t) { return -2*y; }
+double gOU(double y, double t) { return 0.5; }
+
+TEST(Philox_test, known_answers) {
+    // test vectors of the Random123 library
+    uint32_t out[4];
+    const uint32_t zero[4] = {0, 0, 0, 0};
+    Philox4x32(0).Generate(zero, out);
+    EXPECT_EQ(std::vector<uint32_t>({0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}),
+              std::vector<uint32_t>(out, out + 4));
+    const uint32_t ones[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+    Philox4x32(0xffffffffffffffff).Generate(ones, out);
+    EXPECT_EQ(std::vector<uint32_t>({0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}),
+              std::vector<uint32_t>(out, out + 4));
+    const uint32_t pi[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    Philox4x32(0x299f31d0a4093822).Generate(pi, out);
+    EXPECT_EQ(std::vector<uint32_t>({0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}),
+              std::vector<uint32_t>(out, out + 4));
+    EXPECT_GT(Philox4x32::Uniform(0, 0), 0.);
+    EXPECT_LT(Philox4x32::Uniform(0xffffffff, 0xffffffff), 1.);
+}
+
+TEST(SDESolver_test, strong_orders) {
+    // mean error at t = 1 over 200 paths, the exact solution being computed from the same increments
+    const double orders[] = {0.5, 1., 0., 1.5};
+    for (unsigned int s : {1u, 2u, 4u}) {
+        SDESolver solver(0.1, 0., 1., 1., fGBM, gGBM, s);
+        std::vector<WorkPrecisionPoint> points;
+        for (int k = 4; k <= 8; k++) {
+            WorkPrecisionPoint point;
+            point.h = std::ldexp(1., -k);
+            solver.SetStepSize(point.h);
+            for (uint64_t path = 0; path < 200; path++) {
+                solver.SetPath(path);
+                const Trajectory trajectory = solver.SolveEquation();
+                double W = 0., dW, dZ;
+                for (unsigned long i = 0; i < solver.GetNumberOfSteps(); i++) {
+                    solver.Increments(path, i, point.h, dW, dZ);
+                    W += dW;
+                }
+                point.error += std::abs(trajectory.GetValues().back() - std::exp(1.5 - 0.32 + 0.8*W))/200;
+            }
+            points.push_back(point);
+        }
+        EXPECT_NEAR(orders[s-1], WorkPrecision::ObservedOrder(points), 0.2) << "order " << s;
+    }
+}
+
+TEST(SDESolver_test, additive_noise_statistics) {
+    // mean exp(-2t) and variance (1 - exp(-4t))/16 of the Ornstein-Uhlenbeck process at t = 1, within the Monte
+    // Carlo error of 20000 paths, with the order 3/2 methods and steps of 0.1
+    const double mean = std::exp(-2.);
+    const double variance = (1 - std::exp(-4.))/16;
+    for (unsigned int s : {3u, 4u}) {
+        SDESolver solver(0.1, 0., 1., 1., fOU, gOU, s);
+        const std::vector<double> values = solver.SolveEnsemble(20000, 2);
+        double sum = 0., sum_squares = 0.;
+        for (double value : values) {
+            sum += value;
+            sum_squares += value*value;
+        }
+        const double sample_mean = sum/values.size();
+        EXPECT_NEAR(mean, sample_mean, 4*std::sqrt(variance/values.size())) << "order " << s;
+        EXPECT_NEAR(variance, sum_squares/values.size() - sample_mean*sample_mean, 0.05*variance) << "order " << s;
+    }
+}
+
+TEST(SDESolver_test, reproducible_paths) {
+    // a path only depends on the seed and its index, not on the threads nor on the other paths
+    SDESolver solver(0.01, 0., 1., 1., fGBM, gGBM, 4);
+    const std::vector<double> one_thread = solver.SolveEnsemble(100);
+    EXPECT_EQ(2*100*solver.GetNumberOfSteps(), solver.GetResult().rhsEvaluations);
+    EXPECT_TRUE(one_thread == solver.SolveEnsemble(100, 3));
+    const std::vector<double> more_paths = solver.SolveEnsemble(117, 4);
+    EXPECT_TRUE(one_thread == std::vector<double>(more_paths.begin(), more_paths.begin() + 100));
+    for (uint64_t path : {0, 42, 99}) {
+        solver.SetPath(path);
+        EXPECT_EQ(one_thread[path], solver.SolveEquation().GetValues().back());
+    }
+    EXPECT_EQ(2*solver.GetNumberOfSteps(), solver.GetResult().rhsEvaluations);
+    solver.SetSeed(1);
+    EXPECT_NE(one_thread[99], solver.SolveEquation().GetValues().back());
+    EXPECT_NE(one_thread[0], one_thread[1]);
+}
+
+// SECOND ORDER EQUATIONS:
+// y'' = 2 y^3, y(0) = 1, y'(0) = 1: y(t) = 1/(1-t), y'(t) = y(t)^2
+double fCubic(double y, double t) { return 2*y*y*y; }
+// harmonic oscillator y'' = -y, whose energy (y'^2 + y^2)/2 is conserved
+double fOscillator(double y, double t) { return -y; }
+
+TEST(RKNSolver_test, observed_orders) {
+    // maximum error at t = 0.5 on the position and on the velocity
+    for (unsigned int s = 1; s <= 4; s++) {
+        RKNSolver solver(0.1, 0., 0.5, 1., 1., fCubic, s);
+        std::vector<WorkPrecisionPoint> positions, velocities;
+        for (int k = 5; k <= 9; k++) {
+            WorkPrecisionPoint position, velocity;
+            position.h = velocity.h = std::ldexp(1., -k);
+            solver.SetStepSize(position.h);
+            const Trajectory trajectory = solver.SolveEquation();
+            position.error = std::abs(trajectory.GetValues().back() - 2.);
+            velocity.error = std::abs(solver.GetFinalVelocity() - 4.);
+            positions.push_back(position);
+            velocities.push_back(velocity);
+        }
+        EXPECT_NEAR(s, WorkPrecision::ObservedOrder(positions), 0.3) << "order " << s;
+        EXPECT_NEAR(s, WorkPrecision::ObservedOrder(velocities), 0.3) << "order " << s;
+    }
+}
+
+TEST(RKNSolver_test, evaluations_per_step) {
+    // Verlet reuses its last stage, the fourth order method needs 3 evaluations instead of 4
+    const unsigned int evaluations[] = {1, 1, 2, 3};
+    for (unsigned int s = 1; s <= 4; s++) {
+        RKNSolver solver(0.01, 0., 0.5, 1., 1., fCubic, s);
+        solver.SolveEquation();
+        const unsigned long n = solver.GetNumberOfSteps();
+        EXPECT_NEAR(evaluations[s-1]*n, solver.GetResult().rhsEvaluations, 1) << "order " << s;
+    }
+}
+
+TEST(RKNSolver_test, bounded_energy) {
+    // the energy of Verlet oscillates without drift over 1000 periods, and the velocities go to the velocity sink
+    RKNSolver solver(0.1, 0., 2000*M_PI, 1., 0., fOscillator, 2);
+    Trajectory velocities;
+    solver.SetVelocitySink(&velocities);
+    const Trajectory positions = solver.SolveEquation();
+    ASSERT_EQ(positions.Size(), velocities.Size());
+    double max_deviation = 0.;
+    for (unsigned long i = 0; i < positions.Size(); i++) {
+        EXPECT_EQ(positions.GetTime(i), velocities.GetTime(i));
+        const double y = positions.GetValue(i);
+        const double v = velocities.GetValue(i);
+        max_deviation = std::max(max_deviation, std::abs(0.5*(y*y + v*v) - 0.5));
+    }
+    EXPECT_LT(max_deviation, 0.01);
+    EXPECT_EQ(velocities.GetValues().back(), solver.GetFinalVelocity());
+}
+
+// DIFFERENTIAL-ALGEBRAIC EQUATIONS:
+// y' = -y z, 0 = exp(z) - y, y(0) = e: z = log(y), y(t) = exp(exp(-t)), z(t) = exp(-t)
+double fDAE(double y, double z, double t) { return -y*z; }
+double gDAE(double y, double z, double t) { return exp(z) - y; }
+// 0 = z^2 + 1 has no solution
+double gNoSolution(double y, double z, double t) { return z*z + 1; }
+double solDAE(double t) { return exp(exp(-t)); }
+
+TEST(DifferentialAlgebraic_test, consistent_initialization) {
+    // the guess z0 = 0 is not consistent with y0 = e, the algebraic variable is 1
+    AdamsMoultonSolver solver(0.01, 0., 1., exp(1.), nullptr, nullptr, 1);
+    solver.SetAlgebraicEquation(fDAE, gDAE, 0.);
+    EXPECT_TRUE(solver.IsDifferentialAlgebraic());
+    EXPECT_NEAR(1., solver.ConsistentInitialization(), 1e-12);
+    EXPECT_NEAR(0.5, solver.AlgebraicValue(exp(0.5), 0.), 1e-12);
+    // reduced right hand side -y log(y) and its derivative -log(y) - 1
+    EXPECT_NEAR(-2*log(2.), solver.RightHandSide(2., 0.), 1e-12);
+    EXPECT_NEAR(-log(2.) - 1, solver.dRightHandSide(2., 0.), 1e-6);
+    const Trajectory trajectory = solver.SolveEquation();
+    EXPECT_EQ(SolverStatus::Success, solver.GetResult().status);
+    EXPECT_NEAR(solDAE(1.), trajectory.GetValues().back(), 1e-4);
+    EXPECT_NEAR(exp(-1.), solver.AlgebraicValue(trajectory.GetValues().back(), 1.), 1e-4);
+}
+
+TEST(DifferentialAlgebraic_test, observed_orders) {
+    // the Adams Moulton and Rosenbrock methods keep their order on the index-1 equation
+    for (unsigned int s = 1; s <= 4; s++) {
+        AdamsMoultonSolver solver_AM(0.1, 0., 1., exp(1.), nullptr, nullptr, s - 1);
+        RosenbrockSolver solver_ROS(0.1, 0., 1., exp(1.), nullptr, nullptr, s);
+        for (AbstractImplicitSolver *solver : std::vector<AbstractImplicitSolver *>{&solver_AM, &solver_ROS}) {
+            solver->SetAlgebraicEquation(fDAE, gDAE, 0.);
+            std::vector<WorkPrecisionPoint> points;
+            for (int k = 3; k <= 7; k++) {
+                WorkPrecisionPoint point;
+                point.h = std::ldexp(1., -k);
+                solver->SetStepSize(point.h);
+                point.error = std::abs(solver->SolveEquation().GetValues().back() - solDAE(1.));
+                points.push_back(point);
+            }
+            EXPECT_NEAR(s, WorkPrecision::ObservedOrder(points), 0.3) << "order " << s;
+        }
+    }
+}
+
+TEST(DifferentialAlgebraic_test, copy_uses_its_own_algebraic_value) {
+    // the reduced right hand side of a copy, or of an assigned solver, solves g from the algebraic variable of the
+    // copy: it still works once the original solver is destroyed
+    auto *original = new RosenbrockSolver(0.01, 0., 1., exp(1.), nullptr, nullptr, 4);
+    original->SetAlgebraicEquation(fDAE, gDAE, 0.);
+    const std::vector<double> expected = original->SolveEquation().GetValues();
+    RosenbrockSolver copy(*original);
+    RosenbrockSolver assigned;
+    assigned = *original;
+    delete original;
+    EXPECT_EQ(expected, copy.SolveEquation().GetValues());
+    EXPECT_EQ(expected, assigned.SolveEquation().GetValues());
+    EXPECT_NEAR(exp(-1.), copy.AlgebraicValue(expected.back(), 1.), 1e-4);
+}
+
+TEST(DifferentialAlgebraic_test, no_algebraic_solution) {
+    // the Newton method on g fails at each evaluation, which is reported once at the end
+    DiagnosticLog log;
+    RosenbrockSolver solver(0.1, 0., 1., 1., nullptr, nullptr, 1);
+    solver.SetDiagnosticSink(&log);
+    solver.SetAlgebraicEquation(fDAE, gNoSolution, 0.);
+    solver.SolveEquation();
+    EXPECT_EQ(SolverStatus::NewtonNotConverged, solver.GetResult().status);
+    // the failures are evaluations of the right hand side, not steps of the Rosenbrock method
+    EXPECT_GT(solver.GetResult().algebraicFailures, 0u);
+    EXPECT_EQ(0u, solver.GetResult().newtonFailures);
+    ASSERT_EQ(1u, log.Size());
+    EXPECT_EQ("MAX_IT", log.GetDiagnostics()[0].tag);
+    EXPECT_NE(std::string::npos, log.GetDiagnostics()[0].action.find("evaluation(s)"));
+}
+
+TEST(DifferentialAlgebraic_test, right_hand_side_set_again) {
+    // a right hand side set after the algebraic equation is the one of an ODE, also for a copy or an assigned solver
+    DiagnosticLog log;
+    RosenbrockSolver solver(0.01, 0., 1., 1., nullptr, nullptr, 4);
+    solver.SetDiagnosticSink(&log);
+    solver.SetAlgebraicEquation(fDAE, gNoSolution, 0.);
+    solver.SetRightHandSide(fRhs4);
+    EXPECT_FALSE(solver.IsDifferentialAlgebraic());
+    EXPECT_FALSE(solver.HasdRightHandSide());
+    const std::vector<double> values = solver.SolveEquation().GetValues();
+    EXPECT_EQ(SolverStatus::Success, solver.GetResult().status);
+    EXPECT_EQ(0u, log.Size());
+    EXPECT_NEAR(sol4(1.), values.back(), 1e-8);
+    RosenbrockSolver copy(solver);
+    RosenbrockSolver assigned;
+    assigned = solver;
+    for (RosenbrockSolver *other : {&copy, &assigned}) {
+        EXPECT_FALSE(other->IsDifferentialAlgebraic());
+        EXPECT_EQ(values, other->SolveEquation().GetValues());
+        EXPECT_EQ(SolverStatus::Success, other->GetResult().status);
+    }
+    EXPECT_EQ(0u, log.Size());
+}